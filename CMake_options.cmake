@@ -23,9 +23,27 @@ set(SIRIUS_USER_KEY
     CACHE STRING "User-defined key")
 
 set(SIRIUS_LOG_SHM_CAPACITY
-    "512"
+    "4096"
     CACHE STRING "The capatity of the shared memory in the log module")
 
+set(SIRIUS_LOG_SHM_SLOT_SIZE
+    "256"
+    CACHE STRING "The bytes of a slot of the shared memory in the log module")
+
+set(SIRIUS_LOG_SHM_SHARDS
+    "8"
+    CACHE STRING "The number of the rings of the shared memory in the log module")
+
+option(SIRIUS_LOG_SHM_HUGEPAGE
+       "Back the shared memory of the log module with transparent huge pages"
+       OFF)
+
+option(SIRIUS_LOG_SHM_POPULATE
+       "Pre-fault the shared memory of the log module when it is mapped" OFF)
+
+option(SIRIUS_LOG_SHM_NUMA
+       "Prefer the NUMA node of the log daemon for the shared memory" OFF)
+
 set(SIRIUS_LOG_BUF_SIZE
     "4096"
     CACHE
@@ -84,6 +102,9 @@ set(SIRIUS_KIT_LIBRARY_NAME
     "sirius_kit"
     CACHE STRING "The name of the target library `sirius_kit`")
 
+# --- Bench ---
+option(SIRIUS_BENCH_ENABLE "Enable benchmark" OFF)
+
 # --- Test ---
 option(SIRIUS_TEST_ENABLE "Enable test" OFF)
 
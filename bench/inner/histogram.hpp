@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+namespace bench {
+/**
+ * @brief Log-linear latency histogram, in the manner of HdrHistogram.
+ *
+ * @note
+ * - (1) Every power of two is split into `kNbSubBuckets` linear buckets, so
+ *   the relative error of a recorded value is below `1 / kNbSubBuckets`
+ *   (about 3%), from 1 ns up to `UINT64_MAX`.
+ * - (2) Recording is a plain increment, a histogram belongs to one thread,
+ *   and the histograms of the threads and processes are merged afterwards.
+ * - (3) Trivially copyable, so it can be sent through a pipe as is.
+ */
+class Histogram {
+ public:
+  static constexpr uint64_t kSubBits = 5;
+  static constexpr uint64_t kNbSubBuckets = 1ULL << kSubBits;
+  static constexpr uint64_t kNbBuckets = (64 - kSubBits + 1) << kSubBits;
+
+  void record(uint64_t value) {
+    ++counts_[index(value)];
+    ++count_;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  void merge(const Histogram &other) {
+    for (uint64_t i = 0; i < kNbBuckets; ++i) {
+      counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+  }
+
+  /**
+   * @param[in] quantile In `[0, 1]`, e.g., `0.999` for p999.
+   *
+   * @return The highest value equivalent to the bucket of the quantile, or
+   * `0` if nothing is recorded.
+   */
+  uint64_t percentile(double quantile) const {
+    if (count_ == 0)
+      return 0;
+
+    auto rank = static_cast<uint64_t>(quantile * static_cast<double>(count_));
+    rank = std::clamp<uint64_t>(rank, 1, count_);
+    uint64_t seen = 0;
+    for (uint64_t i = 0; i < kNbBuckets; ++i) {
+      seen += counts_[i];
+      if (seen >= rank)
+        return std::min(upper(i), max_);
+    }
+    return max_;
+  }
+
+  uint64_t count() const { return count_; }
+
+  uint64_t min() const { return count_ ? min_ : 0; }
+
+  uint64_t max() const { return max_; }
+
+  double mean() const {
+    return count_ ? static_cast<double>(sum_) / static_cast<double>(count_)
+                  : 0.0;
+  }
+
+ private:
+  std::array<uint64_t, kNbBuckets> counts_ {};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t min_ = std::numeric_limits<uint64_t>::max();
+  uint64_t max_ = 0;
+
+  static uint64_t index(uint64_t value) {
+    if (value < kNbSubBuckets)
+      return value;
+
+    auto shift = static_cast<uint64_t>(std::bit_width(value)) - 1 - kSubBits;
+    return ((shift + 1) << kSubBits) + ((value >> shift) - kNbSubBuckets);
+  }
+
+  static uint64_t upper(uint64_t index) {
+    if (index < kNbSubBuckets)
+      return index;
+
+    uint64_t shift = (index >> kSubBits) - 1;
+    uint64_t lower = ((index & (kNbSubBuckets - 1)) + kNbSubBuckets) << shift;
+    return lower + ((1ULL << shift) - 1);
+  }
+};
+} // namespace bench
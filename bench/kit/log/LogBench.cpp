@@ -0,0 +1,391 @@
+#if defined(_WIN32) || defined(_WIN64)
+#  include <windows.h>
+#else
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <barrier>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sirius/foundation/structor.h>
+#include <sirius/kit/log.h>
+
+#include "inner/histogram.hpp"
+
+/**
+ * @brief Throughput and per-call latency of `ss_log_impl`.
+ *
+ * @details
+ * Usage: LogBench [--mode private|shared|all] [--threads 1,4,16,64]
+ *                 [--processes 1,4,16] [--sizes 16,256,1024,4096]
+ *                 [--count N] [--output PATH]
+ *
+ * Every combination of the lists is a run. The threads of a run call
+ * `ss_log_impl` back to back after a common start, each call is timed on its
+ * own, and the histograms of all the threads and processes are merged.
+ *
+ * @note
+ * - (1) Each run is done in freshly forked processes, so a run neither
+ *   inherits the state of the previous one nor perturbs the next one. On
+ *   Windows, the runs are done in-process, and the multi-process ones are
+ *   skipped.
+ * - (2) The throughput is the producer side: the rate at which the calls
+ *   return, summed over the processes. The write-out done by the daemon in
+ *   the shared mode is not waited for.
+ * - (3) The logs go to `--output`, the null device by default, so that the
+ *   results on `stdout` are not interleaved with them.
+ */
+
+#ifndef _SIRIUS_LOG_MODULE_NAME
+#  define _SIRIUS_LOG_MODULE_NAME "LogBench"
+#endif
+
+namespace {
+#if defined(_WIN32) || defined(_WIN64)
+inline constexpr const char *kNullDevice = "NUL";
+#else
+inline constexpr const char *kNullDevice = "/dev/null";
+#endif
+
+inline constexpr uint64_t kCountDefault = 200000;
+inline constexpr uint64_t kPerThreadMin = 1000;
+inline constexpr uint64_t kWarmup = 1000;
+
+struct Options {
+  std::vector<SsThreadProcess> modes {
+    SsThreadProcess::kSsThreadProcessPrivate,
+    SsThreadProcess::kSsThreadProcessShared,
+  };
+  std::vector<uint64_t> threads {1, 4, 16, 64};
+  std::vector<uint64_t> processes {1, 4, 16};
+  std::vector<uint64_t> sizes {16, 256, 1024, 4096};
+  uint64_t count = kCountDefault;
+  const char *output = kNullDevice;
+};
+
+struct Run {
+  SsThreadProcess mode;
+  uint64_t nb_threads;
+  uint64_t nb_processes;
+  uint64_t size;
+  uint64_t per_thread;
+};
+
+/**
+ * @brief Result of a process, sent to the parent as raw bytes.
+ */
+struct Result {
+  uint64_t nb_msgs;
+  uint64_t elapsed_ns;
+  bench::Histogram hist;
+};
+
+inline uint64_t now_ns() {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch())
+      .count());
+}
+
+inline bool list_parse(std::string_view str, std::vector<uint64_t> &list) {
+  list.clear();
+  while (!str.empty()) {
+    size_t pos = str.find(',');
+    auto item = str.substr(0, pos);
+    uint64_t value = 0;
+    auto [ptr, ec] =
+      std::from_chars(item.data(), item.data() + item.size(), value);
+    if (ec != std::errc() || ptr != item.data() + item.size() || value == 0)
+      return false;
+    list.push_back(value);
+    str = pos == std::string_view::npos ? "" : str.substr(pos + 1);
+  }
+  return !list.empty();
+}
+
+inline bool options_parse(int argc, char **argv, Options &opts) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view key = argv[i];
+    std::string_view value = argv[i + 1];
+    if (key == "--mode") {
+      opts.modes.clear();
+      if (value == "private" || value == "all")
+        opts.modes.push_back(SsThreadProcess::kSsThreadProcessPrivate);
+      if (value == "shared" || value == "all")
+        opts.modes.push_back(SsThreadProcess::kSsThreadProcessShared);
+      if (opts.modes.empty())
+        return false;
+    } else if (key == "--threads") {
+      if (!list_parse(value, opts.threads))
+        return false;
+    } else if (key == "--processes") {
+      if (!list_parse(value, opts.processes))
+        return false;
+    } else if (key == "--sizes") {
+      if (!list_parse(value, opts.sizes))
+        return false;
+    } else if (key == "--count") {
+      std::vector<uint64_t> list;
+      if (!list_parse(value, list) || list.size() != 1)
+        return false;
+      opts.count = list[0];
+    } else if (key == "--output") {
+      opts.output = argv[i + 1];
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1;
+}
+
+inline void log_configure(const Run &run, const Options &opts) {
+#ifdef _BENCH_LOG_EXE_PATH
+  if (getenv(_SIRIUS_ENV_LOG_EXE_PATH) == nullptr) {
+    ss_log_set_exe_path(_BENCH_LOG_EXE_PATH);
+  }
+#endif
+
+  ss_log_config_t cfg {};
+  cfg.out.log_path = opts.output;
+  cfg.out.flags = kSS_O_WRONLY | kSS_O_CREAT | kSS_O_APPEND;
+  cfg.out.mode = SS_FS_PERM_RW;
+  cfg.out.ansi_disable = 1;
+  cfg.out.shared = run.mode;
+  cfg.err = cfg.out;
+  ss_log_configure(&cfg);
+}
+
+/**
+ * @brief Run the threads of a process.
+ */
+inline Result process_run(const Run &run, const Options &opts) {
+  log_configure(run, opts);
+
+  // `size` counts the trailing line feed.
+  const std::string payload(run.size - 1, 'x');
+  for (uint64_t i = 0; i < kWarmup; ++i) {
+    ss_log_impl(SS_LOG_LEVEL_INFO, _SIRIUS_LOG_MODULE_NAME, "LogBench.cpp",
+                __LINE__, "%s\n", payload.c_str());
+  }
+
+  std::vector<bench::Histogram> hists(run.nb_threads);
+  std::barrier sync(static_cast<std::ptrdiff_t>(run.nb_threads + 1));
+  std::vector<std::jthread> threads;
+  threads.reserve(run.nb_threads);
+  for (uint64_t t = 0; t < run.nb_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      auto &hist = hists[t];
+      sync.arrive_and_wait();
+      for (uint64_t i = 0; i < run.per_thread; ++i) {
+        uint64_t t0 = now_ns();
+        ss_log_impl(SS_LOG_LEVEL_INFO, _SIRIUS_LOG_MODULE_NAME, "LogBench.cpp",
+                    __LINE__, "%s\n", payload.c_str());
+        hist.record(now_ns() - t0);
+      }
+      sync.arrive_and_wait();
+    });
+  }
+
+  sync.arrive_and_wait();
+  uint64_t begin = now_ns();
+  sync.arrive_and_wait();
+  uint64_t elapsed = now_ns() - begin;
+  threads.clear();
+
+  Result result {};
+  result.nb_msgs = run.nb_threads * run.per_thread;
+  result.elapsed_ns = elapsed;
+  for (const auto &hist : hists) {
+    result.hist.merge(hist);
+  }
+  return result;
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+inline bool run_execute(const Run &run, const Options &opts, Result &total,
+                        double &rate) {
+  total = process_run(run, opts);
+  if (total.elapsed_ns) {
+    rate = 1e9 * static_cast<double>(total.nb_msgs) /
+      static_cast<double>(total.elapsed_ns);
+  }
+  return true;
+}
+#else
+inline bool fd_read(int fd, void *buf, size_t size) {
+  auto p = static_cast<char *>(buf);
+  while (size > 0) {
+    ssize_t n = read(fd, p, size);
+    if (n <= 0) {
+      if (n == -1 && errno == EINTR)
+        continue;
+      return false;
+    }
+    p += n;
+    size -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+inline bool fd_write(int fd, const void *buf, size_t size) {
+  auto p = static_cast<const char *>(buf);
+  while (size > 0) {
+    ssize_t n = write(fd, p, size);
+    if (n <= 0) {
+      if (n == -1 && errno == EINTR)
+        continue;
+      return false;
+    }
+    p += n;
+    size -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+inline bool run_execute(const Run &run, const Options &opts, Result &total,
+                        double &rate) {
+  std::vector<std::pair<pid_t, int>> children;
+  for (uint64_t i = 0; i < run.nb_processes; ++i) {
+    int fds[2];
+    if (pipe(fds) == -1) {
+      std::perror("pipe");
+      break;
+    }
+    pid_t pid = fork();
+    if (pid == -1) {
+      std::perror("fork");
+      close(fds[0]);
+      close(fds[1]);
+      break;
+    }
+    if (pid == 0) {
+      close(fds[0]);
+      auto result = std::make_unique<Result>(process_run(run, opts));
+      bool ok = fd_write(fds[1], result.get(), sizeof(Result));
+      close(fds[1]);
+      ss_global_destruct();
+      _exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    close(fds[1]);
+    children.emplace_back(pid, fds[0]);
+  }
+
+  bool ok = children.size() == run.nb_processes;
+  auto result = std::make_unique<Result>();
+  for (const auto &[pid, fd] : children) {
+    if (fd_read(fd, result.get(), sizeof(Result))) {
+      total.nb_msgs += result->nb_msgs;
+      total.elapsed_ns = std::max(total.elapsed_ns, result->elapsed_ns);
+      total.hist.merge(result->hist);
+      if (result->elapsed_ns) {
+        rate += 1e9 * static_cast<double>(result->nb_msgs) /
+          static_cast<double>(result->elapsed_ns);
+      }
+    } else {
+      ok = false;
+    }
+    close(fd);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+      ok = false;
+    }
+  }
+  return ok;
+}
+#endif
+
+inline int main_impl(int argc, char **argv) {
+  Options opts {};
+  if (!options_parse(argc, argv, opts)) {
+    std::fprintf(stderr,
+                 "Usage: %s [--mode private|shared|all] [--threads 1,4,16,64] "
+                 "[--processes 1,4,16] [--sizes 16,256,1024,4096] "
+                 "[--count N] [--output PATH]\n",
+                 argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  std::printf("%-8s %8s %6s %6s %10s %12s %10s %8s %8s %8s %8s %10s\n", "mode",
+              "threads", "procs", "size", "msgs", "msgs/s", "MiB/s", "mean",
+              "p50", "p99", "p999", "max");
+  std::fflush(stdout);
+
+  int ret = EXIT_SUCCESS;
+  for (auto mode : opts.modes) {
+    for (auto nb_processes : opts.processes) {
+      for (auto nb_threads : opts.threads) {
+        for (auto size : opts.sizes) {
+          Run run {};
+          run.mode = mode;
+          run.nb_threads = nb_threads;
+          run.nb_processes = nb_processes;
+          run.size = size;
+          run.per_thread =
+            std::max(opts.count / (nb_threads * nb_processes), kPerThreadMin);
+
+          auto total = std::make_unique<Result>();
+          double rate = 0.0;
+          const char *name =
+            mode == SsThreadProcess::kSsThreadProcessShared ? "shared"
+                                                            : "private";
+#if defined(_WIN32) || defined(_WIN64)
+          if (nb_processes != 1) {
+            std::printf("%-8s %8llu %6llu %6llu %10s\n", name,
+                        (unsigned long long)nb_threads,
+                        (unsigned long long)nb_processes,
+                        (unsigned long long)size, "skipped");
+            continue;
+          }
+#endif
+          if (!run_execute(run, opts, *total, rate)) {
+            std::printf("%-8s %8llu %6llu %6llu %10s\n", name,
+                        (unsigned long long)nb_threads,
+                        (unsigned long long)nb_processes,
+                        (unsigned long long)size, "failed");
+            std::fflush(stdout);
+            ret = EXIT_FAILURE;
+            continue;
+          }
+
+          const auto &hist = total->hist;
+          std::printf(
+            "%-8s %8llu %6llu %6llu %10llu %12.0f %10.1f %8.0f %8llu %8llu "
+            "%8llu %10llu\n",
+            name, (unsigned long long)nb_threads,
+            (unsigned long long)nb_processes, (unsigned long long)size,
+            (unsigned long long)total->nb_msgs, rate,
+            rate * static_cast<double>(size) / (1024.0 * 1024.0), hist.mean(),
+            (unsigned long long)hist.percentile(0.50),
+            (unsigned long long)hist.percentile(0.99),
+            (unsigned long long)hist.percentile(0.999),
+            (unsigned long long)hist.max());
+          std::fflush(stdout);
+        }
+      }
+    }
+  }
+
+  std::printf("(latencies in ns per `ss_log_impl` call)\n");
+  return ret;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  int ret = main_impl(argc, argv);
+  ss_global_destruct();
+  return ret;
+}
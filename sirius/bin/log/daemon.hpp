@@ -3,8 +3,13 @@
 #include "utils/decls.h"
 /* clang-format on */
 
+#include <array>
+#include <filesystem>
 #include <functional>
+#include <unordered_map>
 
+#include "utils/log/archive.hpp"
+#include "utils/log/record.hpp"
 #include "utils/log/shm.hpp"
 #include "utils/process/sys.hpp"
 #include "utils/time.hpp"
@@ -21,11 +26,14 @@ class Daemon {
       : should_leave_(u_prcs::sys_init_type() !=
                         u_prcs::SysInitType::kUnreliableInit &&
                       u_prcs::sys_init_type() != u_prcs::SysInitType::kUnknown),
-        log_shm_(u_log::Shm::instance()),
-        fd_out_(STDOUT_FILENO),
-        fd_err_(STDERR_FILENO) {}
+        log_shm_(u_log::Shm::instance()) {}
 
-  ~Daemon() = default;
+  ~Daemon() {
+    for (auto &[pid, sink] : sinks_) {
+      fd_close(sink->out.fd);
+      fd_close(sink->err.fd);
+    }
+  }
 
   auto main() -> std::expected<void, UTrace> {
     try {
@@ -54,23 +62,412 @@ class Daemon {
     return main_ret;
   }
 
-  void log_write(int level, const void *buffer, size_t size) {
-    int fd = level <= SS_LOG_LEVEL_WARN ? fd_err_ : fd_out_;
-    utils_write(fd, buffer, size);
-  }
-
  private:
+  static constexpr uint64_t kRepeatFlushMs = 1000;
+
+  /**
+   * @brief The last message of a destination, for the duplicate suppression.
+   */
+  struct Repeat {
+    u_log::ShmBufDataType type = u_log::ShmBufDataType::kLog;
+    int level = SS_LOG_LEVEL_NONE;
+    int64_t pid = 0;
+    std::string body {};
+    uint64_t nb_repeated = 0;
+    uint64_t timestamp_ms = 0;
+  };
+
+  /**
+   * @brief Output settings of a destination (`stdout` / `stderr`).
+   */
+  struct Destination {
+    int fd = -1;
+    int encoder = SsLogEncoder::kSsLogEncoderHuman;
+    bool ansi_enable = true;
+    bool dedup = false;
+    Repeat repeat {};
+    u_log::archive::Writer archive {};
+  };
+
+  /**
+   * @brief The destinations of the messages of a producer.
+   */
+  struct Sink {
+    Destination out {.fd = STDOUT_FILENO};
+    Destination err {.fd = STDERR_FILENO};
+  };
+
   bool should_leave_;
   u_log::Shm &log_shm_;
   std::unique_ptr<u_log::Shm::Master> master_;
-  int fd_out_;
-  int fd_err_;
+
+  /**
+   * @brief The sinks of the producers which sent a `kConfig`, keyed by pid,
+   * and of the others, consumer only.
+   *
+   * @note A `kConfig` only redirects the messages of its own producer. The
+   * sink of a dead producer is dropped once the consumer is idle.
+   */
+  std::unordered_map<int64_t, std::unique_ptr<Sink>> sinks_ {};
+  Sink sink_default_ {};
+
+  static constexpr uint32_t kMergeSpins = 64;
+  static constexpr uint32_t kPendingSpins = 1000;
+
+  /**
+   * @brief A message reassembled from its slots, consumer only.
+   */
+  struct Message {
+    int64_t pid;
+    uint64_t timestamp_ms;
+    u_log::ShmBuf buffer;
+  };
+  std::unique_ptr<Message> message_ = std::make_unique<Message>();
+
+  /**
+   * @brief The loss notices of `shard_recover`, `thread_monitor` only.
+   */
+  std::unique_ptr<Message> message_forged_ = std::make_unique<Message>();
+  static constexpr size_t kForgedHeadSize =
+    sizeof(u_log::ShmBuf) - u_log::kLogBufferSize;
+  static constexpr size_t kForgedBufMax =
+    u_log::kShmSlotDataSize - kForgedHeadSize;
+
+  /**
+   * @brief The index of a pid in `ShmStats::pids`, consumer only.
+   */
+  std::unordered_map<int64_t, size_t> stats_pids_ {};
+  size_t stats_pid_next_ = 0;
+
+  Sink &sink(int64_t pid) {
+    auto it = sinks_.find(pid);
+    return it != sinks_.end() ? *it->second : sink_default_;
+  }
+
+  Destination &destination(int64_t pid, int level) {
+    Sink &s = sink(pid);
+    return level <= SS_LOG_LEVEL_WARN ? s.err : s.out;
+  }
+
+  template<typename Fn>
+  void sinks_for_each(Fn &&fn) {
+    fn(sink_default_);
+    for (auto &[pid, s] : sinks_) {
+      fn(*s);
+    }
+  }
+
+  void fd_write(int fd, const void *buffer, size_t size) {
+    uint64_t begin_ns = utils::time::get_monotonic_steady_ns();
+    utils_write(fd, buffer, size);
+    stats_write(utils::time::get_monotonic_steady_ns() - begin_ns);
+  }
+
+  static void stats_max(std::atomic<uint64_t> &peak, uint64_t value) {
+    if (value > peak.load(std::memory_order_relaxed)) {
+      peak.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  void stats_write(uint64_t ns) {
+    if (!master_)
+      return;
+    auto &stats = master_->get_shm_header()->stats;
+    stats.nb_writes.fetch_add(1, std::memory_order_relaxed);
+    stats.write_ns_sum.fetch_add(ns, std::memory_order_relaxed);
+    stats_max(stats.write_ns_max, ns);
+  }
+
+  u_log::ShmStatsPid &stats_pid(int64_t pid) {
+    auto &pids = master_->get_shm_header()->stats.pids;
+    if (auto it = stats_pids_.find(pid); it != stats_pids_.end())
+      return pids[it->second];
+
+    /**
+     * @note When the table is full, the oldest pid is evicted.
+     */
+    size_t index = stats_pid_next_++ % u_log::kProcessMax;
+    stats_pids_.erase(pids[index].pid.load(std::memory_order_relaxed));
+    pids[index].nb_bytes.store(0, std::memory_order_relaxed);
+    pids[index].pid.store(pid, std::memory_order_relaxed);
+    stats_pids_.emplace(pid, index);
+    return pids[index];
+  }
+
+  void stats_message(const Message &msg, size_t nb_parts,
+                     uint64_t occupancy) {
+    auto &stats = master_->get_shm_header()->stats;
+    const u_log::ShmBuf &buffer = msg.buffer;
+
+    size_t nb_bytes = 0;
+    if (buffer.type == u_log::ShmBufDataType::kLog) {
+      nb_bytes = buffer.data.log.buf_size;
+    } else if (buffer.type == u_log::ShmBufDataType::kRecord) {
+      nb_bytes = buffer.data.record.buf_size;
+    }
+    nb_bytes = UTILS_MIN(nb_bytes, u_log::kLogBufferSize);
+
+    uint64_t now = utils::time::get_monotonic_steady_ms();
+    uint64_t ts = msg.timestamp_ms;
+    uint64_t latency = now > ts ? now - ts : 0;
+
+    stats.occupancy.store(occupancy, std::memory_order_relaxed);
+    stats_max(stats.occupancy_peak, occupancy);
+    stats.nb_slots.fetch_add(nb_parts, std::memory_order_relaxed);
+    stats.nb_bytes.fetch_add(nb_bytes, std::memory_order_relaxed);
+    stats.latency_ms_sum.fetch_add(latency, std::memory_order_relaxed);
+    stats_max(stats.latency_ms_max, latency);
+    stats.timestamp_ms.store(now, std::memory_order_relaxed);
+    stats_pid(msg.pid)
+      .nb_bytes.fetch_add(nb_bytes, std::memory_order_relaxed);
+  }
+
+  static void fd_close(int &fd) {
+    if (fd > 2) {
+      (void)utils::fs::fs_close_impl(fd);
+      fd = -1;
+    }
+  }
+
+  /**
+   * @brief The log file of a `kConfig`: an absolute path, without `..`, to a
+   * regular file, opened for writing only.
+   *
+   * @return The file descriptor, or -1.
+   */
+  static int fs_open(const u_log::ShmBuf &buffer, int64_t pid) {
+    const auto &data = buffer.data.fs;
+    size_t path_size = utils_strnlen_s(data.path, u_log::kLogPathMax);
+    if (path_size == 0 || path_size >= u_log::kLogPathMax) {
+      logln_error("Invalid log path. PID: {0}", pid);
+      return -1;
+    }
+    std::string path(data.path, path_size);
+    std::filesystem::path fs_path(path);
+    bool parent_ref = false;
+    for (const auto &part : fs_path) {
+      parent_ref = parent_ref || part == "..";
+    }
+    if (!fs_path.is_absolute() || parent_ref) {
+      logln_error("Invalid log path. PID: {0}; Path: {1}", pid, path);
+      return -1;
+    }
+
+    constexpr int kFlagsMask = kSS_O_CREAT | kSS_O_TRUNC | kSS_O_APPEND |
+      kSS_O_EXCL;
+    int fd = utils::fs::fs_open_impl(
+      path.c_str(), (data.flags & kFlagsMask) | kSS_O_WRONLY, data.mode & 0666);
+    if (fd == -1) {
+      const int errno_err = errno;
+      logln_error("{0}", utils::io::Fmt::errno_err(errno_err, "fs_open_impl",
+                                                   "PID: {0}; Path: {1}", pid,
+                                                   path));
+      return -1;
+    }
+#if !defined(_WIN32) && !defined(_WIN64)
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+      logln_error("Not a regular file. PID: {0}; Path: {1}", pid, path);
+      (void)utils::fs::fs_close_impl(fd);
+      return -1;
+    }
+#endif
+    return fd;
+  }
+
+  /**
+   * @note The `buffer.level` selects the destination, @ref
+   * `SharedManager::fs_configure`.
+   */
+  void fs_configure(const Message &msg) {
+    const u_log::ShmBuf &buffer = msg.buffer;
+    const auto &data = buffer.data.fs;
+    bool is_out = buffer.level > SS_LOG_LEVEL_WARN;
+
+    int new_fd = -1;
+    if (data.type == u_log::ShmBufDataFsType::kFile) {
+      new_fd = fs_open(buffer, msg.pid);
+      if (new_fd == -1)
+        return;
+    }
+
+    auto it = sinks_.find(msg.pid);
+    if (it == sinks_.end()) {
+      it = sinks_.emplace(msg.pid, std::make_unique<Sink>()).first;
+    }
+    Destination &dst = is_out ? it->second->out : it->second->err;
+    repeat_flush(dst);
+    archive_flush(dst);
+
+    switch (data.type) {
+    case u_log::ShmBufDataFsType::kStd:
+      fd_close(dst.fd);
+      dst.fd = is_out ? STDOUT_FILENO : STDERR_FILENO;
+      dst.ansi_enable = true;
+      break;
+    case u_log::ShmBufDataFsType::kFile:
+      fd_close(dst.fd);
+      dst.fd = new_fd;
+      dst.ansi_enable = false;
+      break;
+    default:
+      break;
+    }
+
+    if (data.type != u_log::ShmBufDataFsType::kNone && data.ansi_disable) {
+      dst.ansi_enable = false;
+    }
+    dst.encoder = data.encoder;
+    dst.dedup = data.dedup != 0;
+  }
+
+  void record_write(Destination &dst, const u_log::record::View &view) {
+    if (dst.encoder == SsLogEncoder::kSsLogEncoderBinary) {
+      archive_append(dst, view);
+      return;
+    }
+    auto str = u_log::record::encode(dst.encoder, view, dst.ansi_enable);
+    fd_write(dst.fd, str.c_str(), str.size());
+  }
+
+  void archive_append(Destination &dst, const u_log::record::View &view) {
+    if (!dst.archive.append(view)) {
+      archive_flush(dst);
+      (void)dst.archive.append(view);
+    }
+    if (utils::time::get_monotonic_steady_ms() - dst.archive.since_ms() >=
+        u_log::archive::kChunkFlushMs) {
+      archive_flush(dst);
+    }
+  }
+
+  void archive_flush(Destination &dst) {
+    auto chunk = dst.archive.seal();
+    if (!chunk.empty()) {
+      fd_write(dst.fd, chunk.data(), chunk.size());
+    }
+  }
+
+  /**
+   * @return true if the message duplicates the previous one of the
+   * destination, and should be suppressed.
+   *
+   * @note The prefix of a `kLog` (time, thread id) and the timestamp of a
+   * `kRecord` are excluded from the comparison.
+   */
+  bool repeat_check(Destination &dst, const Message &msg,
+                    std::string_view body) {
+    Repeat &rp = dst.repeat;
+    const u_log::ShmBuf &buffer = msg.buffer;
+    const int64_t pid = msg.pid;
+    if (rp.type == buffer.type && rp.level == buffer.level && rp.pid == pid &&
+        rp.body == body) {
+      ++rp.nb_repeated;
+      rp.timestamp_ms = utils::time::get_monotonic_steady_ms();
+      return true;
+    }
+
+    repeat_flush(dst);
+    rp.type = buffer.type;
+    rp.level = buffer.level;
+    rp.pid = pid;
+    rp.body.assign(body);
+    rp.timestamp_ms = utils::time::get_monotonic_steady_ms();
+    return false;
+  }
+
+  void repeat_flush(Destination &dst) {
+    Repeat &rp = dst.repeat;
+    if (rp.nb_repeated == 0)
+      return;
+
+    auto msg = std::format("Last message repeated {0} times", rp.nb_repeated);
+    u_log::record::View view {};
+    view.level = rp.level;
+    view.timestamp_ms = u_log::record::realtime_ms();
+    view.tid = utils::thread::get_tid_impl();
+    view.pid = rp.pid;
+    view.module = _SIRIUS_LOG_MODULE_NAME;
+    view.msg = msg;
+    record_write(dst, view);
+    rp.nb_repeated = 0;
+  }
+
+  void repeat_flush_expired() {
+    uint64_t now = utils::time::get_monotonic_steady_ms();
+    sinks_for_each([&](Sink &s) {
+      for (Destination *dst : {&s.out, &s.err}) {
+        if (dst->repeat.nb_repeated > 0 &&
+            now - dst->repeat.timestamp_ms >= kRepeatFlushMs) {
+          repeat_flush(*dst);
+        }
+        if (!dst->archive.empty() &&
+            now - dst->archive.since_ms() >= u_log::archive::kChunkFlushMs) {
+          archive_flush(*dst);
+        }
+      }
+    });
+  }
+
+  void sinks_prune() {
+    for (auto it = sinks_.begin(); it != sinks_.end();) {
+      if (u_prcs::is_alive(it->first)) {
+        ++it;
+        continue;
+      }
+      for (Destination *dst : {&it->second->out, &it->second->err}) {
+        repeat_flush(*dst);
+        archive_flush(*dst);
+        fd_close(dst->fd);
+      }
+      it = sinks_.erase(it);
+    }
+  }
+
+  void message_write(const Message &msg) {
+    const u_log::ShmBuf &buffer = msg.buffer;
+    Destination &dst = destination(msg.pid, buffer.level);
+
+    if (buffer.type == u_log::ShmBufDataType::kLog) [[likely]] {
+      auto &data = buffer.data.log;
+      size_t buf_size = UTILS_MIN(data.buf_size, u_log::kLogBufferSize);
+      if (dst.dedup) {
+        size_t prefix_size = UTILS_MIN(data.prefix_size, buf_size);
+        std::string_view body(data.buf + prefix_size, buf_size - prefix_size);
+        if (repeat_check(dst, msg, body))
+          return;
+      }
+      if (dst.encoder != SsLogEncoder::kSsLogEncoderHuman) {
+        record_write(dst, u_log::record::log_view(buffer, msg.pid));
+        return;
+      }
+      fd_write(dst.fd, (void *)data.buf, buf_size);
+      return;
+    }
+
+    const int64_t pid = msg.pid;
+    auto view = u_log::record::unpack(buffer, pid);
+    if (!view.has_value()) [[unlikely]] {
+      logln_warnsp("Skip corrupted record. PID: {0}", pid);
+      master_->get_shm_header()->stats.nb_dropped.fetch_add(
+        1, std::memory_order_relaxed);
+      return;
+    }
+    if (dst.dedup) {
+      auto &data = buffer.data.record;
+      std::string_view body(data.buf, data.buf_size);
+      if (repeat_check(dst, msg, body))
+        return;
+    }
+    record_write(dst, view.value());
+  }
 
   class MainStructor {
    public:
     MainStructor(Daemon &parent)
         : parent_(parent), master_(*parent.master_.get()) {
       logln_infosp("Daemon startup (PID: {0})", u_prcs::pid());
+      master_.get_shm_header()->stats.reset();
 
       thread_crash_ =
         std::jthread([this](std::stop_token st) { parent_.thread_crash(st); });
@@ -79,13 +476,11 @@ class Daemon {
       thread_monitor_ = std::jthread(
         [this](std::stop_token st) { parent_.thread_monitor(st); });
 
-      master_.get_shm_header()->is_daemon_ready.store(
-        true, std::memory_order_seq_cst);
+      master_.daemon_ready_store(true);
     }
 
     ~MainStructor() {
-      master_.get_shm_header()->is_daemon_ready.store(
-        false, std::memory_order_seq_cst);
+      master_.daemon_ready_store(false);
 
       thread_monitor_.request_stop();
       thread_consumer_.request_stop();
@@ -160,104 +555,302 @@ class Daemon {
     (void)master_->mutex_crash_unlock();
   }
 
+  /**
+   * @brief Merge the shards by `ShmSlot::timestamp_ns`: consume the oldest of
+   * the ready heads.
+   *
+   * @note A producer thread writes its messages one after another, so its
+   * order survives a migration between the shards, as long as the heads which
+   * are still being written are waited for, @ref `kMergeSpins`.
+   */
   void thread_consumer(std::stop_token stop_token) {
     auto header = master_->get_shm_header();
+    master_->numa_bind();
     uint32_t idle_counter = 0;
+    uint32_t pending_counter = 0;
 
     while (true) {
-      uint64_t index_rd = header->read_index.load(std::memory_order_acquire);
-      uint64_t index_wr;
+      size_t best = u_log::kShmNbShards;
+      size_t best_parts = 0;
+      uint64_t best_ns = 0;
+      uint64_t occupancy = 0;
+      bool pending = false;
+
+      for (size_t i = 0; i < u_log::kShmNbShards; ++i) {
+        auto &shard = header->shards[i];
+        uint64_t index_rd = shard.read_index.load(std::memory_order_acquire);
+        uint64_t index_wr = shard.write_index.load(std::memory_order_acquire);
+        if (index_rd >= index_wr)
+          continue;
+        occupancy += index_wr - index_rd;
+
+        size_t nb_parts = head_parts(i, index_rd);
+        if (nb_parts == 0) {
+          pending = true;
+          continue;
+        }
+        u_log::ShmSlot &slot = head_slot(i, index_rd);
+        if (best == u_log::kShmNbShards || slot.timestamp_ns < best_ns) {
+          best = i;
+          best_parts = nb_parts;
+          best_ns = slot.timestamp_ns;
+        }
+      }
 
-    label_load_write:
-      index_wr = header->write_index.load(std::memory_order_acquire);
-      if (index_rd >= index_wr) {
+      if (best == u_log::kShmNbShards) {
         if (stop_token.stop_requested())
           break;
+
+        /**
+         * @note A claimed head that is not ready is being copied by its
+         * producer, or its producer is dead and the `thread_monitor` will
+         * publish it, then wake this thread up.
+         */
+        if (pending) {
+          if (++pending_counter < kPendingSpins) {
+            std::this_thread::yield();
+          } else {
+            uint32_t wake =
+              header->consumer_wake.load(std::memory_order_acquire);
+            (void)utils::futex::wait_shared(&header->consumer_wake, wake, 10);
+          }
+          continue;
+        }
+
         ++idle_counter;
+        if (idle_counter % 200 == 0) {
+          repeat_flush_expired();
+        }
+        if (idle_counter % 2000 == 0) {
+          sinks_prune();
+        }
         if (idle_counter < 200) {
           std::this_thread::yield();
         } else if (idle_counter < 500) {
           std::this_thread::sleep_for(std::chrono::microseconds(800));
         } else {
-          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+          /**
+           * @note Woken up early by `Shm::Master::consumer_wake`, e.g. the
+           * crash flush of a producer.
+           */
+          uint32_t wake = header->consumer_wake.load(std::memory_order_acquire);
+          if (header->occupancy() == 0) {
+            (void)utils::futex::wait_shared(&header->consumer_wake, wake, 10);
+          }
         }
-        goto label_load_write;
+        continue;
       }
-      idle_counter = 0;
 
-      uint64_t retry_times = u_log::kShmCapacity - (index_wr - index_rd) + 10;
-      if (auto opt_slot = get_slot(index_rd, retry_times); opt_slot) {
-        u_log::ShmSlot &slot = opt_slot->get();
-        u_log::ShmBuf &buffer = slot.buffer;
-        if (buffer.type == u_log::ShmBufDataType::kLog) [[likely]] {
-          auto &data = buffer.data.log;
-          log_write(buffer.level, (void *)data.buf, data.buf_size);
+      if (pending && ++pending_counter < kMergeSpins) {
+        std::this_thread::yield();
+        continue;
+      }
+      idle_counter = 0;
+      pending_counter = 0;
+
+      auto &shard = header->shards[best];
+      uint64_t index = shard.read_index.load(std::memory_order_relaxed);
+      if (message_read(best, index, best_parts)) [[likely]] {
+        stats_message(*message_, best_parts, occupancy);
+        const u_log::ShmBuf &buffer = message_->buffer;
+        if (buffer.type == u_log::ShmBufDataType::kConfig) [[unlikely]] {
+          fs_configure(*message_);
         } else {
-          /* ----------------------------------------- */
-          /* ---------------- Not Yet ---------------- */
-          /* ----------------------------------------- */
+          message_write(*message_);
         }
-        slot.state.store(u_log::ShmSlotState::kFree, std::memory_order_release);
-      } else if (stop_token.stop_requested()) {
-        break;
+      } else {
+        logln_warnsp("Skip corrupted slot. Shard: {0}; Index: {1}", best,
+                     index);
+        header->stats.nb_dropped.fetch_add(1, std::memory_order_relaxed);
       }
-
-      header->read_index.fetch_add(1, std::memory_order_release);
+      for (size_t i = 0; i < best_parts; ++i) {
+        u_log::ShmSlot &slot = head_slot(best, index + i);
+        slot.pid.store(0, std::memory_order_relaxed);
+        slot.sequence.store(index + i + u_log::kShmShardCapacity,
+                            std::memory_order_release);
+      }
+      shard.read_index.store(index + best_parts, std::memory_order_release);
     }
+
+    sinks_for_each([&](Sink &s) {
+      for (Destination *dst : {&s.out, &s.err}) {
+        repeat_flush(*dst);
+        archive_flush(*dst);
+      }
+    });
   }
 
   void thread_monitor(std::stop_token stop_token) {
-    auto slots = master_->get_shm_slots();
-
     while (!stop_token.stop_requested()) {
       std::this_thread::sleep_for(std::chrono::milliseconds(300));
 
-      uint64_t now = utils::time::get_monotonic_steady_ms();
-      for (size_t i = 0; i < u_log::kShmCapacity; ++i) {
-        u_log::ShmSlotState s = slots[i].state.load(std::memory_order_acquire);
-        if (s == u_log::ShmSlotState::kWaiting) {
-          uint64_t ts = slots[i].timestamp_ms.load(std::memory_order_relaxed);
-          if (now - ts > u_log::kShmSlotResetTimeoutMs) {
-            logln_warnsp("Recovering stuck slot: {0}", i);
-
-            /**
-             * @note Construct a forged log indicating data loss.
-             */
-            auto es = log_warnsp_str("Slot recovered/skipped due to timeout");
-            slots[i].buffer.type = u_log::ShmBufDataType::kLog;
-            slots[i].buffer.level = SS_LOG_LEVEL_ERROR;
-            auto &log = slots[i].buffer.data.log;
-            log.buf_size = es.size();
-            std::memcpy(log.buf, es.c_str(), log.buf_size + 1);
-
-            /**
-             * @note Let it be `kReady`, so that consumers can read it, thereby
-             * advancing the index.
-             */
-            slots[i].state.store(u_log::ShmSlotState::kReady,
-                                 std::memory_order_release);
-          }
-        }
+      bool recovered = false;
+      for (size_t i = 0; i < u_log::kShmNbShards; ++i) {
+        recovered = shard_recover(i) || recovered;
+      }
+      if (recovered) {
+        master_->consumer_wake();
       }
     }
   }
 
-  [[nodiscard]] std::optional<std::reference_wrapper<u_log::ShmSlot>>
-  get_slot(const uint64_t read_index, const int retry_times) {
-    size_t slot_idx = read_index & (u_log::kShmCapacity - 1);
-    u_log::ShmSlot &slot = master_->get_shm_slots()[slot_idx];
-
-    int retries = 0;
-    while (slot.state.load(std::memory_order_acquire) !=
-           u_log::ShmSlotState::kReady) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
-      if (++retries > retry_times) {
-        logln_warnsp("Skip corrupted slot index: {0}", read_index);
-        return std::nullopt;
+  u_log::ShmSlot &head_slot(size_t shard, uint64_t read_index) {
+    return master_->get_shard_slots(
+      shard)[read_index & (u_log::kShmShardCapacity - 1)];
+  }
+
+  /**
+   * @return true if the slot is the first part of a consistent message.
+   */
+  static bool parts_valid(const u_log::ShmSlot &slot) {
+    return slot.part == 0 && slot.nb_parts >= 1 &&
+      slot.nb_parts <= u_log::kShmSlotPartsMax && slot.size > 0 &&
+      slot.size <= sizeof(u_log::ShmBuf) &&
+      (slot.size + u_log::kShmSlotDataSize - 1) / u_log::kShmSlotDataSize ==
+      slot.nb_parts;
+  }
+
+  /**
+   * @return The number of slots of the message at the head of a shard, `0` if
+   * it is not ready yet.
+   *
+   * @note A head which is not the first part of a consistent message, e.g. an
+   * orphan part, is taken as a message of one slot, and dropped.
+   */
+  size_t head_parts(size_t shard, uint64_t read_index) {
+    u_log::ShmSlot &slot = head_slot(shard, read_index);
+    if (slot.sequence.load(std::memory_order_acquire) != read_index + 1)
+      return 0;
+    if (!parts_valid(slot))
+      return 1;
+
+    for (size_t i = 1; i < slot.nb_parts; ++i) {
+      if (head_slot(shard, read_index + i)
+            .sequence.load(std::memory_order_acquire) != read_index + i + 1) {
+        return 0;
       }
     }
+    return slot.nb_parts;
+  }
+
+  /**
+   * @brief Reassemble the message at the head of a shard into `message_`.
+   *
+   * @return false if the message is corrupted.
+   */
+  bool message_read(size_t shard, uint64_t read_index, size_t nb_parts) {
+    const u_log::ShmSlot &head = head_slot(shard, read_index);
+    if (!parts_valid(head) || head.nb_parts != nb_parts) [[unlikely]]
+      return false;
+
+    auto dst = reinterpret_cast<char *>(&message_->buffer);
+    for (size_t i = 0; i < nb_parts; ++i) {
+      size_t offset = i * u_log::kShmSlotDataSize;
+      std::memcpy(dst + offset, head_slot(shard, read_index + i).data,
+                  UTILS_MIN(u_log::kShmSlotDataSize, head.size - offset));
+    }
+    message_->pid = head.pid.load(std::memory_order_relaxed);
+    message_->timestamp_ms = head.timestamp_ms.load(std::memory_order_relaxed);
+    return true;
+  }
+
+  /**
+   * @brief Publish the claimed slots of a shard whose producers are dead, as
+   * forged logs indicating the loss, and free the slots they reserved.
+   *
+   * @return true if any slot is recovered.
+   *
+   * @note
+   * - (1) A slot is reserved with the `pid` of its producer before it is
+   * claimed, so the liveness of that `pid` is all that is checked: a slot
+   * claimed by a live process is never taken over, however long it is being
+   * written.
+   *
+   * - (2) A dead producer always loses the race against this thread, its
+   * publish is a CAS, @ref `SharedManager::produce_shared`.
+   */
+  bool shard_recover(size_t shard) {
+    auto header = master_->get_shm_header();
+    uint64_t index_rd =
+      header->shards[shard].read_index.load(std::memory_order_acquire);
+    uint64_t index_wr =
+      header->shards[shard].write_index.load(std::memory_order_acquire);
+    bool recovered = false;
+
+    for (uint64_t pos = index_rd; pos < index_wr; ++pos) {
+      u_log::ShmSlot &slot = head_slot(shard, pos);
+      if (slot.sequence.load(std::memory_order_acquire) != pos)
+        continue;
+
+      int64_t pid = slot.pid.load(std::memory_order_acquire);
+      if (pid == 0 || u_prcs::is_alive(pid))
+        continue;
+
+      logln_warnsp("Recovering stuck slot. Shard: {0}; Index: {1}; PID: {2}",
+                   shard, pos, pid);
+      header->stats.nb_recovered.fetch_add(1, std::memory_order_relaxed);
+
+      /**
+       * @note Construct a forged log indicating data loss.
+       */
+      auto es = log_warnsp_str("Slot recovered/skipped due to a dead producer");
+      auto &forged = message_forged_->buffer;
+      forged.type = u_log::ShmBufDataType::kLog;
+      forged.level = SS_LOG_LEVEL_ERROR;
+      auto &log = forged.data.log;
+      log.timestamp_ms = u_log::record::realtime_ms();
+      log.tid = 0;
+      log.module_size = 0;
+      log.prefix_size = 0;
+      log.buf_size = UTILS_MIN(es.size(), kForgedBufMax);
+      std::memcpy(log.buf, es.c_str(), log.buf_size);
+      slot.part = 0;
+      slot.nb_parts = 1;
+      slot.size = kForgedHeadSize + log.buf_size;
+      std::memcpy(slot.data, &forged, slot.size);
+
+      slot.timestamp_ns =
+        slot.timestamp_ms.load(std::memory_order_relaxed) * 1000 * 1000;
+
+      uint64_t seq = pos;
+      recovered = slot.sequence.compare_exchange_strong(
+                    seq, pos + 1, std::memory_order_acq_rel) ||
+        recovered;
+    }
+
+    shard_unreserve(shard);
+    return recovered;
+  }
 
-    return slot;
+  /**
+   * @brief Free the slots of a shard that dead producers reserved, but never
+   * claimed.
+   *
+   * @note A free slot holds the position it is free for in its `sequence`,
+   * and is claimed once the `write_index` is past that position. A dead
+   * producer claims nothing anymore, and no one else can claim a slot it
+   * reserved, so the check holds until the `pid` is reset.
+   */
+  void shard_unreserve(size_t shard) {
+    auto &shard_header = master_->get_shm_header()->shards[shard];
+    u_log::ShmSlot *slots = master_->get_shard_slots(shard);
+
+    for (size_t i = 0; i < u_log::kShmShardCapacity; ++i) {
+      u_log::ShmSlot &slot = slots[i];
+      int64_t pid = slot.pid.load(std::memory_order_acquire);
+      if (pid == 0 || u_prcs::is_alive(pid))
+        continue;
+
+      uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+      if ((seq & (u_log::kShmShardCapacity - 1)) != i ||
+          seq < shard_header.write_index.load(std::memory_order_acquire)) {
+        continue;
+      }
+      logln_warnsp("Releasing reserved slot. Shard: {0}; Index: {1}; PID: {2}",
+                   shard, seq, pid);
+      (void)slot.pid.compare_exchange_strong(pid, 0,
+                                             std::memory_order_acq_rel);
+    }
   }
 };
 } // namespace log
@@ -4,6 +4,8 @@
 /* clang-format on */
 
 #include "bin/log/daemon.hpp"
+#include "bin/log/query.hpp"
+#include "bin/log/stats.hpp"
 #include "sirius/foundation/structor.h"
 #include "sirius/version.h"
 #include "utils/log/exe.hpp"
@@ -30,6 +32,22 @@ class Parser {
     return {};
   }
 
+  auto arg_stats() -> std::expected<void, UTrace> {
+    auto stats = std::make_unique<Stats>();
+    return stats->main().utrace_transform_error_default();
+  }
+
+  auto arg_query() -> std::expected<void, UTrace> {
+    auto query = std::make_unique<Query>(exe_args_.parser);
+    return query->main().utrace_transform_error_default();
+  }
+
+  /**
+   * @brief The options that only modify another command, e.g. the filters of
+   * the `--query`.
+   */
+  auto arg_modifier() -> std::expected<void, UTrace> { return {}; }
+
   auto arg_version() -> std::expected<void, UTrace> {
     auto msg = std::format("`{0}` version: {1}", _SIRIUS_LOG_MODULE_NAME,
                            SIRIUS_VERSION);
@@ -77,6 +95,17 @@ class Main {
             auto fn_arg = [&]() -> std::expected<void, UTrace> (Parser::*)() {
               if (option == u_log::exe::Args::kArgDaemon) {
                 return &Parser::arg_daemon;
+              } else if (option == u_log::exe::Args::kArgStats) {
+                return &Parser::arg_stats;
+              } else if (option == u_log::exe::Args::kArgQuery) {
+                return &Parser::arg_query;
+              } else if (option == u_log::exe::Args::kArgQuerySince ||
+                         option == u_log::exe::Args::kArgQueryUntil ||
+                         option == u_log::exe::Args::kArgQueryLevel ||
+                         option == u_log::exe::Args::kArgQueryPid ||
+                         option == u_log::exe::Args::kArgQueryModule ||
+                         option == u_log::exe::Args::kArgQueryFormat) {
+                return &Parser::arg_modifier;
               } else if (option == u_log::exe::Args::kArgVersion) {
                 return &Parser::arg_version;
               } else {
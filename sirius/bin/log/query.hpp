@@ -0,0 +1,246 @@
+#pragma once
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#  include <sys/mman.h>
+#endif
+
+#include <charconv>
+
+#include "utils/args.hpp"
+#include "utils/log/archive.hpp"
+#include "utils/log/exe.hpp"
+
+namespace sirius {
+namespace bin {
+namespace log {
+namespace u_log = utils::log;
+
+/**
+ * @brief Reader of the binary log archives, the `--query` command.
+ *
+ * @note The archive is memory-mapped, and the chunks ruled out by their
+ * headers are skipped without touching their records.
+ */
+class Query {
+ public:
+  Query(utils::args::Parser &parser) : parser_(parser) {}
+
+  ~Query() { unmap(); }
+
+  auto main() -> std::expected<void, UTrace> {
+    using Args = u_log::exe::Args;
+
+    u_log::archive::Filter filter {};
+    int encoder = SsLogEncoder::kSsLogEncoderHuman;
+    if (auto ret = filter_parse(filter, encoder); !ret.has_value())
+      utrace_return(ret);
+    if (auto ret = map(parser_.get(Args::kArgQuery)); !ret.has_value())
+      utrace_return(ret);
+
+    std::string out;
+    out.reserve(kOutBatchSize + u_log::kLogBufferSize);
+    auto result = u_log::archive::scan(
+      std::string_view(data_, size_), filter,
+      [&](const u_log::record::View &view) {
+        out.append(u_log::record::encode(encoder, view, false));
+        if (out.size() >= kOutBatchSize) {
+          utils::io::print_out(out);
+          out.clear();
+        }
+      });
+    if (!out.empty()) {
+      utils::io::print_out(out);
+    }
+
+    utils::io::println_err(
+      std::format("Chunks: {0} (skipped by the index: {1}); Records: {2}; "
+                  "Corrupted: {3}",
+                  result.nb_chunks, result.nb_chunks_skipped,
+                  result.nb_records, result.nb_corrupted));
+    return {};
+  }
+
+ private:
+  static constexpr size_t kOutBatchSize = 64 * 1024;
+
+  utils::args::Parser &parser_;
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+#if defined(_WIN32) || defined(_WIN64)
+  HANDLE file_handle_ = INVALID_HANDLE_VALUE;
+  HANDLE map_handle_ = nullptr;
+#endif
+
+  /**
+   * @brief Epoch milliseconds, or RFC 3339 in UTC.
+   */
+  static auto time_parse(const std::string &str)
+    -> std::expected<uint64_t, UTrace> {
+    uint64_t ms = 0;
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), ms);
+    if (ec == std::errc() && ptr == str.data() + str.size())
+      return ms;
+
+    int y = 0, mo = 0, d = 0, h = 0, mi = 0, s = 0, frac = 0;
+    int n = std::sscanf(str.c_str(), "%4d-%2d-%2dT%2d:%2d:%2d.%3d", &y, &mo, &d,
+                        &h, &mi, &s, &frac);
+    if (n < 6) {
+      auto es = std::format("Invalid argument. `time`: {0}", str);
+      return std::unexpected(UTrace(std::move(es)));
+    }
+    auto days = std::chrono::sys_days(std::chrono::year(y) /
+                                      std::chrono::month(mo) /
+                                      std::chrono::day(d));
+    auto tp = days + std::chrono::hours(h) + std::chrono::minutes(mi) +
+      std::chrono::seconds(s) + std::chrono::milliseconds(n > 6 ? frac : 0);
+    return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+        tp.time_since_epoch())
+        .count());
+  }
+
+  auto filter_parse(u_log::archive::Filter &filter, int &encoder)
+    -> std::expected<void, UTrace> {
+    using Args = u_log::exe::Args;
+
+    if (parser_.has(Args::kArgQuerySince)) {
+      auto ret = time_parse(parser_.get(Args::kArgQuerySince));
+      if (!ret.has_value())
+        utrace_return(ret);
+      filter.since_ms = ret.value();
+    }
+    if (parser_.has(Args::kArgQueryUntil)) {
+      auto ret = time_parse(parser_.get(Args::kArgQueryUntil));
+      if (!ret.has_value())
+        utrace_return(ret);
+      filter.until_ms = ret.value();
+    }
+
+    std::string level = parser_.get(Args::kArgQueryLevel);
+    if (level == "error") {
+      filter.level = SS_LOG_LEVEL_ERROR;
+    } else if (level == "warn") {
+      filter.level = SS_LOG_LEVEL_WARN;
+    } else if (level == "info") {
+      filter.level = SS_LOG_LEVEL_INFO;
+    } else if (level == "debug") {
+      filter.level = SS_LOG_LEVEL_DEBUG;
+    }
+
+    for (const auto &str : parser_.get_all(Args::kArgQueryPid)) {
+      int64_t pid = 0;
+      auto [ptr, ec] =
+        std::from_chars(str.data(), str.data() + str.size(), pid);
+      if (ec != std::errc() || ptr != str.data() + str.size()) {
+        auto es = std::format("Invalid argument. `pid`: {0}", str);
+        return std::unexpected(UTrace(std::move(es)));
+      }
+      filter.pids.push_back(pid);
+    }
+    filter.modules = parser_.get_all(Args::kArgQueryModule);
+
+    std::string format = parser_.get(Args::kArgQueryFormat);
+    if (format == "json") {
+      encoder = SsLogEncoder::kSsLogEncoderJson;
+    } else if (format == "logfmt") {
+      encoder = SsLogEncoder::kSsLogEncoderLogfmt;
+    }
+    return {};
+  }
+
+#if defined(_WIN32) || defined(_WIN64)
+  auto map(const std::string &path) -> std::expected<void, UTrace> {
+    file_handle_ = CreateFileA(path.c_str(), GENERIC_READ,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle_ == INVALID_HANDLE_VALUE) {
+      const DWORD dw_err = GetLastError();
+      return std::unexpected(
+        UTrace(utils::io::Fmt::win_err(dw_err, "CreateFileA", "{0}", path)));
+    }
+    LARGE_INTEGER size {};
+    if (!GetFileSizeEx(file_handle_, &size)) {
+      const DWORD dw_err = GetLastError();
+      return std::unexpected(
+        UTrace(utils::io::Fmt::win_err(dw_err, "GetFileSizeEx", "{0}", path)));
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_ == 0)
+      return {};
+
+    map_handle_ =
+      CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!map_handle_) {
+      const DWORD dw_err = GetLastError();
+      return std::unexpected(UTrace(
+        utils::io::Fmt::win_err(dw_err, "CreateFileMappingA", "{0}", path)));
+    }
+    data_ = static_cast<const char *>(
+      MapViewOfFile(map_handle_, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+      const DWORD dw_err = GetLastError();
+      return std::unexpected(
+        UTrace(utils::io::Fmt::win_err(dw_err, "MapViewOfFile", "{0}", path)));
+    }
+    return {};
+  }
+
+  void unmap() {
+    if (data_) {
+      UnmapViewOfFile(data_);
+      data_ = nullptr;
+    }
+    if (map_handle_) {
+      CloseHandle(map_handle_);
+      map_handle_ = nullptr;
+    }
+    if (file_handle_ != INVALID_HANDLE_VALUE) {
+      CloseHandle(file_handle_);
+      file_handle_ = INVALID_HANDLE_VALUE;
+    }
+  }
+#else
+  auto map(const std::string &path) -> std::expected<void, UTrace> {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+      const int errno_err = errno;
+      return std::unexpected(
+        UTrace(utils::io::Fmt::errno_err(errno_err, "open", "{0}", path)));
+    }
+    UTILS_DEFER(close(fd));
+
+    struct stat st {};
+    if (fstat(fd, &st) == -1) {
+      const int errno_err = errno;
+      return std::unexpected(
+        UTrace(utils::io::Fmt::errno_err(errno_err, "fstat", "{0}", path)));
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0)
+      return {};
+
+    void *ptr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED) {
+      const int errno_err = errno;
+      size_ = 0;
+      return std::unexpected(
+        UTrace(utils::io::Fmt::errno_err(errno_err, "mmap", "{0}", path)));
+    }
+    data_ = static_cast<const char *>(ptr);
+    return {};
+  }
+
+  void unmap() {
+    if (data_) {
+      (void)munmap(const_cast<char *>(data_), size_);
+      data_ = nullptr;
+    }
+  }
+#endif
+};
+} // namespace log
+} // namespace bin
+} // namespace sirius
@@ -0,0 +1,159 @@
+#pragma once
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include <thread>
+
+#include "utils/log/shm.hpp"
+#include "utils/time.hpp"
+
+namespace sirius {
+namespace bin {
+namespace log {
+namespace u_log = utils::log;
+
+/**
+ * @brief Reader of `ShmStats`, the `--stats` command.
+ *
+ * @note It maps the shared memory without attaching a slot, so the daemon
+ * neither counts nor waits for it.
+ */
+class Stats {
+ public:
+  Stats() : log_shm_(u_log::Shm::instance()) {}
+
+  ~Stats() = default;
+
+  auto main() -> std::expected<void, UTrace> {
+    try {
+      {
+        auto lock = u_log::GMutex::instance().lock_guard();
+        auto ret = log_shm_.shm_alloc(u_log::MasterType::kNative);
+        if (!ret.has_value())
+          utrace_return(ret);
+        master_ = std::move(ret.value());
+      }
+
+      auto ret = print().utrace_transform_error_default();
+
+      auto lock = u_log::GMutex::instance().lock_guard();
+      master_.reset();
+      log_shm_.shm_free();
+      return ret;
+    } catch (const std::exception &e) {
+      return std::unexpected(UTrace(std::move(e.what())));
+    }
+  }
+
+ private:
+  static constexpr uint64_t kSampleMs = 1000;
+
+  /**
+   * @brief A plain copy of `ShmStats`.
+   */
+  struct Sample {
+    uint64_t producer_spins;
+    uint64_t producer_stalls;
+    uint64_t occupancy;
+    uint64_t occupancy_peak;
+    uint64_t nb_slots;
+    uint64_t nb_bytes;
+    uint64_t nb_dropped;
+    uint64_t nb_recovered;
+    uint64_t latency_ms_sum;
+    uint64_t latency_ms_max;
+    uint64_t nb_writes;
+    uint64_t write_ns_sum;
+    uint64_t write_ns_max;
+    std::vector<std::pair<int64_t, uint64_t>> pids;
+  };
+
+  u_log::Shm &log_shm_;
+  std::unique_ptr<u_log::Shm::Master> master_;
+
+  static Sample sample(const u_log::ShmStats &stats) {
+    constexpr auto kOrder = std::memory_order_relaxed;
+    Sample s {};
+    s.producer_spins = stats.producer_spins.load(kOrder);
+    s.producer_stalls = stats.producer_stalls.load(kOrder);
+    s.occupancy = stats.occupancy.load(kOrder);
+    s.occupancy_peak = stats.occupancy_peak.load(kOrder);
+    s.nb_slots = stats.nb_slots.load(kOrder);
+    s.nb_bytes = stats.nb_bytes.load(kOrder);
+    s.nb_dropped = stats.nb_dropped.load(kOrder);
+    s.nb_recovered = stats.nb_recovered.load(kOrder);
+    s.latency_ms_sum = stats.latency_ms_sum.load(kOrder);
+    s.latency_ms_max = stats.latency_ms_max.load(kOrder);
+    s.nb_writes = stats.nb_writes.load(kOrder);
+    s.write_ns_sum = stats.write_ns_sum.load(kOrder);
+    s.write_ns_max = stats.write_ns_max.load(kOrder);
+    for (const auto &p : stats.pids) {
+      int64_t pid = p.pid.load(kOrder);
+      if (pid != 0) {
+        s.pids.emplace_back(pid, p.nb_bytes.load(kOrder));
+      }
+    }
+    return s;
+  }
+
+  static double ratio(uint64_t num, uint64_t den) {
+    return den ? static_cast<double>(num) / static_cast<double>(den) : 0.0;
+  }
+
+  auto print() -> std::expected<void, UTrace> {
+    auto header = master_->get_shm_header();
+    if (header->magic != u_log::ShmHeader::kMagicHeader ||
+        !header->is_daemon_ready.load(std::memory_order_relaxed)) {
+      return std::unexpected(UTrace("No daemon was found"));
+    }
+
+    auto s0 = sample(header->stats);
+    std::this_thread::sleep_for(std::chrono::milliseconds(kSampleMs));
+    auto s1 = sample(header->stats);
+    const double secs = static_cast<double>(kSampleMs) / 1000.0;
+
+    std::string out;
+    uint64_t occupancy = header->occupancy();
+    double peak = 100.0 * ratio(s1.occupancy_peak, u_log::kShmCapacity);
+    out.append(std::format("Ring capacity: {0} ({1} shards)\n",
+                           u_log::kShmCapacity, u_log::kShmNbShards))
+      .append(std::format("Occupancy: {0} (peak: {1}, {2:.1f}%)\n", occupancy,
+                          s1.occupancy_peak, peak))
+      .append(std::format("Slots: {0} ({1:.1f}/s)\n", s1.nb_slots,
+                          (s1.nb_slots - s0.nb_slots) / secs))
+      .append(std::format("Bytes: {0} ({1:.1f}/s)\n", s1.nb_bytes,
+                          (s1.nb_bytes - s0.nb_bytes) / secs))
+      .append(std::format("Dropped: {0}, recovered: {1}\n", s1.nb_dropped,
+                          s1.nb_recovered))
+      .append(std::format("Latency (enqueue to write): avg {0:.3f} ms, "
+                          "max {1} ms\n",
+                          ratio(s1.latency_ms_sum, s1.nb_slots),
+                          s1.latency_ms_max))
+      .append(std::format("Write: {0} calls, avg {1:.3f} us, max {2:.3f} us\n",
+                          s1.nb_writes,
+                          ratio(s1.write_ns_sum, s1.nb_writes) / 1000.0,
+                          static_cast<double>(s1.write_ns_max) / 1000.0))
+      .append(std::format("Producer spins: {0} (stalls: {1})\n",
+                          s1.producer_spins, s1.producer_stalls));
+
+    for (const auto &[pid, nb_bytes] : s1.pids) {
+      uint64_t prev = 0;
+      for (const auto &[pid0, nb_bytes0] : s0.pids) {
+        if (pid0 == pid) {
+          prev = nb_bytes0 <= nb_bytes ? nb_bytes0 : 0;
+          break;
+        }
+      }
+      out.append(std::format("PID {0}: {1} bytes ({2:.1f}/s)\n", pid, nb_bytes,
+                             (nb_bytes - prev) / secs));
+    }
+
+    out.pop_back();
+    utils::io::println_out(out);
+    return {};
+  }
+};
+} // namespace log
+} // namespace bin
+} // namespace sirius
@@ -8,6 +8,19 @@
  */
 #define _SIRIUS_ENV_LOG_EXE_PATH "SIRIUS_ENV_LOG_EXE_PATH"
 
+// --- _SIRIUS_ENV_LOG_LEVEL ---
+#undef _SIRIUS_ENV_LOG_LEVEL
+
+/**
+ * @brief The initial runtime log levels, a comma-separated list of `level` (the
+ * default level) and `module=level`. The level is a number (0 - 4) or a name
+ * (`none`, `error`, `warn`, `info`, `debug`).
+ *
+ * @example
+ * - (1) SIRIUS_ENV_LOG_LEVEL="warn,net=debug"
+ */
+#define _SIRIUS_ENV_LOG_LEVEL "SIRIUS_ENV_LOG_LEVEL"
+
 /**
  * @brief Custom log module name.
  *
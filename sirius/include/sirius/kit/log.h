@@ -17,9 +17,51 @@
 #undef SS_LOG_LEVEL_DEBUG
 #define SS_LOG_LEVEL_DEBUG (4)
 
+/**
+ * @brief Output encoder of the printf-style logs and of the structured
+ * records (`ss_log_kv`).
+ *
+ * @note Encoded as a record, a printf-style log has its message in `msg`, and
+ * no `file` nor `line`.
+ */
+enum SsLogEncoder {
+  /**
+   * @brief The same layout as the printf-style logs, with the key-value pairs
+   * appended as `key=value`.
+   */
+  kSsLogEncoderHuman = 0,
+  /**
+   * @brief One JSON object per line.
+   */
+  kSsLogEncoderJson = 1,
+  /**
+   * @brief One logfmt line per record.
+   */
+  kSsLogEncoderLogfmt = 2,
+  /**
+   * @brief Compact binary archive, in chunks with a sparse index, read back
+   * by `sirius_log --query`. Both the printf-style logs and the structured
+   * records are archived.
+   *
+   * @note Only applies to `SsThreadProcess::kSsThreadProcessShared`, it falls
+   * back to `kSsLogEncoderHuman` otherwise. The daemon buffers up to a chunk
+   * (64 KiB or 1 s) before writing it.
+   */
+  kSsLogEncoderBinary = 3,
+};
+
+typedef struct {
+  const char *key;
+  const char *value;
+} ss_log_kv_t;
+
 typedef struct {
   /**
    * @note Set to default `stdout` / `stderr` when `nullptr`.
+   *
+   * With `SsThreadProcess::kSsThreadProcessShared`, it is resolved to an
+   * absolute path, and the daemon opens it, as a regular file, for the
+   * messages of this process only.
    */
   const char *log_path;
 
@@ -35,6 +77,20 @@ typedef struct {
    * @note Default: `SsThreadProcess::kSsThreadProcessShared`.
    */
   enum SsThreadProcess shared;
+
+  /**
+   * @note Default: `SsLogEncoder::kSsLogEncoderHuman`.
+   */
+  enum SsLogEncoder encoder;
+
+  /**
+   * @brief Suppress the consecutive duplicate messages of a process, and
+   * write "Last message repeated N times" instead.
+   *
+   * @note Only applies to `SsThreadProcess::kSsThreadProcessShared`, the
+   * suppression is done by the daemon.
+   */
+  int dedup;
 } ss_log_fs_t;
 
 typedef struct {
@@ -42,6 +98,30 @@ typedef struct {
   ss_log_fs_t err;
 } ss_log_config_t;
 
+/**
+ * @brief State of a rate-limited log call site.
+ *
+ * @note Used by the `ss_log_*_ratelimited` macros, one per call site.
+ */
+typedef struct {
+  ss_alignas(8) uint64_t begin_ms;
+  uint32_t count;
+  uint32_t missed;
+} ss_log_ratelimit_t;
+
+#define SS_LOG_RATELIMIT_INITIALIZER {0, 0, 0}
+
+/**
+ * @brief State of a sampled log call site.
+ *
+ * @note Used by the `ss_log_*_every` macros, one per call site.
+ */
+typedef struct {
+  ss_alignas(8) uint64_t count;
+} ss_log_sample_t;
+
+#define SS_LOG_SAMPLE_INITIALIZER {0}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -51,15 +131,236 @@ extern "C" {
  */
 SIRIUS_API int ss_log_set_exe_path(const char *path);
 SIRIUS_API void ss_log_configure(const ss_log_config_t *cfg);
+
+/**
+ * @brief Write a printf-style log.
+ *
+ * @note A log is at most 16 KiB with its prefix. A longer text is written as
+ * several logs in a row, split at the lines where possible, each with the
+ * prefix; the logs of other threads may come in between.
+ */
 SIRIUS_API void ss_log_impl(int level, const char *module, const char *file,
                             int line, const char *fmt, ...);
 SIRIUS_API void ss_logsp_impl(int level, const char *module, const char *fmt,
                               ...);
 
+/**
+ * @brief Write a structured record.
+ *
+ * @param[in] level Log level, `SS_LOG_LEVEL_*`.
+ * @param[in] module Module name.
+ * @param[in] file Source file name, may be empty.
+ * @param[in] line Source line.
+ * @param[in] msg Message.
+ * @param[in] nb_kvs Number of the key-value pairs.
+ * @param[in] kvs Key-value pairs. Pairs with an empty key are skipped. A key
+ * named as a field of the encoders (`ts`, `level`, `module`, `pid`, `tid`,
+ * `file`, `line`, `msg`) is written prefixed with `_` by JSON and logfmt.
+ *
+ * @note The record is transferred as binary fields and is encoded by the
+ * consumer according to the `encoder` of the destination.
+ */
+SIRIUS_API void ss_log_kv_impl(int level, const char *module,
+                               const char *file, int line, const char *msg,
+                               size_t nb_kvs, const ss_log_kv_t *kvs);
+
+/**
+ * @brief Write pre-formatted bytes as they are.
+ *
+ * @param[in] level Log level, `SS_LOG_LEVEL_*`, selects the destination.
+ * @param[in] buf The bytes, e.g., lines of CSV.
+ * @param[in] len The number of bytes.
+ *
+ * @return 0 on success, or an errno value on failure.
+ *
+ * @note
+ * - (1) Neither the prefix, the formatting, the line prefixing nor the ANSI
+ * colors are applied, and the runtime level is not checked.
+ *
+ * - (2) A `buf` longer than the log buffer is written in several messages,
+ * which may be interleaved with the messages of other threads. Split it on
+ * line boundaries when that matters.
+ */
+SIRIUS_API int ss_log_write_raw(int level, const void *buf, size_t len);
+
+/**
+ * @brief Set the runtime log level of a module.
+ *
+ * @param[in] module Module name (`_SIRIUS_LOG_MODULE_NAME`). If `nullptr` or
+ * empty, set the default level, which applies to every module whose level has
+ * not been set explicitly.
+ * @param[in] level Log level, `SS_LOG_LEVEL_*`.
+ *
+ * @return 0 on success, or an errno value on failure.
+ *
+ * @note
+ * - (1) The runtime level can only lower the compile-time level
+ * `_SIRIUS_LOG_LEVEL`, statements above the latter are not compiled.
+ *
+ * - (2) The initial levels can be given by the environment variable
+ * `_SIRIUS_ENV_LOG_LEVEL`, @ref `sirius/config.h`.
+ */
+SIRIUS_API int ss_log_set_level(const char *module, int level);
+
+/**
+ * @brief Get the runtime log level of a module.
+ *
+ * @param[in] module Module name. If `nullptr` or empty, get the default level.
+ *
+ * @return The log level, `SS_LOG_LEVEL_*`. The default level for a module
+ * which is not known yet, which stays unknown.
+ */
+SIRIUS_API int ss_log_get_level(const char *module);
+
+/**
+ * @brief Bind a gate word to the runtime log level of a module: from now on,
+ * `*word` is kept equal to the level, or'ed with
+ * `_SS_INNER_LOG_GATE_FLIGHT` while the flight recorder is on.
+ *
+ * @return The gate word.
+ *
+ * @note
+ * - (1) It is used by the log macros, one word per translation unit, which
+ * is read with a single relaxed atomic load.
+ *
+ * - (2) The word must remain valid until the process exits, i.e. a library
+ * using the log macros must not be unloaded.
+ */
+SIRIUS_API int ss_log_level_bind(const char *module, int *word);
+
+/**
+ * @brief Token bucket of a rate-limited call site: at most `burst` messages
+ * every `interval_ms`.
+ *
+ * @return -1 if the message should be dropped. Otherwise, the number of the
+ * messages dropped in the previous interval.
+ */
+SIRIUS_API int64_t ss_log_ratelimit(ss_log_ratelimit_t *rl,
+                                    uint32_t interval_ms, uint32_t burst);
+
+/**
+ * @return 1 for the first caller on the `flag`, 0 for the others.
+ */
+SIRIUS_API int ss_log_once(int *flag);
+
+/**
+ * @return 1 for one call out of every `n` on the `sample`, starting with the
+ * first, 0 for the others.
+ */
+SIRIUS_API int ss_log_sample_every(ss_log_sample_t *sample, uint32_t n);
+
+/**
+ * @return 1 with the `probability` (0.0 - 1.0), 0 otherwise.
+ *
+ * @note A per-thread pseudo-random generator, neither locked nor shared.
+ */
+SIRIUS_API int ss_log_sample_chance(double probability);
+
+/**
+ * @brief Flight-recorder mode: the debug messages are kept in memory, per
+ * thread, and only written right before an error message of the same thread.
+ *
+ * @param[in] depth The number of the last debug messages kept per thread, at
+ * most 4096. 0 leaves the mode.
+ *
+ * @return 0 on success, or an errno value on failure.
+ *
+ * @note
+ * - (1) While the mode is on, the debug messages are recorded whatever the
+ * runtime level is, and are never written but with an error. The messages
+ * above the compile-time level `_SIRIUS_LOG_LEVEL` are not compiled.
+ *
+ * - (2) The messages recorded by a thread are lost when it exits.
+ */
+SIRIUS_API int ss_log_flight_recorder(uint32_t depth);
+
+/**
+ * @brief Start the initialization of the shared log in the background.
+ *
+ * @return 0 on success, or an errno value on failure.
+ *
+ * @note
+ * - (1) Optional. Without it, the first log call initializes synchronously,
+ * and may wait for the daemon to be spawned.
+ *
+ * - (2) Until the daemon is ready, the messages are buffered in the process
+ * (at most 1024, the excess is dropped), then handed over in order. If the
+ * daemon cannot be reached, they are written natively.
+ */
+SIRIUS_API int ss_log_init_async(void);
+
+/**
+ * @brief Emergency flush for a crashing process.
+ *
+ * @note
+ * - (1) Async-signal-safe. It is intended to be called from a `SIGSEGV` /
+ * `SIGABRT` handler, right before the process terminates.
+ *
+ * - (2) The in-flight messages of the process are handed to the daemon at
+ * once, instead of being replaced by a loss notice once the daemon finds the
+ * process dead, and the daemon is woken up. A message that was still being
+ * copied may be written partially.
+ *
+ * - (3) Only applies to `SsThreadProcess::kSsThreadProcessShared`.
+ */
+SIRIUS_API void ss_log_crash_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+#  define _ss_inner_log_load_relaxed(ptr) __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#else
+#  define _ss_inner_log_load_relaxed(ptr) (*(ptr))
+#endif
+
+/**
+ * @brief The gate word of a translation unit, @ref `ss_log_level_bind`: the
+ * runtime level of the module in the low byte, and the flight recorder bit.
+ */
+#define _SS_INNER_LOG_GATE_LEVEL_MASK (0xff)
+#define _SS_INNER_LOG_GATE_FLIGHT (0x100)
+#define _SS_INNER_LOG_GATE_UNBOUND (-1)
+
+static inline int *_ss_inner_log_gate_word(void) {
+  static int word = _SS_INNER_LOG_GATE_UNBOUND;
+  return &word;
+}
+
+/**
+ * @return Non-zero if `level <= (gate & mask)`.
+ *
+ * @note The unbound word passes any level, so that only the enabled path
+ * checks for it, and the disabled path costs a single load.
+ */
+static inline int _ss_inner_log_gate_pass(int level, int mask) {
+  int gate = _ss_inner_log_load_relaxed(_ss_inner_log_gate_word());
+  if (ss_likely(level > (gate & mask)))
+    return 0;
+  if (ss_unlikely(gate == _SS_INNER_LOG_GATE_UNBOUND)) {
+    gate =
+      ss_log_level_bind(_SIRIUS_LOG_MODULE_NAME, _ss_inner_log_gate_word());
+    return level <= (gate & mask);
+  }
+  return 1;
+}
+
+/**
+ * @note Evaluated before any argument of the log statement.
+ */
+#define _ss_inner_log_enabled(level) \
+  _ss_inner_log_gate_pass(level, _SS_INNER_LOG_GATE_LEVEL_MASK)
+
+/**
+ * @brief The debug messages are also wanted by the flight recorder, whose
+ * bit is above any level.
+ */
+#define _ss_inner_log_debug_enabled() \
+  _ss_inner_log_gate_pass(SS_LOG_LEVEL_DEBUG, \
+                          _SS_INNER_LOG_GATE_LEVEL_MASK | \
+                            _SS_INNER_LOG_GATE_FLIGHT)
+
 #define _ss_inner_log_void(level, fmt, ...) \
   do { \
     if (0) { \
@@ -76,11 +377,19 @@ SIRIUS_API void ss_logsp_impl(int level, const char *module, const char *fmt,
 
 #if (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_ERROR)
 #  define _ss_inner_log_error(fmt, ...) \
-    ss_log_impl(SS_LOG_LEVEL_ERROR, _SIRIUS_LOG_MODULE_NAME, SS_FILE_NAME, \
-                __LINE__, fmt, ##__VA_ARGS__)
+    do { \
+      if (_ss_inner_log_enabled(SS_LOG_LEVEL_ERROR)) { \
+        ss_log_impl(SS_LOG_LEVEL_ERROR, _SIRIUS_LOG_MODULE_NAME, SS_FILE_NAME, \
+                    __LINE__, fmt, ##__VA_ARGS__); \
+      } \
+    } while (0)
 #  define _ss_inner_log_errorsp(fmt, ...) \
-    ss_logsp_impl(SS_LOG_LEVEL_ERROR, _SIRIUS_LOG_MODULE_NAME, fmt, \
-                  ##__VA_ARGS__)
+    do { \
+      if (_ss_inner_log_enabled(SS_LOG_LEVEL_ERROR)) { \
+        ss_logsp_impl(SS_LOG_LEVEL_ERROR, _SIRIUS_LOG_MODULE_NAME, fmt, \
+                      ##__VA_ARGS__); \
+      } \
+    } while (0)
 #else
 #  define _ss_inner_log_error(fmt, ...) \
     _ss_inner_log_void(SS_LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
@@ -90,11 +399,19 @@ SIRIUS_API void ss_logsp_impl(int level, const char *module, const char *fmt,
 
 #if (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_WARN)
 #  define _ss_inner_log_warn(fmt, ...) \
-    ss_log_impl(SS_LOG_LEVEL_WARN, _SIRIUS_LOG_MODULE_NAME, SS_FILE_NAME, \
-                __LINE__, fmt, ##__VA_ARGS__)
+    do { \
+      if (_ss_inner_log_enabled(SS_LOG_LEVEL_WARN)) { \
+        ss_log_impl(SS_LOG_LEVEL_WARN, _SIRIUS_LOG_MODULE_NAME, SS_FILE_NAME, \
+                    __LINE__, fmt, ##__VA_ARGS__); \
+      } \
+    } while (0)
 #  define _ss_inner_log_warnsp(fmt, ...) \
-    ss_logsp_impl(SS_LOG_LEVEL_WARN, _SIRIUS_LOG_MODULE_NAME, fmt, \
-                  ##__VA_ARGS__)
+    do { \
+      if (_ss_inner_log_enabled(SS_LOG_LEVEL_WARN)) { \
+        ss_logsp_impl(SS_LOG_LEVEL_WARN, _SIRIUS_LOG_MODULE_NAME, fmt, \
+                      ##__VA_ARGS__); \
+      } \
+    } while (0)
 #else
 #  define _ss_inner_log_warn(fmt, ...) \
     _ss_inner_log_void(SS_LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
@@ -104,11 +421,19 @@ SIRIUS_API void ss_logsp_impl(int level, const char *module, const char *fmt,
 
 #if (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_INFO)
 #  define _ss_inner_log_info(fmt, ...) \
-    ss_log_impl(SS_LOG_LEVEL_INFO, _SIRIUS_LOG_MODULE_NAME, SS_FILE_NAME, \
-                __LINE__, fmt, ##__VA_ARGS__)
+    do { \
+      if (_ss_inner_log_enabled(SS_LOG_LEVEL_INFO)) { \
+        ss_log_impl(SS_LOG_LEVEL_INFO, _SIRIUS_LOG_MODULE_NAME, SS_FILE_NAME, \
+                    __LINE__, fmt, ##__VA_ARGS__); \
+      } \
+    } while (0)
 #  define _ss_inner_log_infosp(fmt, ...) \
-    ss_logsp_impl(SS_LOG_LEVEL_INFO, _SIRIUS_LOG_MODULE_NAME, fmt, \
-                  ##__VA_ARGS__)
+    do { \
+      if (_ss_inner_log_enabled(SS_LOG_LEVEL_INFO)) { \
+        ss_logsp_impl(SS_LOG_LEVEL_INFO, _SIRIUS_LOG_MODULE_NAME, fmt, \
+                      ##__VA_ARGS__); \
+      } \
+    } while (0)
 #else
 #  define _ss_inner_log_info(fmt, ...) \
     _ss_inner_log_void(SS_LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
@@ -118,11 +443,19 @@ SIRIUS_API void ss_logsp_impl(int level, const char *module, const char *fmt,
 
 #if (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_DEBUG)
 #  define _ss_inner_log_debug(fmt, ...) \
-    ss_log_impl(SS_LOG_LEVEL_DEBUG, _SIRIUS_LOG_MODULE_NAME, SS_FILE_NAME, \
-                __LINE__, fmt, ##__VA_ARGS__)
+    do { \
+      if (_ss_inner_log_debug_enabled()) { \
+        ss_log_impl(SS_LOG_LEVEL_DEBUG, _SIRIUS_LOG_MODULE_NAME, SS_FILE_NAME, \
+                    __LINE__, fmt, ##__VA_ARGS__); \
+      } \
+    } while (0)
 #  define _ss_inner_log_debugsp(fmt, ...) \
-    ss_logsp_impl(SS_LOG_LEVEL_DEBUG, _SIRIUS_LOG_MODULE_NAME, fmt, \
-                  ##__VA_ARGS__)
+    do { \
+      if (_ss_inner_log_debug_enabled()) { \
+        ss_logsp_impl(SS_LOG_LEVEL_DEBUG, _SIRIUS_LOG_MODULE_NAME, fmt, \
+                      ##__VA_ARGS__); \
+      } \
+    } while (0)
 #else
 #  define _ss_inner_log_debug(fmt, ...) \
     _ss_inner_log_void(SS_LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
@@ -130,6 +463,115 @@ SIRIUS_API void ss_logsp_impl(int level, const char *module, const char *fmt,
     _ss_inner_logsp_void(SS_LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
 #endif
 
+#define _ss_inner_log_kv_void(level, msg, nb_kvs, kvs) \
+  do { \
+    if (0) { \
+      ss_log_kv_impl(level, "", "", 0, msg, nb_kvs, kvs); \
+    } \
+  } while (0)
+
+#if (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_ERROR)
+#  define _ss_inner_log_kv_error(msg, nb_kvs, kvs) \
+    do { \
+      if (_ss_inner_log_enabled(SS_LOG_LEVEL_ERROR)) { \
+        ss_log_kv_impl(SS_LOG_LEVEL_ERROR, _SIRIUS_LOG_MODULE_NAME, \
+                       SS_FILE_NAME, __LINE__, msg, nb_kvs, kvs); \
+      } \
+    } while (0)
+#else
+#  define _ss_inner_log_kv_error(msg, nb_kvs, kvs) \
+    _ss_inner_log_kv_void(SS_LOG_LEVEL_ERROR, msg, nb_kvs, kvs)
+#endif
+
+#if (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_WARN)
+#  define _ss_inner_log_kv_warn(msg, nb_kvs, kvs) \
+    do { \
+      if (_ss_inner_log_enabled(SS_LOG_LEVEL_WARN)) { \
+        ss_log_kv_impl(SS_LOG_LEVEL_WARN, _SIRIUS_LOG_MODULE_NAME, \
+                       SS_FILE_NAME, __LINE__, msg, nb_kvs, kvs); \
+      } \
+    } while (0)
+#else
+#  define _ss_inner_log_kv_warn(msg, nb_kvs, kvs) \
+    _ss_inner_log_kv_void(SS_LOG_LEVEL_WARN, msg, nb_kvs, kvs)
+#endif
+
+#if (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_INFO)
+#  define _ss_inner_log_kv_info(msg, nb_kvs, kvs) \
+    do { \
+      if (_ss_inner_log_enabled(SS_LOG_LEVEL_INFO)) { \
+        ss_log_kv_impl(SS_LOG_LEVEL_INFO, _SIRIUS_LOG_MODULE_NAME, \
+                       SS_FILE_NAME, __LINE__, msg, nb_kvs, kvs); \
+      } \
+    } while (0)
+#else
+#  define _ss_inner_log_kv_info(msg, nb_kvs, kvs) \
+    _ss_inner_log_kv_void(SS_LOG_LEVEL_INFO, msg, nb_kvs, kvs)
+#endif
+
+#if (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_DEBUG)
+#  define _ss_inner_log_kv_debug(msg, nb_kvs, kvs) \
+    do { \
+      if (_ss_inner_log_debug_enabled()) { \
+        ss_log_kv_impl(SS_LOG_LEVEL_DEBUG, _SIRIUS_LOG_MODULE_NAME, \
+                       SS_FILE_NAME, __LINE__, msg, nb_kvs, kvs); \
+      } \
+    } while (0)
+#else
+#  define _ss_inner_log_kv_debug(msg, nb_kvs, kvs) \
+    _ss_inner_log_kv_void(SS_LOG_LEVEL_DEBUG, msg, nb_kvs, kvs)
+#endif
+
+/**
+ * @brief The predicate of `_ss_inner_log_<level>`, so that the debug variants
+ * also feed the flight recorder.
+ */
+#define _ss_inner_log_compiled_enabled(level) \
+  ((_SIRIUS_LOG_LEVEL >= (level)) && \
+   ((level) == SS_LOG_LEVEL_DEBUG ? _ss_inner_log_debug_enabled() \
+                                  : _ss_inner_log_enabled(level)))
+
+#define _ss_inner_log_ratelimited(level, log_fn, interval_ms, burst, fmt, \
+                                  ...) \
+  do { \
+    static ss_log_ratelimit_t _ss_rl = SS_LOG_RATELIMIT_INITIALIZER; \
+    if (_ss_inner_log_compiled_enabled(level)) { \
+      int64_t _ss_missed = ss_log_ratelimit(&_ss_rl, interval_ms, burst); \
+      if (_ss_missed > 0) { \
+        log_fn("%lld messages suppressed\n", (long long)_ss_missed); \
+      } \
+      if (_ss_missed >= 0) { \
+        log_fn(fmt, ##__VA_ARGS__); \
+      } \
+    } \
+  } while (0)
+
+#define _ss_inner_log_every(level, log_fn, n, fmt, ...) \
+  do { \
+    static ss_log_sample_t _ss_sample = SS_LOG_SAMPLE_INITIALIZER; \
+    if (_ss_inner_log_compiled_enabled(level) && \
+        ss_log_sample_every(&_ss_sample, n)) { \
+      log_fn(fmt, ##__VA_ARGS__); \
+    } \
+  } while (0)
+
+#define _ss_inner_log_sampled(level, log_fn, probability, fmt, ...) \
+  do { \
+    if (_ss_inner_log_compiled_enabled(level) && \
+        ss_log_sample_chance(probability)) { \
+      log_fn(fmt, ##__VA_ARGS__); \
+    } \
+  } while (0)
+
+#define _ss_inner_log_once(level, log_fn, fmt, ...) \
+  do { \
+    static int _ss_once = 0; \
+    if (_ss_inner_log_compiled_enabled(level) && \
+        !_ss_inner_log_load_relaxed(&_ss_once) && ss_log_once(&_ss_once)) { \
+      log_fn(fmt, ##__VA_ARGS__); \
+    } \
+  } while (0)
+
 // clang-format off
 #define ss_log_error(fmt, ...) _ss_inner_log_error(fmt, ##__VA_ARGS__)
 #define ss_log_warn(fmt, ...) _ss_inner_log_warn(fmt, ##__VA_ARGS__)
@@ -140,4 +582,56 @@ SIRIUS_API void ss_logsp_impl(int level, const char *module, const char *fmt,
 #define ss_log_warnsp(fmt, ...) _ss_inner_log_warnsp(fmt, ##__VA_ARGS__)
 #define ss_log_infosp(fmt, ...) _ss_inner_log_infosp(fmt, ##__VA_ARGS__)
 #define ss_log_debugsp(fmt, ...) _ss_inner_log_debugsp(fmt, ##__VA_ARGS__)
+
+/**
+ * @example
+ * ss_log_kv_t kvs[] = {{"user", "alice"}, {"code", "404"}};
+ * ss_log_kv_info("Request failed", 2, kvs);
+ */
+#define ss_log_kv_error(msg, nb_kvs, kvs) _ss_inner_log_kv_error(msg, nb_kvs, kvs)
+#define ss_log_kv_warn(msg, nb_kvs, kvs) _ss_inner_log_kv_warn(msg, nb_kvs, kvs)
+#define ss_log_kv_info(msg, nb_kvs, kvs) _ss_inner_log_kv_info(msg, nb_kvs, kvs)
+#define ss_log_kv_debug(msg, nb_kvs, kvs) _ss_inner_log_kv_debug(msg, nb_kvs, kvs)
+
+/**
+ * @brief At most `burst` messages every `interval_ms` per call site, the
+ * number of the dropped messages is reported with the next message.
+ *
+ * @example
+ * ss_log_error_ratelimited(1000, 5, "Null pointer\n");
+ */
+#define ss_log_error_ratelimited(interval_ms, burst, fmt, ...) _ss_inner_log_ratelimited(SS_LOG_LEVEL_ERROR, _ss_inner_log_error, interval_ms, burst, fmt, ##__VA_ARGS__)
+#define ss_log_warn_ratelimited(interval_ms, burst, fmt, ...) _ss_inner_log_ratelimited(SS_LOG_LEVEL_WARN, _ss_inner_log_warn, interval_ms, burst, fmt, ##__VA_ARGS__)
+#define ss_log_info_ratelimited(interval_ms, burst, fmt, ...) _ss_inner_log_ratelimited(SS_LOG_LEVEL_INFO, _ss_inner_log_info, interval_ms, burst, fmt, ##__VA_ARGS__)
+#define ss_log_debug_ratelimited(interval_ms, burst, fmt, ...) _ss_inner_log_ratelimited(SS_LOG_LEVEL_DEBUG, _ss_inner_log_debug, interval_ms, burst, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief Only the first message per call site.
+ */
+#define ss_log_error_once(fmt, ...) _ss_inner_log_once(SS_LOG_LEVEL_ERROR, _ss_inner_log_error, fmt, ##__VA_ARGS__)
+#define ss_log_warn_once(fmt, ...) _ss_inner_log_once(SS_LOG_LEVEL_WARN, _ss_inner_log_warn, fmt, ##__VA_ARGS__)
+#define ss_log_info_once(fmt, ...) _ss_inner_log_once(SS_LOG_LEVEL_INFO, _ss_inner_log_info, fmt, ##__VA_ARGS__)
+#define ss_log_debug_once(fmt, ...) _ss_inner_log_once(SS_LOG_LEVEL_DEBUG, _ss_inner_log_debug, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief One message out of every `n` per call site.
+ *
+ * @example
+ * ss_log_info_every(1000, "Packet: %d\n", id);
+ */
+#define ss_log_error_every(n, fmt, ...) _ss_inner_log_every(SS_LOG_LEVEL_ERROR, _ss_inner_log_error, n, fmt, ##__VA_ARGS__)
+#define ss_log_warn_every(n, fmt, ...) _ss_inner_log_every(SS_LOG_LEVEL_WARN, _ss_inner_log_warn, n, fmt, ##__VA_ARGS__)
+#define ss_log_info_every(n, fmt, ...) _ss_inner_log_every(SS_LOG_LEVEL_INFO, _ss_inner_log_info, n, fmt, ##__VA_ARGS__)
+#define ss_log_debug_every(n, fmt, ...) _ss_inner_log_every(SS_LOG_LEVEL_DEBUG, _ss_inner_log_debug, n, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief Each message with the `probability` (0.0 - 1.0).
+ *
+ * @example
+ * ss_log_info_sampled(0.01, "Packet: %d\n", id);
+ */
+#define ss_log_error_sampled(probability, fmt, ...) _ss_inner_log_sampled(SS_LOG_LEVEL_ERROR, _ss_inner_log_error, probability, fmt, ##__VA_ARGS__)
+#define ss_log_warn_sampled(probability, fmt, ...) _ss_inner_log_sampled(SS_LOG_LEVEL_WARN, _ss_inner_log_warn, probability, fmt, ##__VA_ARGS__)
+#define ss_log_info_sampled(probability, fmt, ...) _ss_inner_log_sampled(SS_LOG_LEVEL_INFO, _ss_inner_log_info, probability, fmt, ##__VA_ARGS__)
+#define ss_log_debug_sampled(probability, fmt, ...) _ss_inner_log_sampled(SS_LOG_LEVEL_DEBUG, _ss_inner_log_debug, probability, fmt, ##__VA_ARGS__)
 // clang-format on
@@ -2,6 +2,11 @@
  * @note
  * - (1) `enum SsThreadProcess`: On Windows, inter-process sharing is not
  * supported.
+ *
+ * - (2) A condition variable shared between processes pairs with a mutex of
+ * `kSsMutexTypeShared`. Then the waits may return `EOWNERDEAD`, as
+ * `ss_mutex_lock` does: the mutex is locked again, but its previous owner
+ * died.
  */
 
 #pragma once
@@ -50,11 +55,30 @@ SIRIUS_API int ss_cond_wait(ss_cond_t *__restrict cond,
  * @brief Wait the condition variable, but limit the waiting time.
  *
  * @return 0 on success, or an `errno` value on failure.
+ *
+ * @note The waiting time is measured on a monotonic clock, so a step of the
+ * wall clock neither shortens nor extends it.
  */
 SIRIUS_API int ss_cond_timedwait(ss_cond_t *__restrict cond,
                                  ss_mutex_t *__restrict mutex,
                                  uint64_t milliseconds);
 
+/**
+ * @brief Wait the condition variable, until an absolute deadline.
+ *
+ * @param[in] deadline_ns The deadline, in nanoseconds of
+ * `ss_get_clock_monotonic_ns`.
+ *
+ * @return 0 on success, `ETIMEDOUT` once the deadline has passed, or an
+ * `errno` value on failure.
+ *
+ * @note A loop which waits for a predicate computes the deadline once, so
+ * that the spurious wakeups do not extend the overall waiting time.
+ */
+SIRIUS_API int ss_cond_wait_until(ss_cond_t *__restrict cond,
+                                  ss_mutex_t *__restrict mutex,
+                                  uint64_t deadline_ns);
+
 /**
  * @brief Wake up a condition variable.
  *
@@ -0,0 +1,92 @@
+/**
+ * @note
+ * - (1) An event count puts blocking on top of a lock-free structure: a
+ * consumer which finds nothing to do registers with `ss_event_prepare_wait`,
+ * checks its condition again, then either sleeps with `ss_event_commit_wait`
+ * or, if the condition became true meanwhile, backs out with
+ * `ss_event_cancel_wait`. A producer changes the structure, then calls
+ * `ss_event_notify`, which only costs a fence and a load while no consumer is
+ * registered.
+ *
+ * - (2) The wakeups may be spurious, the consumer checks its condition again
+ * after `ss_event_commit_wait`.
+ *
+ * - (3) Inter-process sharing is not supported.
+ *
+ * @example
+ * while (!try_pop(&queue, &item)) {
+ *   uint32_t key = ss_event_prepare_wait(&event);
+ *   if (try_pop(&queue, &item)) {
+ *     ss_event_cancel_wait(&event);
+ *     break;
+ *   }
+ *   ss_event_commit_wait(&event, key);
+ * }
+ */
+
+#pragma once
+
+#include "sirius/attributes.h"
+#include "sirius/inner/common.h"
+
+typedef struct {
+  /**
+   * @brief Bumped by the notifications which find a registered consumer.
+   */
+  uint32_t __epoch;
+
+  /**
+   * @brief Number of the registered consumers.
+   */
+  uint32_t __waiters;
+} ss_event_t;
+
+#define SS_EVENT_INITIALIZER {0, 0}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize an event count.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_event_init(ss_event_t *event);
+
+/**
+ * @brief Register the intent to wait. It must be followed by either
+ * `ss_event_commit_wait` or `ss_event_cancel_wait`.
+ *
+ * @return The key to pass to `ss_event_commit_wait`.
+ */
+SIRIUS_API uint32_t ss_event_prepare_wait(ss_event_t *event);
+
+/**
+ * @brief Sleep until a notification after the matching
+ * `ss_event_prepare_wait`, and unregister.
+ *
+ * @param[in] key The result of `ss_event_prepare_wait`.
+ *
+ * @note It returns at once if a notification already happened.
+ */
+SIRIUS_API void ss_event_commit_wait(ss_event_t *event, uint32_t key);
+
+/**
+ * @brief Unregister without sleeping.
+ */
+SIRIUS_API void ss_event_cancel_wait(ss_event_t *event);
+
+/**
+ * @brief Wake up at least one registered consumer, if any.
+ */
+SIRIUS_API void ss_event_notify(ss_event_t *event);
+
+/**
+ * @brief Wake up all the registered consumers.
+ */
+SIRIUS_API void ss_event_notify_all(ss_event_t *event);
+
+#ifdef __cplusplus
+}
+#endif
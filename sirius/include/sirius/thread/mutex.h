@@ -27,6 +27,35 @@ enum SsMutexType {
    * On POSIX, this uses `PTHREAD_MUTEX_RECURSIVE`.
    */
   kSsMutexTypeRecursive = 1,
+
+  /**
+   * @brief A non-recursive mutex for short critical sections.
+   * On Linux, this is a futex lock which spins a bounded, adaptive number of
+   * times before sleeping, see `ss_mutex_lite_t`.
+   * On Windows, this is the same as `kSsMutexTypeNormal`.
+   * On the other POSIX platforms, this uses `PTHREAD_MUTEX_NORMAL`.
+   *
+   * @note On Linux, it cannot be waited on with `ss_cond_t`, which returns
+   * `EINVAL`.
+   */
+  kSsMutexTypeAdaptive = 2,
+
+  /**
+   * @brief A non-recursive mutex which can be placed in memory shared between
+   * processes, and which survives the death of its owner.
+   * On POSIX, this uses `PTHREAD_PROCESS_SHARED` and `PTHREAD_MUTEX_ROBUST`.
+   * On Windows, macOS and Android, which lack robust mutexes, this is not
+   * supported, `ss_mutex_init` returns `ENOTSUP`.
+   *
+   * @note
+   * - (1) It is initialized once, by one process, and the other processes
+   * use it as is.
+   *
+   * - (2) If the owner dies while holding it, the next lock returns
+   * `EOWNERDEAD`: the mutex is acquired and usable again, but the data it
+   * protects may be inconsistent.
+   */
+  kSsMutexTypeShared = 3,
 };
 
 /**
@@ -51,7 +80,8 @@ SIRIUS_API int ss_mutex_destroy(ss_mutex_t *mutex);
 /**
  * @brief Lock the mutex.
  *
- * @return 0 on success, or an `errno` value on failure.
+ * @return 0 on success, `EOWNERDEAD` if acquired from a dead owner, see
+ * `kSsMutexTypeShared`, or an `errno` value on failure.
  */
 SIRIUS_API int ss_mutex_lock(ss_mutex_t *mutex);
 
@@ -65,10 +95,58 @@ SIRIUS_API int ss_mutex_unlock(ss_mutex_t *mutex);
 /**
  * @brief Try to lock the mutex without blocking.
  *
- * @return 0 on success, or an `errno` value on failure.
+ * @return 0 on success, `EOWNERDEAD` if acquired from a dead owner, see
+ * `kSsMutexTypeShared`, or an `errno` value on failure.
  */
 SIRIUS_API int ss_mutex_trylock(ss_mutex_t *mutex);
 
+/**
+ * @brief A non-recursive mutex of 4 bytes, which can be embedded in small
+ * objects, e.g., one per hash bucket.
+ *
+ * @note
+ * - (1) The lock spins a bounded number of times while the owner holds it
+ * without sleepers, then sleeps on a futex (`WaitOnAddress` on Windows). On
+ * the other platforms, a waiter yields its time slice instead of sleeping.
+ *
+ * - (2) A zero-filled object is unlocked, no destruction is needed.
+ *
+ * - (3) Inter-process sharing is not supported.
+ */
+typedef struct {
+  uint32_t __word;
+} ss_mutex_lite_t;
+
+#define SS_MUTEX_LITE_INITIALIZER {0}
+
+/**
+ * @brief Initialize a lite mutex, unlocked.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_mutex_lite_init(ss_mutex_lite_t *mutex);
+
+/**
+ * @brief Lock the lite mutex.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_mutex_lite_lock(ss_mutex_lite_t *mutex);
+
+/**
+ * @brief Unlock the lite mutex.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_mutex_lite_unlock(ss_mutex_lite_t *mutex);
+
+/**
+ * @brief Try to lock the lite mutex without blocking.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_mutex_lite_trylock(ss_mutex_lite_t *mutex);
+
 #ifdef __cplusplus
 }
 #endif
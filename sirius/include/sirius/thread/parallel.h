@@ -0,0 +1,241 @@
+/**
+ * @note
+ * - (1) The loops run on a process-wide `ss_threadpool_t`, created on the
+ * first loop which is worth splitting, with one worker less than the hardware
+ * threads, since the calling thread takes part.
+ *
+ * - (2) The range is split in halves lazily: a participant only splits its
+ * range while fewer halves are waiting to be stolen than there are workers,
+ * so an idle worker always finds one, and a busy pool does not pay for the
+ * splits.
+ *
+ * - (3) A loop may be nested in the body of another one, the waiting workers
+ * run the pending tasks meanwhile.
+ */
+
+#pragma once
+
+#include "sirius/attributes.h"
+#include "sirius/inner/common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Loop body, over the indexes `[begin, end)`.
+ */
+typedef void (*ss_parallel_for_fn_t)(size_t begin, size_t end, void *ctx);
+
+/**
+ * @brief Run `fn` over `[begin, end)`, in chunks of at most `grain` indexes,
+ * and return once all of them are done.
+ *
+ * @param[in] begin First index.
+ * @param[in] end Index past the last one.
+ * @param[in] grain Maximum number of indexes per call of `fn`. If 0, about
+ * eight chunks per worker.
+ * @param[in] fn Loop body.
+ * @param[in] ctx Parameters of the body.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ *
+ * @note A range of at most `grain` indexes runs on the calling thread, without
+ * touching the pool.
+ */
+SIRIUS_API int ss_parallel_for(size_t begin, size_t end, size_t grain,
+                               ss_parallel_for_fn_t fn, void *ctx);
+
+typedef struct {
+  /**
+   * @brief Size of a partial result, i.e., of `*result`.
+   */
+  size_t partial_size;
+
+  /**
+   * @brief Initialize a partial result to the identity. If `nullptr`, the
+   * initial bytes of `*result` are copied.
+   */
+  void (*init)(void *partial, void *ctx);
+
+  /**
+   * @brief Accumulate `[begin, end)` into `partial`.
+   */
+  void (*body)(size_t begin, size_t end, void *partial, void *ctx);
+
+  /**
+   * @brief Merge `src`, the partial result of the indexes right after the
+   * ones of `dst`, into `dst`.
+   */
+  void (*join)(void *dst, void *src, void *ctx);
+
+  /**
+   * @brief Release a partial result after its join. Can be `nullptr`.
+   */
+  void (*fini)(void *partial, void *ctx);
+
+  void *ctx;
+} ss_parallel_reduce_args_t;
+
+/**
+ * @brief Reduce `[begin, end)` into `*result`.
+ *
+ * @param[in] begin First index.
+ * @param[in] end Index past the last one.
+ * @param[in] grain Maximum number of indexes per call of `body`. If 0, about
+ * eight chunks per worker.
+ * @param[in,out] result The identity on input, the reduction on output. It is
+ * also the partial result of the calling thread.
+ * @param[in] args Callbacks of the reduction.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ *
+ * @note The partial results are joined left to right, so `join` needs to be
+ * associative but not commutative, and the result does not depend on the
+ * scheduling.
+ */
+SIRIUS_API int ss_parallel_reduce(size_t begin, size_t end, size_t grain,
+                                  void *result,
+                                  const ss_parallel_reduce_args_t *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if defined(__cplusplus) && \
+  (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#  include <atomic>
+#  include <cstddef>
+#  include <exception>
+#  include <mutex>
+#  include <new>
+#  include <type_traits>
+
+namespace sirius {
+namespace parallel_inner {
+/**
+ * @brief The first exception of the bodies, rethrown on the calling thread.
+ * The chunks after it are skipped.
+ */
+struct Errors {
+  std::atomic<bool> failed {false};
+  std::exception_ptr error {};
+  std::mutex mutex {};
+
+  template <typename Fn>
+  void guard(Fn &&fn) noexcept {
+    if (failed.load(std::memory_order_relaxed))
+      return;
+    try {
+      fn();
+    } catch (...) {
+      auto lock = std::lock_guard(mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      failed.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  void rethrow() {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+};
+} // namespace parallel_inner
+
+/**
+ * @brief `ss_parallel_for` with a callable, either `fn(begin, end)` per chunk
+ * or `fn(index)` per index.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ *
+ * @note The first exception of `fn` is rethrown here.
+ */
+template <typename Fn>
+inline int parallel_for(size_t begin, size_t end, size_t grain, Fn &&fn) {
+  struct Ctx {
+    Fn &fn;
+    parallel_inner::Errors errors;
+  } ctx {fn, {}};
+
+  int ret = ss_parallel_for(
+    begin, end, grain,
+    [](size_t b, size_t e, void *arg) {
+      auto &c = *static_cast<Ctx *>(arg);
+      c.errors.guard([&]() {
+        if constexpr (std::is_invocable_v<Fn &, size_t, size_t>) {
+          c.fn(b, e);
+        } else {
+          for (size_t i = b; i < e; ++i) {
+            c.fn(i);
+          }
+        }
+      });
+    },
+    &ctx);
+  ctx.errors.rethrow();
+  return ret;
+}
+
+/**
+ * @brief `ss_parallel_reduce` with callables: `fn(begin, end, partial)` per
+ * chunk or `fn(index, partial)` per index, and `join(left, right)`, which
+ * merges `right` into `left`.
+ *
+ * @param[in,out] result The identity on input, the reduction on output.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ *
+ * @note The partial results are copies of the identity, the copy of `T` must
+ * not throw. The first exception of `fn` or `join` is rethrown here.
+ */
+template <typename T, typename Fn, typename Join>
+inline int parallel_reduce(size_t begin, size_t end, size_t grain, T &result,
+                           Fn &&fn, Join &&join) {
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "Over-aligned partial results are not supported");
+
+  struct Ctx {
+    const T identity;
+    Fn &fn;
+    Join &join;
+    parallel_inner::Errors errors;
+  } ctx {result, fn, join, {}};
+
+  ss_parallel_reduce_args_t args {};
+  args.partial_size = sizeof(T);
+  args.init = [](void *partial, void *arg) {
+    new (partial) T(static_cast<Ctx *>(arg)->identity);
+  };
+  args.body = [](size_t b, size_t e, void *partial, void *arg) {
+    auto &c = *static_cast<Ctx *>(arg);
+    auto &acc = *static_cast<T *>(partial);
+    c.errors.guard([&]() {
+      if constexpr (std::is_invocable_v<Fn &, size_t, size_t, T &>) {
+        c.fn(b, e, acc);
+      } else {
+        for (size_t i = b; i < e; ++i) {
+          c.fn(i, acc);
+        }
+      }
+    });
+  };
+  args.join = [](void *dst, void *src, void *arg) {
+    auto &c = *static_cast<Ctx *>(arg);
+    c.errors.guard(
+      [&]() { c.join(*static_cast<T *>(dst), *static_cast<T *>(src)); });
+  };
+  args.fini = [](void *partial, void *arg) {
+    (void)arg;
+    static_cast<T *>(partial)->~T();
+  };
+  args.ctx = &ctx;
+
+  int ret = ss_parallel_reduce(begin, end, grain, &result, &args);
+  ctx.errors.rethrow();
+  return ret;
+}
+} // namespace sirius
+#endif
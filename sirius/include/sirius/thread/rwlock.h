@@ -0,0 +1,103 @@
+/**
+ * @note
+ * - (1) Writers take precedence: once a writer waits, new readers wait behind
+ * it, so a steady flow of readers cannot starve the writers. A thread must
+ * therefore not take the read lock recursively.
+ *
+ * - (2) Inter-process sharing is not supported.
+ */
+
+#pragma once
+
+#include "sirius/attributes.h"
+#include "sirius/inner/common.h"
+
+typedef struct {
+  ss_alignas(void *) unsigned char __data[64];
+} ss_rwlock_t;
+
+#define SS_RWLOCK_INITIALIZER {{0}}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum SsRwlockType {
+  /**
+   * @brief Default, the readers share one counter.
+   */
+  kSsRwlockTypeNormal = 0,
+
+  /**
+   * @brief For read-mostly data: the readers are spread over counters of
+   * their own cache line, by thread, so that concurrent readers do not
+   * contend on one cache line. A writer pays for scanning all of them, and
+   * the lock allocates about 64 bytes per hardware thread.
+   */
+  kSsRwlockTypeDistributed = 1,
+};
+
+/**
+ * @brief Initialize a reader-writer lock.
+ *
+ * @param[out] rwlock A pointer to the lock object to be initialized.
+ * @param[in] type A pointer to the lock type. If `nullptr`, a default (normal)
+ * lock is created.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_rwlock_init(ss_rwlock_t *__restrict rwlock,
+                              const enum SsRwlockType *__restrict type);
+
+/**
+ * @brief Destroy the reader-writer lock.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_rwlock_destroy(ss_rwlock_t *rwlock);
+
+/**
+ * @brief Lock the reader-writer lock for reading.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_rwlock_rdlock(ss_rwlock_t *rwlock);
+
+/**
+ * @brief Try to lock the reader-writer lock for reading without blocking.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_rwlock_tryrdlock(ss_rwlock_t *rwlock);
+
+/**
+ * @brief Unlock the reader-writer lock, locked for reading.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_rwlock_rdunlock(ss_rwlock_t *rwlock);
+
+/**
+ * @brief Lock the reader-writer lock for writing.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_rwlock_wrlock(ss_rwlock_t *rwlock);
+
+/**
+ * @brief Try to lock the reader-writer lock for writing without blocking.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_rwlock_trywrlock(ss_rwlock_t *rwlock);
+
+/**
+ * @brief Unlock the reader-writer lock, locked for writing.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_rwlock_wrunlock(ss_rwlock_t *rwlock);
+
+#ifdef __cplusplus
+}
+#endif
@@ -48,9 +48,27 @@ SIRIUS_API int ss_sem_trywait(ss_sem_t *sem);
  * @brief Wait the semaphore, but limit the waiting time.
  *
  * @return 0 on success, or an `errno` value on failure.
+ *
+ * @note The waiting time is measured on a monotonic clock where the platform
+ * allows it, see `ss_sem_wait_until`.
  */
 SIRIUS_API int ss_sem_timedwait(ss_sem_t *sem, uint64_t milliseconds);
 
+/**
+ * @brief Wait the semaphore, until an absolute deadline.
+ *
+ * @param[in] deadline_ns The deadline, in nanoseconds of
+ * `ss_get_clock_monotonic_ns`.
+ *
+ * @return 0 on success, `ETIMEDOUT` once the deadline has passed, or an
+ * `errno` value on failure.
+ *
+ * @note The wait is on the monotonic clock with glibc 2.30 or later
+ * (`sem_clockwait`) and on Windows. Elsewhere, the deadline is converted to
+ * `CLOCK_REALTIME` when the wait starts.
+ */
+SIRIUS_API int ss_sem_wait_until(ss_sem_t *sem, uint64_t deadline_ns);
+
 /**
  * @brief Post the semaphore.
  *
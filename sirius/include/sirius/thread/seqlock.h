@@ -0,0 +1,81 @@
+/**
+ * @note
+ * - (1) A sequence lock suits small data which is read far more often than it
+ * is written: the readers never write to shared memory, they read a copy of
+ * the data between `ss_seqlock_read_begin` and `ss_seqlock_read_retry`, and
+ * retry if a writer ran meanwhile.
+ *
+ * - (2) Since a reader may observe a partial write before it retries, it must
+ * only copy the data, e.g., not follow a pointer read from it nor index an
+ * array with it, until `ss_seqlock_read_retry` returns 0.
+ *
+ * - (3) Inter-process sharing is not supported.
+ *
+ * @example
+ * do {
+ *   seq = ss_seqlock_read_begin(&lock);
+ *   copy = shared;
+ * } while (ss_seqlock_read_retry(&lock, seq));
+ */
+
+#pragma once
+
+#include "sirius/attributes.h"
+#include "sirius/inner/common.h"
+
+typedef struct {
+  /**
+   * @brief Odd while a writer holds the lock.
+   */
+  uint32_t __seq;
+  uint32_t __lock;
+} ss_seqlock_t;
+
+#define SS_SEQLOCK_INITIALIZER {0, 0}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize a sequence lock.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_seqlock_init(ss_seqlock_t *seqlock);
+
+/**
+ * @brief Start a read section, waiting for the writer in progress if any.
+ *
+ * @return The sequence to pass to `ss_seqlock_read_retry`.
+ */
+SIRIUS_API uint32_t ss_seqlock_read_begin(const ss_seqlock_t *seqlock);
+
+/**
+ * @brief End a read section.
+ *
+ * @param[in] seq The result of `ss_seqlock_read_begin`.
+ *
+ * @return Non-zero if a writer ran during the read section, which then needs
+ * to be retried; 0 if the data read is consistent.
+ */
+SIRIUS_API int ss_seqlock_read_retry(const ss_seqlock_t *seqlock,
+                                     uint32_t seq);
+
+/**
+ * @brief Lock the sequence lock for writing. The writers exclude each other.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_seqlock_write_lock(ss_seqlock_t *seqlock);
+
+/**
+ * @brief Unlock the sequence lock, locked for writing.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_seqlock_write_unlock(ss_seqlock_t *seqlock);
+
+#ifdef __cplusplus
+}
+#endif
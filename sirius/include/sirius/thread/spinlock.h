@@ -1,21 +1,130 @@
 /**
  * @note
- * - (1) `enum SsThreadProcess`: Inter-process sharing is not supported.
+ * - (1) `enum SsThreadProcess`: `ss_spinlock_t` and `ss_spinlock_ticket_t`
+ * are plain words, and work as is in memory shared between processes. But a
+ * process which dies while holding one leaves it locked for good, use
+ * `kSsMutexTypeShared` for a lock which recovers from the death of its
+ * owner. `ss_spinlock_mcs_t` links the nodes of the lockers by address, so
+ * it can not be shared between processes.
+ *
+ * - (2) Three spinlocks, to be picked per use site:
+ *   - `ss_spinlock_t`: test-and-test-and-set with exponential backoff. The
+ *     cheapest without contention, but unfair.
+ *   - `ss_spinlock_ticket_t`: first come, first served, all the waiters spin
+ *     on the same cache line.
+ *   - `ss_spinlock_mcs_t`: first come, first served, each waiter spins on its
+ *     own node, which scales to many cores. The node lives on the stack of
+ *     the locker, until the unlock.
+ *
+ * - (3) The fair locks hand the lock over to the next waiter, so a waiter
+ * which is preempted stalls the ones behind it. Their waiters yield their
+ * time slice after `SS_SPIN_YIELD_THRESHOLD` pauses.
  */
 
 #pragma once
 
+#include <errno.h>
+
 #include "sirius/foundation/sync.h"
+#include "sirius/inner/common.h"
 #include "sirius/thread/macro.h"
 
+/**
+ * @brief Upper bound of the backoff of `ss_spinlock_t`, in pauses.
+ */
+#define SS_SPIN_BACKOFF_MAX 1024
+
+/**
+ * @brief Pauses of a waiter of the fair locks before it yields.
+ */
+#define SS_SPIN_YIELD_THRESHOLD 1024
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Pause `*backoff` times after a lost race, and double it.
+ */
+static inline void _ss_spin_backoff(uint32_t *backoff) {
+  for (uint32_t i = 0; i < *backoff; ++i) {
+    ss_cpu_pause();
+  }
+  if (*backoff < SS_SPIN_BACKOFF_MAX) {
+    *backoff *= 2;
+  }
+}
+
+/**
+ * @brief One round of a waiter of the fair locks.
+ */
+static inline void _ss_spin_wait(uint32_t *nb_pauses) {
+  if (++*nb_pauses < SS_SPIN_YIELD_THRESHOLD) {
+    ss_cpu_pause();
+  } else {
+    *nb_pauses = 0;
+    ss_os_yield();
+  }
+}
+
 #if defined(_MSC_VER)
 typedef volatile long ss_spinlock_t;
 extern long _InterlockedCompareExchange(long volatile *, long, long);
 extern long _InterlockedExchange(long volatile *, long);
+extern long _InterlockedExchangeAdd(long volatile *, long);
+extern void _ReadWriteBarrier(void);
+#  pragma intrinsic(_ReadWriteBarrier)
+#  if defined(_WIN64)
+extern void *_InterlockedExchangePointer(void *volatile *, void *);
+extern void *_InterlockedCompareExchangePointer(void *volatile *, void *,
+                                                void *);
+#  endif
+
+typedef volatile long _ss_spin_word_t;
+typedef void *volatile _ss_spin_ptr_t;
+
+static inline uint32_t _ss_spin_load(_ss_spin_word_t *word) {
+  long value = *word;
+  _ReadWriteBarrier();
+  return (uint32_t)value;
+}
+
+static inline void _ss_spin_store(_ss_spin_word_t *word, uint32_t value) {
+  _InterlockedExchange(word, (long)value);
+}
+
+static inline uint32_t _ss_spin_fetch_add(_ss_spin_word_t *word,
+                                          uint32_t value) {
+  return (uint32_t)_InterlockedExchangeAdd(word, (long)value);
+}
+
+static inline void *_ss_spin_ptr_load(_ss_spin_ptr_t *ptr) {
+  void *value = *ptr;
+  _ReadWriteBarrier();
+  return value;
+}
+
+static inline void *_ss_spin_ptr_xchg(_ss_spin_ptr_t *ptr, void *value) {
+#  if defined(_WIN64)
+  return _InterlockedExchangePointer(ptr, value);
+#  else
+  return (void *)(intptr_t)_InterlockedExchange((long volatile *)ptr,
+                                                (long)(intptr_t)value);
+#  endif
+}
+
+static inline int _ss_spin_ptr_cas(_ss_spin_ptr_t *ptr, void *expected,
+                                   void *desired) {
+#  if defined(_WIN64)
+  return _InterlockedCompareExchangePointer(ptr, desired, expected) ==
+    expected;
+#  else
+  return _InterlockedCompareExchange((long volatile *)ptr,
+                                     (long)(intptr_t)desired,
+                                     (long)(intptr_t)expected) ==
+    (long)(intptr_t)expected;
+#  endif
+}
 
 static inline int ss_spin_init(ss_spinlock_t *lock,
                                enum SsThreadProcess pshared) {
@@ -32,12 +141,15 @@ static inline int ss_spin_destroy(ss_spinlock_t *lock) {
 static inline int ss_spin_lock(ss_spinlock_t *lock) {
   if (!_InterlockedCompareExchange(lock, 1, 0))
     return 0;
-  do {
+  uint32_t backoff = 1;
+  for (;;) {
     while (*lock) {
       ss_cpu_pause();
     }
-  } while (_InterlockedCompareExchange(lock, 1, 0));
-  return 0;
+    if (!_InterlockedCompareExchange(lock, 1, 0))
+      return 0;
+    _ss_spin_backoff(&backoff);
+  }
 }
 
 static inline int ss_spin_unlock(ss_spinlock_t *lock) {
@@ -54,6 +166,36 @@ static inline int ss_spin_unlock(ss_spinlock_t *lock) {
 
 typedef _Atomic bool ss_spinlock_t;
 
+typedef _Atomic uint32_t _ss_spin_word_t;
+typedef _Atomic(void *) _ss_spin_ptr_t;
+
+static inline uint32_t _ss_spin_load(_ss_spin_word_t *word) {
+  return atomic_load_explicit(word, memory_order_acquire);
+}
+
+static inline void _ss_spin_store(_ss_spin_word_t *word, uint32_t value) {
+  atomic_store_explicit(word, value, memory_order_release);
+}
+
+static inline uint32_t _ss_spin_fetch_add(_ss_spin_word_t *word,
+                                          uint32_t value) {
+  return atomic_fetch_add_explicit(word, value, memory_order_acq_rel);
+}
+
+static inline void *_ss_spin_ptr_load(_ss_spin_ptr_t *ptr) {
+  return atomic_load_explicit(ptr, memory_order_acquire);
+}
+
+static inline void *_ss_spin_ptr_xchg(_ss_spin_ptr_t *ptr, void *value) {
+  return atomic_exchange_explicit(ptr, value, memory_order_acq_rel);
+}
+
+static inline int _ss_spin_ptr_cas(_ss_spin_ptr_t *ptr, void *expected,
+                                   void *desired) {
+  return atomic_compare_exchange_strong_explicit(
+    ptr, &expected, desired, memory_order_acq_rel, memory_order_acquire);
+}
+
 static inline int ss_spin_init(ss_spinlock_t *lock,
                                enum SsThreadProcess pshared) {
   (void)pshared;
@@ -69,12 +211,15 @@ static inline int ss_spin_destroy(ss_spinlock_t *lock) {
 static inline int ss_spin_lock(ss_spinlock_t *lock) {
   if (!atomic_exchange_explicit(lock, true, memory_order_acquire))
     return 0;
-  do {
+  uint32_t backoff = 1;
+  for (;;) {
     while (atomic_load_explicit(lock, memory_order_relaxed)) {
       ss_cpu_pause();
     }
-  } while (atomic_exchange_explicit(lock, true, memory_order_acquire));
-  return 0;
+    if (!atomic_exchange_explicit(lock, true, memory_order_acquire))
+      return 0;
+    _ss_spin_backoff(&backoff);
+  }
 }
 
 static inline int ss_spin_unlock(ss_spinlock_t *lock) {
@@ -84,6 +229,36 @@ static inline int ss_spin_unlock(ss_spinlock_t *lock) {
 #elif defined(__GNUC__) || defined(__clang__)
 typedef volatile int ss_spinlock_t;
 
+typedef volatile uint32_t _ss_spin_word_t;
+typedef void *volatile _ss_spin_ptr_t;
+
+static inline uint32_t _ss_spin_load(_ss_spin_word_t *word) {
+  return __atomic_load_n(word, __ATOMIC_ACQUIRE);
+}
+
+static inline void _ss_spin_store(_ss_spin_word_t *word, uint32_t value) {
+  __atomic_store_n(word, value, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t _ss_spin_fetch_add(_ss_spin_word_t *word,
+                                          uint32_t value) {
+  return __atomic_fetch_add(word, value, __ATOMIC_ACQ_REL);
+}
+
+static inline void *_ss_spin_ptr_load(_ss_spin_ptr_t *ptr) {
+  return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline void *_ss_spin_ptr_xchg(_ss_spin_ptr_t *ptr, void *value) {
+  return __atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL);
+}
+
+static inline int _ss_spin_ptr_cas(_ss_spin_ptr_t *ptr, void *expected,
+                                   void *desired) {
+  return __atomic_compare_exchange_n(ptr, &expected, desired, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
 static inline int ss_spin_init(ss_spinlock_t *lock,
                                enum SsThreadProcess pshared) {
   (void)pshared;
@@ -99,12 +274,15 @@ static inline int ss_spin_destroy(ss_spinlock_t *lock) {
 static inline int ss_spin_lock(ss_spinlock_t *lock) {
   if (!__sync_lock_test_and_set(lock, 1))
     return 0;
-  do {
+  uint32_t backoff = 1;
+  for (;;) {
     while (*lock) {
       ss_cpu_pause();
     }
-  } while (__sync_lock_test_and_set(lock, 1));
-  return 0;
+    if (!__sync_lock_test_and_set(lock, 1))
+      return 0;
+    _ss_spin_backoff(&backoff);
+  }
 }
 
 static inline int ss_spin_unlock(ss_spinlock_t *lock) {
@@ -116,6 +294,118 @@ static inline int ss_spin_unlock(ss_spinlock_t *lock) {
     "Sirius Spinlock: No atomic implementation available for this compiler/standard"
 #endif
 
+// --- Ticket ---
+
+typedef struct {
+  _ss_spin_word_t next;
+  _ss_spin_word_t owner;
+} ss_spinlock_ticket_t;
+
+static inline int ss_spin_ticket_init(ss_spinlock_ticket_t *lock,
+                                      enum SsThreadProcess pshared) {
+  (void)pshared;
+  _ss_spin_store(&lock->next, 0);
+  _ss_spin_store(&lock->owner, 0);
+  return 0;
+}
+
+static inline int ss_spin_ticket_destroy(ss_spinlock_ticket_t *lock) {
+  (void)lock;
+  return 0;
+}
+
+/**
+ * @note A waiter pauses in proportion to its distance to the owner, to spare
+ * the cache line of `owner`.
+ */
+static inline int ss_spin_ticket_lock(ss_spinlock_ticket_t *lock) {
+  uint32_t ticket = _ss_spin_fetch_add(&lock->next, 1);
+  uint32_t owner, nb_pauses = 0;
+  while ((owner = _ss_spin_load(&lock->owner)) != ticket) {
+    for (uint32_t i = 1; i < ticket - owner && i < 64; ++i) {
+      ss_cpu_pause();
+    }
+    _ss_spin_wait(&nb_pauses);
+  }
+  return 0;
+}
+
+static inline int ss_spin_ticket_unlock(ss_spinlock_ticket_t *lock) {
+  /**
+   * @note Only the owner writes `owner`.
+   */
+  _ss_spin_store(&lock->owner, _ss_spin_load(&lock->owner) + 1);
+  return 0;
+}
+
+// --- MCS ---
+
+/**
+ * @brief Queue node of a locker of `ss_spinlock_mcs_t`, it must stay valid
+ * until the matching `ss_spin_mcs_unlock`.
+ */
+typedef struct {
+  _ss_spin_ptr_t next;
+  _ss_spin_word_t locked;
+} ss_spin_mcs_node_t;
+
+typedef struct {
+  _ss_spin_ptr_t tail;
+} ss_spinlock_mcs_t;
+
+/**
+ * @return 0 on success, `EINVAL` for `kSsThreadProcessShared`.
+ */
+static inline int ss_spin_mcs_init(ss_spinlock_mcs_t *lock,
+                                   enum SsThreadProcess pshared) {
+  if (pshared == kSsThreadProcessShared)
+    return EINVAL;
+  (void)_ss_spin_ptr_xchg(&lock->tail, NULL);
+  return 0;
+}
+
+static inline int ss_spin_mcs_destroy(ss_spinlock_mcs_t *lock) {
+  (void)lock;
+  return 0;
+}
+
+static inline int ss_spin_mcs_lock(ss_spinlock_mcs_t *lock,
+                                   ss_spin_mcs_node_t *node) {
+  (void)_ss_spin_ptr_xchg(&node->next, NULL);
+  _ss_spin_store(&node->locked, 1);
+
+  ss_spin_mcs_node_t *prev =
+    (ss_spin_mcs_node_t *)_ss_spin_ptr_xchg(&lock->tail, node);
+  if (!prev)
+    return 0;
+
+  (void)_ss_spin_ptr_xchg(&prev->next, node);
+  uint32_t nb_pauses = 0;
+  while (_ss_spin_load(&node->locked)) {
+    _ss_spin_wait(&nb_pauses);
+  }
+  return 0;
+}
+
+static inline int ss_spin_mcs_unlock(ss_spinlock_mcs_t *lock,
+                                     ss_spin_mcs_node_t *node) {
+  ss_spin_mcs_node_t *next =
+    (ss_spin_mcs_node_t *)_ss_spin_ptr_load(&node->next);
+  if (!next) {
+    if (_ss_spin_ptr_cas(&lock->tail, node, NULL))
+      return 0;
+    /**
+     * @note A locker swapped the tail but has not linked itself yet.
+     */
+    uint32_t nb_pauses = 0;
+    while (!(next = (ss_spin_mcs_node_t *)_ss_spin_ptr_load(&node->next))) {
+      _ss_spin_wait(&nb_pauses);
+    }
+  }
+  _ss_spin_store(&next->locked, 0);
+  return 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -165,6 +165,64 @@ enum SsThreadScope {
   kSsThreadScopeProcess = 1,
 };
 
+/**
+ * @brief Maximum number of CPUs in a `ss_cpu_set_t`.
+ */
+#define SS_CPU_SETSIZE (1024)
+
+/**
+ * @brief A set of logical CPUs, by the CPU number of the system.
+ */
+typedef struct {
+  uint64_t bits[SS_CPU_SETSIZE / 64];
+} ss_cpu_set_t;
+
+static inline void ss_cpu_set_zero(ss_cpu_set_t *set) {
+  for (size_t i = 0; i < SS_CPU_SETSIZE / 64; ++i) {
+    set->bits[i] = 0;
+  }
+}
+
+static inline void ss_cpu_set_add(ss_cpu_set_t *set, size_t cpu) {
+  if (cpu < SS_CPU_SETSIZE) {
+    set->bits[cpu / 64] |= (uint64_t)1 << (cpu % 64);
+  }
+}
+
+static inline void ss_cpu_set_del(ss_cpu_set_t *set, size_t cpu) {
+  if (cpu < SS_CPU_SETSIZE) {
+    set->bits[cpu / 64] &= ~((uint64_t)1 << (cpu % 64));
+  }
+}
+
+static inline int ss_cpu_set_has(const ss_cpu_set_t *set, size_t cpu) {
+  return cpu < SS_CPU_SETSIZE &&
+    ((set->bits[cpu / 64] >> (cpu % 64)) & (uint64_t)1);
+}
+
+static inline size_t ss_cpu_set_count(const ss_cpu_set_t *set) {
+  size_t count = 0;
+  for (size_t i = 0; i < SS_CPU_SETSIZE / 64; ++i) {
+    for (uint64_t bits = set->bits[i]; bits; bits &= bits - 1) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+enum SsThreadNuma {
+  /**
+   * @brief No NUMA placement.
+   */
+  kSsThreadNumaNone = 0,
+
+  /**
+   * @brief Run on the CPUs of `numa_node`, and prefer its memory for the
+   * allocations of the thread.
+   */
+  kSsThreadNumaPreferred = 1,
+};
+
 typedef struct {
   /**
    * @brief Detach state.
@@ -213,6 +271,27 @@ typedef struct {
    * @brief The size of the thread stack.
    */
   size_t stacksize;
+
+  /**
+   * @brief CPUs the thread is allowed to run on. If empty, no restriction.
+   *
+   * @note On Windows, only the first 64 CPUs can be used.
+   */
+  ss_cpu_set_t affinity;
+
+  /**
+   * @brief NUMA placement of the thread.
+   *
+   * @note With `kSsThreadNumaPreferred`, the CPUs of the node are intersected
+   * with `affinity` if it is not empty. The memory preference only takes
+   * effect on Linux, elsewhere the first touch does the placement.
+   */
+  enum SsThreadNuma numa_policy;
+
+  /**
+   * @brief NUMA node, only used with `kSsThreadNumaPreferred`.
+   */
+  int numa_node;
 } ss_thread_attr_t;
 
 /**
@@ -343,6 +422,160 @@ SIRIUS_API int ss_thread_setschedparam(ss_thread_t thread,
 SIRIUS_API int ss_thread_getschedparam(ss_thread_t thread,
                                        ss_thread_sched_args_t *param);
 
+/**
+ * @brief Set the CPUs the thread is allowed to run on.
+ *
+ * @param[in] thread Thread handle.
+ * @param[in] set CPU set, it must not be empty.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_thread_setaffinity(ss_thread_t thread,
+                                     const ss_cpu_set_t *set);
+
+/**
+ * @brief Get the CPUs the thread is allowed to run on.
+ *
+ * @param[in] thread Thread handle.
+ * @param[out] set CPU set.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int ss_thread_getaffinity(ss_thread_t thread, ss_cpu_set_t *set);
+
+/**
+ * @brief Placement of a logical CPU.
+ *
+ * @note The members are -1 if unknown.
+ */
+typedef struct {
+  /**
+   * @brief Index of the physical core, unique across the packages. The SMT
+   * siblings share it.
+   */
+  int core;
+
+  /**
+   * @brief Physical package (socket) id.
+   */
+  int package;
+
+  /**
+   * @brief Index of the L3 cache domain, i.e., of the CPUs sharing one L3.
+   */
+  int l3;
+
+  /**
+   * @brief NUMA node id, as used by `numa_node` of `ss_thread_attr_t`.
+   */
+  int numa_node;
+} ss_cpu_info_t;
+
+typedef struct {
+  /**
+   * @brief The online logical CPUs.
+   */
+  ss_cpu_set_t online;
+
+  size_t nb_cpus;
+  size_t nb_cores;
+  size_t nb_packages;
+  size_t nb_l3;
+  size_t nb_numa_nodes;
+
+  /**
+   * @brief Indexed by the CPU number, only the members of `online` are valid.
+   */
+  ss_cpu_info_t cpus[SS_CPU_SETSIZE];
+} ss_cpu_topology_t;
+
+/**
+ * @brief Query the CPU topology: cores, SMT siblings, L3 domains and NUMA
+ * nodes.
+ *
+ * @param[out] topology Topology, about 20 KiB.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ *
+ * @note
+ * - (1) On Linux, it is parsed from sysfs. Elsewhere, each online CPU is
+ * reported as a core of its own, on package 0, with no L3 or NUMA
+ * information.
+ *
+ * - (2) The SMT siblings of a CPU are the online CPUs with the same `core`.
+ */
+SIRIUS_API int ss_cpu_topology(ss_cpu_topology_t *topology);
+
+typedef struct {
+  /**
+   * @brief CPU time, user and system, unit: ns.
+   */
+  uint64_t cpu_time_ns;
+
+  /**
+   * @brief Context switches where the thread gave up the CPU, e.g., to block.
+   */
+  uint64_t nb_voluntary_switches;
+
+  /**
+   * @brief Context switches where the thread was preempted.
+   */
+  uint64_t nb_involuntary_switches;
+
+  /**
+   * @brief The CPU the thread ran on last, -1 if unknown.
+   */
+  int last_cpu;
+
+  /**
+   * @brief Time spent blocked in `ss_mutex_lock`, the waits of `ss_cond_t` and
+   * the waits of `ss_sem_t`, unit: ns. Only accumulated while
+   * `ss_thread_wait_accounting` is on.
+   */
+  uint64_t wait_time_ns;
+
+  /**
+   * @brief Number of the waits in `wait_time_ns`.
+   */
+  uint64_t nb_waits;
+} ss_thread_stats_t;
+
+/**
+ * @brief Get the CPU time, the context switches, the last CPU and the
+ * accounted waits of a thread.
+ *
+ * @param[in] thread Thread handle, of a thread of this process.
+ * @param[out] stats Statistics.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ *
+ * @note
+ * - (1) On Linux, the context switches and the last CPU are read from
+ * `/proc/self/task/<tid>/`. The `tid` is recorded when the thread starts
+ * from `ss_thread_create`, or on its first accounted wait, otherwise they
+ * are 0 and -1, except for the calling thread.
+ *
+ * - (2) On Windows, the context switches are not available and are 0, and
+ * the last CPU is only known for the calling thread.
+ */
+SIRIUS_API int ss_thread_stats(ss_thread_t thread, ss_thread_stats_t *stats);
+
+/**
+ * @brief Turn on or off the accounting of `wait_time_ns` and `nb_waits` of
+ * `ss_thread_stats_t`, it is off by default.
+ *
+ * @param[in] enable Non-zero to turn it on.
+ *
+ * @note
+ * - (1) Off, a wait costs one more load. On, it also reads the monotonic
+ * clock twice, and `ss_mutex_lock` tries the lock first, so that only the
+ * contended locks are accounted.
+ *
+ * - (2) The accumulated waits are kept when it is turned off, and are lost
+ * when the thread exits.
+ */
+SIRIUS_API void ss_thread_wait_accounting(int enable);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,138 @@
+/**
+ * @note
+ * - (1) Every worker owns a work-stealing deque. A task submitted by a worker
+ * goes to its own deque, a task submitted by any other thread goes to the
+ * inbox of one worker, chosen in turn. Idle workers steal from the others.
+ *
+ * - (2) Idle workers park on a futex where one is available, and a
+ * submission only pays for a wake-up when a worker is parked.
+ *
+ * - (3) Inter-process sharing is not supported.
+ */
+
+#pragma once
+
+#include "sirius/attributes.h"
+#include "sirius/inner/common.h"
+#include "sirius/macro.h"
+#include "sirius/thread/thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ss_threadpool_s ss_threadpool_t;
+
+/**
+ * @brief Task routine, it runs on one of the workers.
+ */
+typedef void (*ss_threadpool_fn_t)(void *arg);
+
+typedef struct {
+  ss_threadpool_fn_t fn;
+  void *arg;
+} ss_threadpool_task_t;
+
+typedef struct {
+  /**
+   * @brief Number of workers. If 0, one per hardware thread.
+   */
+  size_t nb_workers;
+
+  /**
+   * @brief Capacity of the deque of each worker, rounded up to a power of 2.
+   * If 0, 4096.
+   *
+   * @note A task beyond the capacity is not lost, it spills into the inbox of
+   * the worker.
+   */
+  size_t deque_capacity;
+
+  /**
+   * @brief Attributes of the worker threads, e.g., stack size and scheduling
+   * policy. If `nullptr`, the default attributes.
+   *
+   * @note `detach_state` is ignored, the workers are always joinable.
+   */
+  const ss_thread_attr_t *thread_attr;
+} ss_threadpool_args_t;
+
+/**
+ * @brief Create a thread pool, the resulting handle must be destroyed using
+ * `ss_threadpool_destroy`.
+ *
+ * @param[out] pool Thread pool handle.
+ * @param[in] args Creation parameters. If `nullptr`, the defaults.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+SIRIUS_API int
+ss_threadpool_create(ss_threadpool_t **__restrict pool,
+                     const ss_threadpool_args_t *__restrict args);
+
+/**
+ * @brief Wait for all the tasks, including the ones they submit, then stop
+ * the workers and free the pool.
+ *
+ * @param[in] pool Thread pool handle.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ *
+ * @note It must not be called from a worker of the pool, nor concurrently
+ * with a submission.
+ */
+SIRIUS_API int ss_threadpool_destroy(ss_threadpool_t *pool);
+
+/**
+ * @brief Submit a task.
+ *
+ * @param[in] pool Thread pool handle.
+ * @param[in] fn Task routine.
+ * @param[in] arg Parameters of routine.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ *
+ * @note Safe to call from any thread, including the workers of the pool.
+ */
+SIRIUS_API int ss_threadpool_submit(ss_threadpool_t *pool,
+                                    ss_threadpool_fn_t fn, void *arg);
+
+/**
+ * @brief Submit several tasks at once.
+ *
+ * @param[in] pool Thread pool handle.
+ * @param[in] tasks Tasks, the array is copied.
+ * @param[in] nb_tasks Number of tasks.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ *
+ * @note From a thread outside the pool, the batch is split evenly over the
+ * inboxes of the workers, at the cost of one lock per inbox.
+ */
+SIRIUS_API int ss_threadpool_submit_batch(ss_threadpool_t *pool,
+                                          const ss_threadpool_task_t *tasks,
+                                          size_t nb_tasks);
+
+/**
+ * @brief Wait until every submitted task has finished.
+ *
+ * @param[in] pool Thread pool handle.
+ * @param[in] milliseconds Timeout duration, unit: ms. Setting the value to
+ * `kSsTimeoutNoWaiting` means no wait, and setting it to `kSsTimeoutInfinite`
+ * means infinite wait.
+ *
+ * @return
+ * - (1) 0 on success;
+ *
+ * - (2) `ETIMEDOUT` on timeout;
+ *
+ * - (3) `EDEADLK` if called from a worker of the pool;
+ *
+ * - (4) error code otherwise.
+ */
+SIRIUS_API int ss_threadpool_wait_idle(ss_threadpool_t *pool,
+                                       uint64_t milliseconds);
+
+#ifdef __cplusplus
+}
+#endif
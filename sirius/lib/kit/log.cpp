@@ -2,10 +2,16 @@
 #include "utils/decls.h"
 /* clang-format on */
 
+#include <cctype>
+#include <deque>
+#include <thread>
+
 #include "sirius/kit/log.h"
 
 #include "lib/foundation/structor.h"
 #include "utils/log/exe.hpp"
+#include "utils/log/level.hpp"
+#include "utils/log/record.hpp"
 #include "utils/log/shm.hpp"
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -18,6 +24,58 @@ namespace u_io = utils::io;
 using ui_fmt = u_io::Fmt;
 namespace u_log = utils::log;
 
+namespace {
+/**
+ * @brief The encoder of the logs and the structured records, used when they
+ * are written natively.
+ */
+struct RecordEncoder {
+  std::atomic<int> encoder = SsLogEncoder::kSsLogEncoderHuman;
+  std::atomic<bool> ansi_enable = true;
+};
+
+inline RecordEncoder g_record_out {};
+inline RecordEncoder g_record_err {};
+
+inline RecordEncoder &native_encoder(int level) {
+  return level <= SS_LOG_LEVEL_WARN ? g_record_err : g_record_out;
+}
+
+inline void native_view_write(const RecordEncoder &re,
+                              const u_log::record::View &view) {
+  auto str = u_log::record::encode(re.encoder.load(std::memory_order_relaxed),
+                                   view,
+                                   re.ansi_enable.load(std::memory_order_relaxed));
+  u_io::Native::instance().log_write(view.level, str.c_str(), str.size());
+}
+
+inline void native_record_write(const u_log::ShmBuf &buffer) {
+  auto view = u_log::record::unpack(buffer, utils::process::pid());
+  if (!view.has_value()) [[unlikely]]
+    return;
+
+  native_view_write(native_encoder(buffer.level), view.value());
+}
+
+/**
+ * @note Encoded as a record by `kSsLogEncoderJson` and `kSsLogEncoderLogfmt`,
+ * written as it is otherwise, `kSsLogEncoderBinary` falls back to human here.
+ */
+inline void native_log_write(const u_log::ShmBuf &buffer) {
+  const RecordEncoder &re = native_encoder(buffer.level);
+  int encoder = re.encoder.load(std::memory_order_relaxed);
+  if (encoder != SsLogEncoder::kSsLogEncoderJson &&
+      encoder != SsLogEncoder::kSsLogEncoderLogfmt) {
+    u_io::Native::instance().log_write(
+      buffer.level, static_cast<const void *>(buffer.data.log.buf),
+      buffer.data.log.buf_size);
+    return;
+  }
+  native_view_write(re,
+                    u_log::record::log_view(buffer, utils::process::pid()));
+}
+} // namespace
+
 class SharedManager {
  public:
   SharedManager() = default;
@@ -87,32 +145,156 @@ class SharedManager {
     if (!shared_valid() && !spawn())
       return native_write(static_cast<u_log::ShmBuf *>(src));
 
-    uint64_t cur_write_idx = master_->get_shm_header()->write_index.fetch_add(
-      1, std::memory_order_acq_rel);
-    size_t slot_idx = cur_write_idx & (u_log::kShmCapacity - 1);
-    u_log::ShmSlot &slot = master_->get_shm_slots()[slot_idx];
+    /**
+     * @note
+     * - (1) A message longer than a slot takes several contiguous positions,
+     * claimed at once when all of their slots are free.
+     *
+     * - (2) The slots are reserved with the `pid` before they are claimed, so
+     * a claimed slot always tells the daemon whose it is, @ref
+     * `Daemon::shard_recover`.
+     */
+    const int64_t pid = utils::process::pid();
+    const size_t nb_parts =
+      UTILS_MAX(1, (size + u_log::kShmSlotDataSize - 1) /
+                     u_log::kShmSlotDataSize);
+    size_t shard = shard_index();
+    auto &shard_header = master_->get_shm_header()->shards[shard];
+    u_log::ShmSlot *slots = master_->get_shard_slots(shard);
+    auto slot_at = [&](uint64_t pos) -> u_log::ShmSlot & {
+      return slots[pos & (u_log::kShmShardCapacity - 1)];
+    };
+    auto release = [&](uint64_t base, size_t nb_reserved) {
+      for (size_t i = 0; i < nb_reserved; ++i) {
+        slot_at(base + i).pid.store(0, std::memory_order_release);
+      }
+    };
+    uint64_t pos = shard_header.write_index.load(std::memory_order_relaxed);
     int retries = 0;
-    while (slot.state.load(std::memory_order_acquire) !=
-           u_log::ShmSlotState::kFree) {
-      ++retries;
-      if (retries % 10 == 0) {
-        std::this_thread::yield();
+    uint64_t spins = 0;
+    while (true) {
+      int64_t diff = 0;
+      for (size_t i = 0; i < nb_parts && diff == 0; ++i) {
+        auto &seq = slot_at(pos + i).sequence;
+        diff = static_cast<int64_t>(seq.load(std::memory_order_acquire) -
+                                    (pos + i));
       }
-      if (retries % 40 == 0) {
-        std::this_thread::sleep_for(std::chrono::nanoseconds(100));
+      if (diff == 0) {
+        const uint64_t base = pos;
+        size_t nb_reserved = 0;
+        while (nb_reserved < nb_parts) {
+          int64_t owner = 0;
+          if (!slot_at(base + nb_reserved)
+                 .pid.compare_exchange_strong(owner, pid,
+                                              std::memory_order_acq_rel)) {
+            break;
+          }
+          ++nb_reserved;
+        }
+        if (nb_reserved == nb_parts &&
+            shard_header.write_index.compare_exchange_strong(
+              pos, base + nb_parts, std::memory_order_acq_rel)) {
+          break;
+        }
+        release(base, nb_reserved);
+        if (nb_reserved < nb_parts && ++spins % 64 == 0) {
+          std::this_thread::yield();
+        }
+        pos = shard_header.write_index.load(std::memory_order_relaxed);
+        continue;
       }
-      if (retries % 200 == 0) {
-        retries = 0;
-        (void)spawn();
+      if (diff < 0) {
+        // The ring is full, a slot of the previous lap is not consumed.
+        ++spins;
+        ++retries;
+        if (retries % 10 == 0) {
+          std::this_thread::yield();
+        }
+        if (retries % 40 == 0) {
+          std::this_thread::sleep_for(std::chrono::nanoseconds(100));
+        }
+        if (retries % 200 == 0) {
+          retries = 0;
+          (void)spawn();
+        }
       }
+      pos = shard_header.write_index.load(std::memory_order_relaxed);
+    }
+    if (spins > 0) [[unlikely]] {
+      auto &stats = master_->get_shm_header()->stats;
+      stats.producer_spins.fetch_add(spins, std::memory_order_relaxed);
+      stats.producer_stalls.fetch_add(1, std::memory_order_relaxed);
     }
 
-    slot.state.store(u_log::ShmSlotState::kWaiting, std::memory_order_release);
-    slot.timestamp_ms.store(utils::time::get_monotonic_steady_ms(),
-                            std::memory_order_relaxed);
-    slot.pid = utils::process::pid();
-    std::memcpy(&slot.buffer, src, size);
-    slot.state.store(u_log::ShmSlotState::kReady, std::memory_order_release);
+    const uint64_t timestamp_ms = utils::time::get_monotonic_steady_ms();
+    for (size_t i = 0; i < nb_parts; ++i) {
+      slot_at(pos + i).timestamp_ms.store(timestamp_ms,
+                                          std::memory_order_relaxed);
+    }
+    master_->heartbeat(timestamp_ms);
+
+    const uint64_t timestamp_ns = utils::time::get_monotonic_steady_ns();
+    auto bytes = static_cast<const char *>(src);
+    for (size_t i = 0; i < nb_parts; ++i) {
+      u_log::ShmSlot &slot = slot_at(pos + i);
+      size_t offset = i * u_log::kShmSlotDataSize;
+      slot.timestamp_ns = timestamp_ns;
+      slot.part = static_cast<uint32_t>(i);
+      slot.nb_parts = static_cast<uint32_t>(nb_parts);
+      slot.size = size;
+      std::memcpy(slot.data, bytes + offset,
+                  UTILS_MIN(u_log::kShmSlotDataSize, size - offset));
+    }
+    /**
+     * @note A slot that was published in the meantime by the `crash_flush` of
+     * another thread is not ours anymore, and the rest of the message is
+     * dropped.
+     */
+    for (size_t i = nb_parts; i-- > 0;) {
+      uint64_t seq = pos + i;
+      if (!slot_at(pos + i).sequence.compare_exchange_strong(
+            seq, pos + i + 1, std::memory_order_release,
+            std::memory_order_relaxed)) [[unlikely]] {
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief Hand the in-flight slots of this process to the daemon at once,
+   * rather than leaving them to the recovery of the daemon, and wake the
+   * daemon up.
+   *
+   * @note
+   * - (1) Async-signal-safe: neither lock nor allocation.
+   *
+   * - (2) The slots that other threads are still writing are taken as they
+   * are, their own publish then fails, @ref `produce_shared`.
+   */
+  void crash_flush() {
+    if (!initialized_.load(std::memory_order_acquire) || !master_)
+      return;
+
+    const int64_t pid = utils::process::pid();
+    for (size_t i = 0; i < u_log::kShmNbShards; ++i) {
+      auto &shard = master_->get_shm_header()->shards[i];
+      u_log::ShmSlot *slots = master_->get_shard_slots(i);
+      uint64_t pos = shard.read_index.load(std::memory_order_acquire);
+      uint64_t end = shard.write_index.load(std::memory_order_acquire);
+      for (; pos < end; ++pos) {
+        u_log::ShmSlot &slot = slots[pos & (u_log::kShmShardCapacity - 1)];
+        uint64_t seq = pos;
+        if (slot.sequence.load(std::memory_order_acquire) != seq ||
+            slot.pid.load(std::memory_order_relaxed) != pid) {
+          continue;
+        }
+        slot.timestamp_ns =
+          slot.timestamp_ms.load(std::memory_order_relaxed) * 1000 * 1000;
+        (void)slot.sequence.compare_exchange_strong(seq, pos + 1,
+                                                    std::memory_order_acq_rel);
+      }
+    }
+    master_->consumer_wake();
   }
 
   bool shared_valid() const {
@@ -122,14 +304,27 @@ class SharedManager {
   }
 
   auto fs_configure(u_io::PutType put_type, const std::filesystem::path &path,
-                    int flags, int mode, bool ansi_disable)
+                    int flags, int mode, bool ansi_disable, int encoder,
+                    bool dedup)
     -> std::expected<void, UTrace> {
     if (!shared_valid())
       return std::unexpected(UTrace("Uninitialized"));
 
+    /**
+     * @note The daemon only opens absolute paths, the relative ones are
+     * resolved against the working directory of this process.
+     */
+    std::filesystem::path abs_path;
     size_t path_size = 0;
     if (!path.empty()) {
-      path_size = utils_strnlen_s(path.string().c_str(), u_log::kLogPathMax);
+      std::error_code ec;
+      abs_path = std::filesystem::absolute(path, ec).lexically_normal();
+      if (ec) {
+        return std::unexpected(UTrace(
+          std::format("Invalid argument. `path`: {0}", ec.message())));
+      }
+      path_size =
+        utils_strnlen_s(abs_path.string().c_str(), u_log::kLogPathMax);
       if (path_size <= 0 || path_size >= u_log::kLogPathMax) {
         return std::unexpected(UTrace("Invalid argument. `path`"));
       }
@@ -141,7 +336,7 @@ class SharedManager {
     buffer.level =
       put_type == u_io::PutType::kOut ? SS_LOG_LEVEL_DEBUG : SS_LOG_LEVEL_ERROR;
     if (path_size > 0) {
-      std::memcpy(data.path, path.string().c_str(), path_size);
+      std::memcpy(data.path, abs_path.string().c_str(), path_size);
       data.type = u_log::ShmBufDataFsType::kFile;
       data.path[path_size] = '\0';
       path_size += 1;
@@ -151,17 +346,22 @@ class SharedManager {
     } else {
       data.type = u_log::ShmBufDataFsType::kStd;
     }
+    data.encoder = encoder;
+    data.dedup = static_cast<int>(dedup);
 
-    produce_shared(&buffer,
-                   sizeof(u_log::ShmBuf) - u_log::kLogPathMax + path_size);
+    /**
+     * @note The fields behind the `path` are required, so the whole `fs` is
+     * copied. This is a rare operation.
+     */
+    produce_shared(&buffer, offsetof(u_log::ShmBuf, data) + sizeof(data));
     return {};
   }
 
-  void native_write(u_log::ShmBuf *buffer) {
+  static void native_write(u_log::ShmBuf *buffer) {
     if (buffer->type == u_log::ShmBufDataType::kLog) {
-      u_io::Native::instance().log_write(
-        buffer->level, static_cast<void *>(buffer->data.log.buf),
-        buffer->data.log.buf_size);
+      native_log_write(*buffer);
+    } else if (buffer->type == u_log::ShmBufDataType::kRecord) {
+      native_record_write(*buffer);
     }
   }
 
@@ -172,6 +372,21 @@ class SharedManager {
   u_log::Shm &log_shm_ = u_log::Shm::instance();
   std::unique_ptr<u_log::Shm::Master> master_ {};
 
+  /**
+   * @brief The shard of the CPU of the calling thread, so that the producers
+   * on different CPUs do not contend on one `write_index`.
+   */
+  static size_t shard_index() {
+    if constexpr (u_log::kShmNbShards == 1) {
+      return 0;
+    } else {
+      int64_t cpu = utils::thread::get_cpu_impl();
+      uint64_t key = cpu >= 0 ? static_cast<uint64_t>(cpu)
+                              : utils::thread::get_tid_impl();
+      return static_cast<size_t>(key & (u_log::kShmNbShards - 1));
+    }
+  }
+
   /**
    * @note
    * - (1) The `spawn_daemon` function is process-safe, but it is recommended
@@ -354,25 +569,31 @@ class SharedManager {
   }
 #endif
 
+  /**
+   * @note Woken up by `Shm::Master::daemon_ready_store`, rather than polling.
+   */
   auto wait_for_daemon() -> std::expected<void, UTrace> {
     auto header = master_->get_shm_header();
 
-    int retries = 0;
-    constexpr uint64_t kOnceSleepMs = 50;
-    constexpr int kRetryTimes = kWaitDaemonTimeoutMs / kOnceSleepMs;
-    while (!header->is_daemon_ready.load(std::memory_order_relaxed)) {
-      if (retries++ > kRetryTimes) {
+    constexpr uint64_t kOnceWaitMs = kWaitDaemonTimeoutMs / 5;
+    const uint64_t begin_ms = utils::time::get_monotonic_steady_ms();
+    while (true) {
+      uint32_t wake = header->daemon_ready_wake.load(std::memory_order_acquire);
+      if (header->is_daemon_ready.load(std::memory_order_relaxed))
+        return {};
+
+      uint64_t elapsed_ms = utils::time::get_monotonic_steady_ms() - begin_ms;
+      if (elapsed_ms >= kWaitDaemonTimeoutMs) {
         return std::unexpected(UTrace("No daemon was found"));
       }
-      if (retries % (kRetryTimes / 5) == 0) {
-        logln_infosp(
-          "\nTrying to acquire daemon. "
-          "Total attempts: {0}; Attempted times: {1}",
-          kRetryTimes, retries);
+      if (utils::futex::wait_shared(&header->daemon_ready_wake, wake,
+                                    UTILS_MIN(kOnceWaitMs,
+                                              kWaitDaemonTimeoutMs -
+                                                elapsed_ms)) == ETIMEDOUT) {
+        logln_infosp("\nTrying to acquire daemon. Elapsed: {0} ms",
+                     utils::time::get_monotonic_steady_ms() - begin_ms);
       }
-      std::this_thread::sleep_for(std::chrono::milliseconds(kOnceSleepMs));
     }
-    return {};
   }
 };
 
@@ -389,6 +610,68 @@ inline void g_shared_log_manager_deinit(void) {
   g_shared_manager->deinit();
 }
 
+/**
+ * @brief The messages logged while `ss_log_init_async` is in progress.
+ */
+class EarlyBuffer {
+ public:
+  static constexpr size_t kMessagesMax = 1024;
+
+  std::atomic<bool> active = false;
+
+  /**
+   * @return false if the buffer is not active, the caller writes the message
+   * by itself.
+   */
+  bool push(const u_log::ShmBuf &buffer, size_t size) {
+    auto lock = std::lock_guard(mutex_);
+    if (!active.load(std::memory_order_relaxed))
+      return false;
+    if (messages_.size() >= kMessagesMax) {
+      ++nb_dropped_;
+      return true;
+    }
+    auto src = reinterpret_cast<const char *>(&buffer);
+    messages_.emplace_back(src, src + size);
+    return true;
+  }
+
+  /**
+   * @brief Hand over the messages in order, then deactivate the buffer.
+   */
+  void drain(const std::function<void(u_log::ShmBuf *, size_t)> &fn) {
+    auto buffer = std::make_unique<u_log::ShmBuf>();
+    while (true) {
+      std::deque<std::vector<char>> messages;
+      {
+        auto lock = std::lock_guard(mutex_);
+        if (messages_.empty()) {
+          active.store(false, std::memory_order_release);
+          break;
+        }
+        messages.swap(messages_);
+      }
+      for (const auto &message : messages) {
+        std::memcpy(buffer.get(), message.data(), message.size());
+        fn(buffer.get(), message.size());
+      }
+    }
+
+    if (nb_dropped_ > 0) {
+      logln_warnsp("{0} early messages were dropped", nb_dropped_);
+    }
+  }
+
+ private:
+  std::mutex mutex_ {};
+  std::deque<std::vector<char>> messages_ {};
+  uint64_t nb_dropped_ = 0;
+};
+
+inline EarlyBuffer g_early_buffer {};
+inline std::atomic<bool> g_async_init_started = false;
+static std::jthread g_async_init_thread {};
+
 inline bool shared_initialization_check() {
   if (g_shared_initialized.load(std::memory_order_relaxed))
     return true;
@@ -483,16 +766,23 @@ class IoManager {
       to_shared_state = true;
       fn_configure = [&](u_io::PutType pt, const std::filesystem::path &p,
                          int f, int m) {
-        return g_shared_manager->fs_configure(pt, p, f, m, config.ansi_disable)
+        return g_shared_manager
+          ->fs_configure(pt, p, f, m, config.ansi_disable, config.encoder,
+                         config.dedup)
           .utrace_transform_error_default();
       };
     }
 
     auto &to_shared =
       put_type == u_io::PutType::kOut ? out_to_shared : err_to_shared;
+    auto &record =
+      put_type == u_io::PutType::kOut ? g_record_out : g_record_err;
     return fn_configure(put_type, path, config.flags, config.mode)
       .and_then([&]() -> std::expected<void, UTrace> {
         to_shared.store(to_shared_state, std::memory_order_relaxed);
+        record.encoder.store(config.encoder, std::memory_order_relaxed);
+        record.ansi_enable.store(!path.empty() ? false : !config.ansi_disable,
+                                 std::memory_order_relaxed);
         return {};
       })
       .utrace_transform_error_default();
@@ -514,21 +804,90 @@ inline void error_log_truncated() {
   logln_warnsp("\nLog length exceeds the buffer, log will be truncated");
 }
 
-inline void log_write(u_log::ShmBuf &buffer, size_t data_len) {
+/**
+ * @brief The last debug messages of a thread, @ref `ss_log_flight_recorder`.
+ */
+class FlightRecorder {
+ public:
+  static constexpr int kDepthMax = 4096;
+
+  void push(const u_log::ShmBuf &buffer, size_t size, size_t depth) {
+    if (messages_.size() != depth) {
+      messages_.assign(depth, {});
+      next_ = 0;
+      count_ = 0;
+    }
+    auto src = reinterpret_cast<const char *>(&buffer);
+    messages_[next_].assign(src, src + size);
+    next_ = (next_ + 1) % depth;
+    count_ = UTILS_MIN(count_ + 1, depth);
+  }
+
+  /**
+   * @brief Hand over the recorded messages from the oldest, then forget them.
+   */
+  void drain(const std::function<void(u_log::ShmBuf &, size_t)> &fn) {
+    if (count_ == 0)
+      return;
+
+    auto buffer = std::make_unique<u_log::ShmBuf>();
+    const size_t depth = messages_.size();
+    for (size_t i = 0; i < count_; ++i) {
+      const auto &message = messages_[(next_ + depth - count_ + i) % depth];
+      std::memcpy(buffer.get(), message.data(), message.size());
+      fn(*buffer, message.size());
+    }
+    count_ = 0;
+  }
+
+ private:
+  std::vector<std::vector<char>> messages_ {};
+  size_t next_ = 0;
+  size_t count_ = 0;
+};
+
+/**
+ * @note Accessed by `std::atomic_ref`.
+ */
+alignas(std::atomic_ref<int>::required_alignment) inline int g_flight_depth = 0;
+thread_local FlightRecorder g_flight_recorder {};
+
+/**
+ * @param[in] size The number of bytes of `buffer` to be transferred.
+ */
+inline void log_dispatch(u_log::ShmBuf &buffer, size_t size) {
   auto &fs_to_shared = buffer.level <= SS_LOG_LEVEL_WARN
     ? g_io_manager.err_to_shared
     : g_io_manager.out_to_shared;
-  bool to_shared = fs_to_shared.load(std::memory_order_relaxed) &&
-    shared_initialization_check();
+  bool to_shared = fs_to_shared.load(std::memory_order_relaxed);
+  if (to_shared && g_early_buffer.active.load(std::memory_order_acquire) &&
+      g_early_buffer.push(buffer, size)) {
+    return;
+  }
+  to_shared = to_shared && shared_initialization_check();
 
   if (to_shared) {
-    g_shared_manager->produce_shared(
-      &buffer, sizeof(u_log::ShmBuf) - u_log::kLogBufferSize + data_len);
+    g_shared_manager->produce_shared(&buffer, size);
   } else {
-    g_shared_manager->native_write(&buffer);
+    SharedManager::native_write(&buffer);
   }
 }
 
+inline void log_write(u_log::ShmBuf &buffer, size_t size) {
+  int depth =
+    std::atomic_ref<int>(g_flight_depth).load(std::memory_order_relaxed);
+  if (depth > 0) [[unlikely]] {
+    if (buffer.level == SS_LOG_LEVEL_DEBUG) {
+      g_flight_recorder.push(buffer, size, static_cast<size_t>(depth));
+      return;
+    }
+    if (buffer.level == SS_LOG_LEVEL_ERROR) {
+      g_flight_recorder.drain(log_dispatch);
+    }
+  }
+  log_dispatch(buffer, size);
+}
+
 inline void level_prefix(int level, std::string &usr_prefix, const char *module,
                          const char *file, int line) {
   switch (level) {
@@ -550,6 +909,24 @@ inline void level_prefix(int level, std::string &usr_prefix, const char *module,
   }
 }
 
+/**
+ * @brief Fill the fields of a `kLog` that only the binary archive needs, and
+ * put the module behind the text if it fits.
+ *
+ * @return The number of bytes of `buffer` to be copied into a slot.
+ */
+inline size_t log_pack_meta(u_log::ShmBuf &buffer, const char *module) {
+  auto &data = buffer.data.log;
+  std::string_view sv = module ? module : "";
+  data.timestamp_ms = u_log::record::realtime_ms();
+  data.tid = utils::thread::get_tid_impl();
+  data.module_size =
+    data.buf_size + sv.size() <= u_log::kLogBufferSize ? sv.size() : 0;
+  std::memcpy(data.buf + data.buf_size, sv.data(), data.module_size);
+  return sizeof(u_log::ShmBuf) - u_log::kLogBufferSize + data.buf_size +
+    data.module_size;
+}
+
 inline size_t count_trailing_new_lines(std::string_view str) {
   size_t count = 0;
   for (auto it = str.rbegin(); it != str.rend(); ++it) {
@@ -561,6 +938,180 @@ inline size_t count_trailing_new_lines(std::string_view str) {
   }
   return count;
 }
+
+/**
+ * @brief The storage of a log call, kept off the stack: the text of a
+ * printf-style log is formatted into `text`, then copied into `buffer`.
+ */
+struct LogScratch {
+  u_log::ShmBuf buffer;
+  char text[u_log::kLogBufferSize];
+  bool busy = false;
+};
+
+/**
+ * @brief The storage of the calling thread, reused by its log calls.
+ *
+ * @note A nested log call on the same thread, e.g. from a signal handler,
+ * spills onto a storage of its own on the heap.
+ */
+class Scratch {
+ public:
+  Scratch() {
+    thread_local std::unique_ptr<LogScratch> tls_scratch {};
+    if (!tls_scratch) [[unlikely]] {
+      tls_scratch.reset(new (std::nothrow) LogScratch());
+    }
+    if (tls_scratch && !tls_scratch->busy) [[likely]] {
+      scratch_ = tls_scratch.get();
+    } else {
+      spill_.reset(new (std::nothrow) LogScratch());
+      scratch_ = spill_.get();
+    }
+    if (scratch_) {
+      scratch_->busy = true;
+    }
+  }
+
+  ~Scratch() {
+    if (scratch_) {
+      scratch_->busy = false;
+    }
+  }
+
+  Scratch(const Scratch &) = delete;
+  Scratch &operator=(const Scratch &) = delete;
+
+  /**
+   * @return `nullptr` if out of memory.
+   */
+  LogScratch *get() { return scratch_; }
+
+ private:
+  LogScratch *scratch_ = nullptr;
+  std::unique_ptr<LogScratch> spill_ {};
+};
+
+/**
+ * @brief Copy the lines of `text` behind `size` bytes of `dst`, each marked by
+ * " > ", as many as fit into `dst_max - 1` bytes. A line that does not fit is
+ * left for the next log, unless it is the first one, which is split.
+ *
+ * @return The size of `dst`, `text` keeps the lines left.
+ *
+ * @note The same layout as `Fmt::row_gs`, without the temporary strings.
+ */
+inline size_t log_rows(char *dst, size_t size, size_t dst_max,
+                       std::string_view &text) {
+  constexpr std::string_view kRowPrefix = " > ";
+  const size_t rows_begin = size;
+  auto append = [&](std::string_view sv) {
+    std::memcpy(dst + size, sv.data(), sv.size());
+    size += sv.size();
+  };
+  while (!text.empty()) {
+    size_t end = text.find('\n');
+    std::string_view row = text.substr(0, end);
+    size_t used = size + kRowPrefix.size() + 1;
+    if (used > dst_max - 1 || row.size() > dst_max - 1 - used) {
+      if (size > rows_begin)
+        break;
+      row = row.substr(0, dst_max - 1 - used);
+    }
+
+    append(kRowPrefix);
+    append(row);
+    if (row.size() < text.size() && row.size() == end) {
+      text.remove_prefix(end + 1);
+    } else {
+      text.remove_prefix(row.size());
+    }
+    if (!text.empty()) {
+      append("\n");
+    }
+  }
+  return size;
+}
+
+/**
+ * @note
+ * - (1) A text longer than a log is written as several logs in a row, split
+ * at the lines where possible, each with the prefix. Room is kept behind the
+ * rows for the module.
+ *
+ * - (2) The text is formatted into the storage of the thread, or onto the
+ * heap if it is longer.
+ */
+inline void log_vimpl(int level, const char *module, const char *file,
+                      int line, const char *fmt, va_list args) {
+  constexpr size_t kRowsMin = 8;
+  Scratch scratch;
+  LogScratch *storage = scratch.get();
+  if (!storage) [[unlikely]]
+    return error_log_lost();
+
+  u_log::ShmBuf &buffer = storage->buffer;
+  auto &data = buffer.data.log;
+  buffer.type = u_log::ShmBufDataType::kLog;
+  buffer.level = level;
+
+  std::string usr_prefix;
+  usr_prefix.reserve(ui_fmt::kPrefixLength + 16);
+  level_prefix(level, usr_prefix, module, file, line);
+  size_t usr_prefix_size = strlen(usr_prefix.c_str());
+  if (usr_prefix_size + kRowsMin >= u_log::kLogBufferSize) [[unlikely]]
+    return error_log_lost();
+  size_t module_size = module ? strlen(module) : 0;
+  size_t rows_max =
+    usr_prefix_size + kRowsMin + module_size < u_log::kLogBufferSize
+    ? u_log::kLogBufferSize - module_size
+    : u_log::kLogBufferSize;
+
+  /**
+   * @ref https://linux.die.net/man/3/vsnprintf
+   */
+  va_list args_copy;
+  va_copy(args_copy, args);
+  int ret = vsnprintf(storage->text, u_log::kLogBufferSize, fmt, args);
+  if (ret < 0) [[unlikely]] {
+    va_end(args_copy);
+    return error_lib_func("vsnprintf");
+  }
+  size_t text_size = static_cast<size_t>(ret);
+  std::string_view text(storage->text,
+                        UTILS_MIN(text_size, u_log::kLogBufferSize - 1));
+  std::string text_long;
+  if (text_size >= u_log::kLogBufferSize) [[unlikely]] {
+    try {
+      text_long.resize(text_size + 1);
+      (void)vsnprintf(text_long.data(), text_size + 1, fmt, args_copy);
+      text = std::string_view(text_long.data(), text_size);
+    } catch (...) {
+      error_log_truncated();
+    }
+  }
+  va_end(args_copy);
+
+  size_t nb_new_lines = count_trailing_new_lines(text);
+  while (!text.empty() &&
+         (std::isspace(static_cast<unsigned char>(text.back())) ||
+          text.back() == '\0')) {
+    text.remove_suffix(1);
+  }
+
+  std::memcpy(data.buf, usr_prefix.c_str(), usr_prefix_size);
+  data.prefix_size = usr_prefix_size;
+  do {
+    size_t size = log_rows(data.buf, usr_prefix_size, rows_max, text);
+    if (text.empty()) {
+      size_t nb = UTILS_MIN(nb_new_lines, rows_max - 1 - size);
+      std::memset(data.buf + size, '\n', nb);
+      size += nb;
+    }
+    data.buf_size = size;
+    log_write(buffer, log_pack_meta(buffer, module));
+  } while (!text.empty());
+}
 } // namespace
 } // namespace sirius
 
@@ -574,6 +1125,135 @@ extern "C" SIRIUS_API int ss_log_set_exe_path(const char *path) {
   return u_log::exe::Exe::instance().set_path(path);
 }
 
+extern "C" SIRIUS_API int ss_log_set_level(const char *module, int level) {
+  return u_log::Level::instance().set(module ? module : "", level);
+}
+
+extern "C" SIRIUS_API int ss_log_get_level(const char *module) {
+  return u_log::Level::instance().get(module ? module : "");
+}
+
+extern "C" SIRIUS_API int ss_log_level_bind(const char *module, int *word) {
+  if (!word) [[unlikely]]
+    return SS_LOG_LEVEL_NONE;
+  return u_log::Level::instance().bind(module ? module : "", word);
+}
+
+extern "C" SIRIUS_API int64_t ss_log_ratelimit(ss_log_ratelimit_t *rl,
+                                               uint32_t interval_ms,
+                                               uint32_t burst) {
+  if (!rl) [[unlikely]]
+    return 0;
+
+  auto begin_ms = std::atomic_ref<uint64_t>(rl->begin_ms);
+  auto count = std::atomic_ref<uint32_t>(rl->count);
+  auto missed = std::atomic_ref<uint32_t>(rl->missed);
+
+  int64_t nb_missed = 0;
+  uint64_t now = utils::time::get_monotonic_steady_ms();
+  uint64_t begin = begin_ms.load(std::memory_order_relaxed);
+  if (now - begin >= interval_ms &&
+      begin_ms.compare_exchange_strong(begin, now, std::memory_order_relaxed)) {
+    /**
+     * @note Only the winner of the CAS opens the new interval. Concurrent
+     * callers of the same interval may be counted in either of the two, which
+     * is acceptable for a rate limiter.
+     */
+    count.store(0, std::memory_order_relaxed);
+    nb_missed = missed.exchange(0, std::memory_order_relaxed);
+  }
+
+  if (count.fetch_add(1, std::memory_order_relaxed) < burst)
+    return nb_missed;
+
+  missed.fetch_add(1, std::memory_order_relaxed);
+  return -1;
+}
+
+extern "C" SIRIUS_API int ss_log_once(int *flag) {
+  if (!flag) [[unlikely]]
+    return 0;
+  return std::atomic_ref<int>(*flag).exchange(1, std::memory_order_relaxed) ==
+    0;
+}
+
+extern "C" SIRIUS_API int ss_log_sample_every(ss_log_sample_t *sample,
+                                              uint32_t n) {
+  if (!sample) [[unlikely]]
+    return 0;
+  if (n <= 1)
+    return 1;
+  return std::atomic_ref<uint64_t>(sample->count)
+           .fetch_add(1, std::memory_order_relaxed) %
+      n ==
+    0;
+}
+
+extern "C" SIRIUS_API int ss_log_sample_chance(double probability) {
+  if (!(probability > 0.0))
+    return 0;
+  if (probability >= 1.0)
+    return 1;
+
+  /**
+   * @note splitmix64, seeded per thread.
+   */
+  thread_local uint64_t state =
+    utils::thread::get_tid_impl() ^ utils::time::get_monotonic_steady_ns();
+  uint64_t x = (state += 0x9E3779B97F4A7C15ull);
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  x ^= x >> 31;
+  return static_cast<double>(x >> 11) * 0x1.0p-53 < probability;
+}
+
+extern "C" SIRIUS_API int ss_log_flight_recorder(uint32_t depth) {
+  if (depth > FlightRecorder::kDepthMax)
+    return EINVAL;
+  std::atomic_ref<int>(g_flight_depth)
+    .store(static_cast<int>(depth), std::memory_order_relaxed);
+  u_log::Level::instance().flight(depth > 0);
+  return 0;
+}
+
+extern "C" SIRIUS_API int ss_log_init_async(void) {
+  if (g_shared_initialized.load(std::memory_order_relaxed) ||
+      g_async_init_started.exchange(true, std::memory_order_acq_rel)) {
+    return 0;
+  }
+
+  g_early_buffer.active.store(true, std::memory_order_release);
+  auto fn_init = []() {
+    bool initialized = shared_initialization_check();
+    g_early_buffer.drain([initialized](u_log::ShmBuf *buffer, size_t size) {
+      if (initialized) {
+        g_shared_manager->produce_shared(buffer, size);
+      } else {
+        SharedManager::native_write(buffer);
+      }
+    });
+  };
+
+  try {
+    g_async_init_thread = std::jthread(fn_init);
+  } catch (const std::system_error &e) {
+    logln_error("{0}", e.what());
+    fn_init();
+    return e.code().value();
+  }
+  return 0;
+}
+
+extern "C" SIRIUS_API void ss_log_crash_flush(void) {
+  /**
+   * @note The manager is published after `g_shared_initialized`, so test the
+   * pointer itself.
+   */
+  if (SharedManager *manager = g_shared_manager.get(); manager) {
+    manager->crash_flush();
+  }
+}
+
 extern "C" SIRIUS_API void ss_log_configure(const ss_log_config_t *config) {
   if (!config)
     return;
@@ -591,92 +1271,64 @@ extern "C" SIRIUS_API void ss_log_configure(const ss_log_config_t *config) {
 extern "C" SIRIUS_API void ss_log_impl(int level, const char *module,
                                        const char *file, int line,
                                        const char *fmt, ...) {
-  u_log::ShmBuf buffer {};
-  auto &data = buffer.data.log;
-  buffer.type = u_log::ShmBufDataType::kLog;
-  buffer.level = level;
-
-  std::string usr_prefix;
-  size_t usr_prefix_size = 0;
-  usr_prefix.reserve(ui_fmt::kPrefixLength + 16);
-  level_prefix(level, usr_prefix, module, file, line);
-  usr_prefix_size = strlen(usr_prefix.c_str());
-  if (usr_prefix_size >= u_log::kLogBufferSize) [[unlikely]]
-    return error_log_lost();
-
-  char usr_vdata[u_log::kLogBufferSize];
-  size_t usr_vdata_size = 0;
-  size_t usr_vdata_max = u_log::kLogBufferSize - usr_prefix_size;
-
-  /**
-   * @ref https://linux.die.net/man/3/vsnprintf
-   */
   va_list args;
   va_start(args, fmt);
-  usr_vdata_size = vsnprintf(usr_vdata, usr_vdata_max, fmt, args);
+  log_vimpl(level, module, file, line, fmt, args);
   va_end(args);
-  if (usr_vdata_size < 0) [[unlikely]] {
-    return error_lib_func("vsnprintf");
-  }
-
-  std::string usr_data;
-  usr_data.reserve(usr_vdata_size + 32);
-  usr_data = ui_fmt::row_gs("{0}", usr_vdata)
-               .append(count_trailing_new_lines(usr_vdata), '\n');
-  size_t usr_data_size = strlen(usr_data.c_str());
-  if (usr_data_size >= usr_vdata_max) [[unlikely]] {
-    usr_data_size = usr_vdata_max - 1;
-    error_log_truncated();
-  }
-
-  data.buf_size = usr_prefix_size + usr_data_size;
-  std::memcpy(data.buf, usr_prefix.c_str(), usr_prefix_size);
-  std::memcpy(data.buf + usr_prefix_size, usr_data.c_str(), usr_data_size);
-  log_write(buffer, data.buf_size);
 }
 
 extern "C" SIRIUS_API void ss_logsp_impl(int level, const char *module,
                                          const char *fmt, ...) {
-  u_log::ShmBuf buffer {};
-  auto &data = buffer.data.log;
-  buffer.type = u_log::ShmBufDataType::kLog;
-  buffer.level = level;
-
-  std::string usr_prefix;
-  size_t usr_prefix_size = 0;
-  usr_prefix.reserve(ui_fmt::kPrefixLength + 16);
-  level_prefix(level, usr_prefix, module, "", 0);
-  usr_prefix_size = strlen(usr_prefix.c_str());
-  if (usr_prefix_size >= u_log::kLogBufferSize) [[unlikely]]
-    return error_log_lost();
-
-  char usr_vdata[u_log::kLogBufferSize];
-  size_t usr_vdata_size = 0;
-  size_t usr_vdata_max = u_log::kLogBufferSize - usr_prefix_size;
-
-  /**
-   * @ref https://linux.die.net/man/3/vsnprintf
-   */
   va_list args;
   va_start(args, fmt);
-  usr_vdata_size = vsnprintf(usr_vdata, usr_vdata_max, fmt, args);
+  log_vimpl(level, module, "", 0, fmt, args);
   va_end(args);
-  if (usr_vdata_size < 0) [[unlikely]] {
-    return error_lib_func("vsnprintf");
+}
+
+extern "C" SIRIUS_API void ss_log_kv_impl(int level, const char *module,
+                                          const char *file, int line,
+                                          const char *msg, size_t nb_kvs,
+                                          const ss_log_kv_t *kvs) {
+  if (nb_kvs > 0 && !kvs) [[unlikely]] {
+    logln_error("Invalid argument. `kvs`");
+    return;
   }
 
-  std::string usr_data;
-  usr_data.reserve(usr_vdata_size + 32);
-  usr_data = ui_fmt::row_gs("{0}", usr_vdata)
-               .append(count_trailing_new_lines(usr_vdata), '\n');
-  size_t usr_data_size = strlen(usr_data.c_str());
-  if (usr_data_size >= usr_vdata_max) [[unlikely]] {
-    usr_data_size = usr_vdata_max - 1;
-    error_log_truncated();
+  Scratch scratch;
+  if (!scratch.get()) [[unlikely]]
+    return error_log_lost();
+  u_log::ShmBuf &buffer = scratch.get()->buffer;
+  if (!u_log::record::pack(buffer, level, module ? module : "",
+                           file ? file : "", line, msg ? msg : "", nb_kvs,
+                           kvs)) [[unlikely]] {
+    return error_log_lost();
   }
+  log_write(buffer, u_log::record::packed_size(buffer));
+}
 
-  data.buf_size = usr_prefix_size + usr_data_size;
-  std::memcpy(data.buf, usr_prefix.c_str(), usr_prefix_size);
-  std::memcpy(data.buf + usr_prefix_size, usr_data.c_str(), usr_data_size);
-  log_write(buffer, data.buf_size);
+extern "C" SIRIUS_API int ss_log_write_raw(int level, const void *buf,
+                                           size_t len) {
+  if ((!buf && len > 0) || level < SS_LOG_LEVEL_ERROR ||
+      level > SS_LOG_LEVEL_DEBUG) [[unlikely]] {
+    return EINVAL;
+  }
+
+  Scratch scratch;
+  if (!scratch.get()) [[unlikely]]
+    return ENOMEM;
+  u_log::ShmBuf &buffer = scratch.get()->buffer;
+  auto &data = buffer.data.log;
+  buffer.type = u_log::ShmBufDataType::kLog;
+  buffer.level = level;
+  data.prefix_size = 0;
+
+  auto src = static_cast<const char *>(buf);
+  while (len > 0) {
+    data.buf_size = UTILS_MIN(len, u_log::kLogBufferSize);
+    std::memcpy(data.buf, src, data.buf_size);
+    log_write(buffer, log_pack_meta(buffer, nullptr));
+    src += data.buf_size;
+    len -= data.buf_size;
+  }
+  return 0;
 }
@@ -157,11 +157,15 @@ SIRIUS_API int ss_queue_free(ss_queue_t *queue) {
           ret = ss_cond_wait_impl(&cond, &que->mutex); \
         } \
         break; \
-      default: \
-        ret = ss_cond_timedwait_impl(&cond, &que->mutex, milliseconds); \
-        ret = !ret && wait_nr == que->elem_count ? ETIMEDOUT : ret; \
+      default: { \
+        uint64_t deadline_ns = ss_clock_deadline_ns(milliseconds); \
+        while (!ret && wait_nr == que->elem_count) { \
+          ret = ss_cond_wait_until_impl(&cond, &que->mutex, deadline_ns); \
+        } \
+        ret = ret == ETIMEDOUT && wait_nr != que->elem_count ? 0 : ret; \
         break; \
       } \
+      } \
     } \
   }
 
@@ -4,6 +4,8 @@
 
 #include "lib/thread/cond.h"
 
+#include "lib/thread/inner/stats.h"
+
 SIRIUS_API int ss_cond_init(ss_cond_t *__restrict cond,
                             const enum SsThreadProcess *__restrict type) {
   return ss_cond_init_impl(cond, type);
@@ -15,13 +17,27 @@ SIRIUS_API int ss_cond_destroy(ss_cond_t *cond) {
 
 SIRIUS_API int ss_cond_wait(ss_cond_t *__restrict cond,
                             ss_mutex_t *__restrict mutex) {
-  return ss_cond_wait_impl(cond, mutex);
+  int ret;
+  SS_THREAD_WAIT_ACCOUNT(ret, ss_cond_wait_impl(cond, mutex));
+  return ret;
 }
 
 SIRIUS_API int ss_cond_timedwait(ss_cond_t *__restrict cond,
                                  ss_mutex_t *__restrict mutex,
                                  uint64_t milliseconds) {
-  return ss_cond_timedwait_impl(cond, mutex, milliseconds);
+  int ret;
+  SS_THREAD_WAIT_ACCOUNT(ret,
+                         ss_cond_timedwait_impl(cond, mutex, milliseconds));
+  return ret;
+}
+
+SIRIUS_API int ss_cond_wait_until(ss_cond_t *__restrict cond,
+                                  ss_mutex_t *__restrict mutex,
+                                  uint64_t deadline_ns) {
+  int ret;
+  SS_THREAD_WAIT_ACCOUNT(ret,
+                         ss_cond_wait_until_impl(cond, mutex, deadline_ns));
+  return ret;
 }
 
 SIRIUS_API int ss_cond_signal(ss_cond_t *cond) {
@@ -3,6 +3,7 @@
 #include "utils/decls.h"
 /* clang-format on */
 
+#include "lib/thread/inner/clock.h"
 #include "lib/thread/inner/mutex.h"
 #include "sirius/thread/cond.h"
 #include "utils/errno.h"
@@ -100,6 +101,15 @@ static inline int ss_cond_timedwait_impl(ss_cond_t *__restrict cond,
 #  undef E
 }
 
+static inline int ss_cond_wait_until_impl(ss_cond_t *__restrict cond,
+                                          ss_mutex_t *__restrict mutex,
+                                          uint64_t deadline_ns) {
+  uint64_t milliseconds = ss_clock_remaining_ms(deadline_ns);
+  if (milliseconds == 0)
+    return ETIMEDOUT;
+  return ss_cond_timedwait_impl(cond, mutex, milliseconds);
+}
+
 static inline int ss_cond_signal_impl(ss_cond_t *cond) {
   WakeConditionVariable((CONDITION_VARIABLE *)cond);
   return 0;
@@ -110,16 +120,21 @@ static inline int ss_cond_broadcast_impl(ss_cond_t *cond) {
   return 0;
 }
 #else
+/**
+ * @brief The clock of the timed waits.
+ *
+ * @note macOS has no `pthread_condattr_setclock`, the deadlines are converted
+ * to `CLOCK_REALTIME` there.
+ */
+#  if defined(__APPLE__)
+#    define SS_COND_CLOCK CLOCK_REALTIME
+#  else
+#    define SS_COND_CLOCK CLOCK_MONOTONIC
+#  endif
+
 static inline int
 ss_cond_init_impl(ss_cond_t *__restrict cond,
                   const enum SsThreadProcess *__restrict type) {
-  /**
-   * @note If no type is specified or if we want process private (default),
-   * we can use the simple initialization.
-   */
-  if (!type || *type == kSsThreadProcessPrivate)
-    return pthread_cond_init((pthread_cond_t *)cond, nullptr);
-
   int ret;
   pthread_condattr_t attr;
 
@@ -127,11 +142,21 @@ ss_cond_init_impl(ss_cond_t *__restrict cond,
   if (ret)
     return ret;
 
-  ret = pthread_condattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+#  if !defined(__APPLE__)
+  ret = pthread_condattr_setclock(&attr, SS_COND_CLOCK);
   if (ret) {
     pthread_condattr_destroy(&attr);
     return ret;
   }
+#  endif
+
+  if (type && *type == kSsThreadProcessShared) {
+    ret = pthread_condattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    if (ret) {
+      pthread_condattr_destroy(&attr);
+      return ret;
+    }
+  }
 
   ret = pthread_cond_init((pthread_cond_t *)cond, &attr);
   pthread_condattr_destroy(&attr);
@@ -142,26 +167,49 @@ static inline int ss_cond_destroy_impl(ss_cond_t *cond) {
   return pthread_cond_destroy((pthread_cond_t *)cond);
 }
 
+/**
+ * @note The futex of `kSsMutexTypeAdaptive` is not a `pthread_mutex_t`.
+ */
+#  if defined(__linux__)
+#    define SS_COND_CHECK_MUTEX(mutex) \
+      do { \
+        if (((ss_mutex_s *)(mutex))->type == kSsMutexTypeAdaptive) \
+          return EINVAL; \
+      } while (0)
+#  else
+#    define SS_COND_CHECK_MUTEX(mutex) \
+      do { \
+      } while (0)
+#  endif
+
 static inline int ss_cond_wait_impl(ss_cond_t *__restrict cond,
                                     ss_mutex_t *__restrict mutex) {
-  return pthread_cond_wait((pthread_cond_t *)cond, (pthread_mutex_t *)mutex);
+  SS_COND_CHECK_MUTEX(mutex);
+  pthread_mutex_t *m = (pthread_mutex_t *)mutex;
+  return ss_mutex_pthread_recover(m,
+                                  pthread_cond_wait((pthread_cond_t *)cond, m));
+}
+
+static inline int ss_cond_wait_until_impl(ss_cond_t *__restrict cond,
+                                          ss_mutex_t *__restrict mutex,
+                                          uint64_t deadline_ns) {
+  SS_COND_CHECK_MUTEX(mutex);
+
+  int ret;
+  struct timespec ts;
+  if ((ret = ss_clock_timespec(&ts, SS_COND_CLOCK, deadline_ns)))
+    return ret;
+
+  pthread_mutex_t *m = (pthread_mutex_t *)mutex;
+  return ss_mutex_pthread_recover(
+    m, pthread_cond_timedwait((pthread_cond_t *)cond, m, &ts));
 }
 
 static inline int ss_cond_timedwait_impl(ss_cond_t *__restrict cond,
                                          ss_mutex_t *__restrict mutex,
                                          uint64_t milliseconds) {
-  struct timespec ts;
-  if (clock_gettime(CLOCK_REALTIME, &ts))
-    return errno;
-
-  ts.tv_sec += (time_t)(milliseconds / 1000);
-  ts.tv_nsec += (long)((milliseconds % 1000) * 1000000L);
-  if (ts.tv_nsec >= 1000000000L) {
-    ts.tv_sec += ts.tv_nsec / 1000000000L;
-    ts.tv_nsec = ts.tv_nsec % 1000000000L;
-  }
-  return pthread_cond_timedwait((pthread_cond_t *)cond,
-                                (pthread_mutex_t *)mutex, &ts);
+  return ss_cond_wait_until_impl(cond, mutex,
+                                 ss_clock_deadline_ns(milliseconds));
 }
 
 static inline int ss_cond_signal_impl(ss_cond_t *cond) {
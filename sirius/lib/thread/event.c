@@ -0,0 +1,59 @@
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include "sirius/thread/event.h"
+
+#include "lib/thread/inner/futex.h"
+
+SIRIUS_API int ss_event_init(ss_event_t *event) {
+  event->__epoch = 0;
+  event->__waiters = 0;
+  return 0;
+}
+
+SIRIUS_API uint32_t ss_event_prepare_wait(ss_event_t *event) {
+  /**
+   * @note Ordered before the reads of the consumer which check its condition
+   * again, see `ss_event_notify`.
+   */
+  (void)ss_futex_fetch_add(&event->__waiters, 1);
+  return ss_futex_load_seq_cst(&event->__epoch);
+}
+
+SIRIUS_API void ss_event_commit_wait(ss_event_t *event, uint32_t key) {
+  while (ss_futex_load_acquire(&event->__epoch) == key) {
+    ss_futex_wait(&event->__epoch, key);
+  }
+  (void)ss_futex_fetch_add(&event->__waiters, (uint32_t)-1);
+}
+
+SIRIUS_API void ss_event_cancel_wait(ss_event_t *event) {
+  (void)ss_futex_fetch_add(&event->__waiters, (uint32_t)-1);
+}
+
+/**
+ * @note Either the producer sees the consumer registered, or the consumer,
+ * which registers before it checks its condition again, sees the change of
+ * the producer, which precedes the fence.
+ */
+static inline int event_bump(ss_event_t *event) {
+  ss_futex_fence_seq_cst();
+  if (ss_likely(ss_futex_load(&event->__waiters) == 0))
+    return 0;
+
+  (void)ss_futex_fetch_add(&event->__epoch, 1);
+  return 1;
+}
+
+SIRIUS_API void ss_event_notify(ss_event_t *event) {
+  if (event_bump(event)) {
+    ss_futex_wake_one(&event->__epoch);
+  }
+}
+
+SIRIUS_API void ss_event_notify_all(ss_event_t *event) {
+  if (event_bump(event)) {
+    ss_futex_wake_all(&event->__epoch);
+  }
+}
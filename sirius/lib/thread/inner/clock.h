@@ -0,0 +1,86 @@
+/**
+ * @brief The monotonic clock of the timed waits, in nanoseconds. It reads
+ * the same clock as `ss_get_clock_monotonic_ns`, so the deadlines of
+ * `ss_cond_wait_until` and `ss_sem_wait_until` are on that clock.
+ */
+
+#pragma once
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include "sirius/attributes.h"
+
+#define SS_CLOCK_NS_PER_MS 1000000ULL
+#define SS_CLOCK_NS_PER_S 1000000000ULL
+
+static inline uint64_t ss_clock_monotonic_ns() {
+#if defined(_WIN32) || defined(_WIN64)
+  static LARGE_INTEGER frequency = {0};
+  LARGE_INTEGER counter;
+  if (ss_unlikely(frequency.QuadPart == 0)) {
+    if (ss_unlikely(!QueryPerformanceFrequency(&frequency)))
+      return 0;
+  }
+  if (ss_unlikely(!QueryPerformanceCounter(&counter)))
+    return 0;
+
+  uint64_t whole_seconds = counter.QuadPart / frequency.QuadPart;
+  uint64_t remainder_ticks = counter.QuadPart % frequency.QuadPart;
+  return whole_seconds * SS_CLOCK_NS_PER_S +
+    (remainder_ticks * SS_CLOCK_NS_PER_S) / frequency.QuadPart;
+#else
+  struct timespec ts;
+  if (ss_unlikely(clock_gettime(CLOCK_MONOTONIC, &ts)))
+    return 0;
+  return (uint64_t)ts.tv_sec * SS_CLOCK_NS_PER_S + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief The deadline `milliseconds` from now, saturated at `UINT64_MAX`.
+ */
+static inline uint64_t ss_clock_deadline_ns(uint64_t milliseconds) {
+  uint64_t now = ss_clock_monotonic_ns();
+  if (milliseconds > (UINT64_MAX - now) / SS_CLOCK_NS_PER_MS)
+    return UINT64_MAX;
+  return now + milliseconds * SS_CLOCK_NS_PER_MS;
+}
+
+/**
+ * @brief The milliseconds left until `deadline_ns`, rounded up, so that a
+ * wait in milliseconds never ends before the deadline.
+ */
+static inline uint64_t ss_clock_remaining_ms(uint64_t deadline_ns) {
+  uint64_t now = ss_clock_monotonic_ns();
+  if (deadline_ns <= now)
+    return 0;
+  return (deadline_ns - now + SS_CLOCK_NS_PER_MS - 1) / SS_CLOCK_NS_PER_MS;
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+/**
+ * @brief Convert a deadline of the monotonic clock to a `timespec` of
+ * `clock_id`.
+ *
+ * @note A clock other than `CLOCK_MONOTONIC` may be stepped meanwhile, this
+ * is the fallback of the platforms which can not wait on the monotonic clock.
+ */
+static inline int ss_clock_timespec(struct timespec *ts, clockid_t clock_id,
+                                    uint64_t deadline_ns) {
+  if (clock_id != CLOCK_MONOTONIC) {
+    uint64_t now = ss_clock_monotonic_ns();
+    uint64_t left = deadline_ns > now ? deadline_ns - now : 0;
+    struct timespec base;
+    if (clock_gettime(clock_id, &base))
+      return errno;
+    uint64_t base_ns =
+      (uint64_t)base.tv_sec * SS_CLOCK_NS_PER_S + (uint64_t)base.tv_nsec;
+    deadline_ns = left > UINT64_MAX - base_ns ? UINT64_MAX : base_ns + left;
+  }
+
+  ts->tv_sec = (time_t)(deadline_ns / SS_CLOCK_NS_PER_S);
+  ts->tv_nsec = (long)(deadline_ns % SS_CLOCK_NS_PER_S);
+  return 0;
+}
+#endif
@@ -0,0 +1,117 @@
+#pragma once
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#if defined(__linux__)
+#  include <linux/mempolicy.h>
+#endif
+
+#include <charconv>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "sirius/thread/thread.h"
+
+namespace sirius {
+namespace cpu {
+inline constexpr const char *kSysfsCpuDir = "/sys/devices/system/cpu";
+inline constexpr const char *kSysfsNodeDir = "/sys/devices/system/node";
+
+/**
+ * @brief Read the first line of a small (sysfs) file.
+ */
+inline bool file_read_line(const std::string &path, std::string &line) {
+  std::ifstream ifs(path);
+  if (!ifs.is_open() || !std::getline(ifs, line))
+    return false;
+  return true;
+}
+
+inline bool file_read_int(const std::string &path, int &value) {
+  std::string line;
+  if (!file_read_line(path, line))
+    return false;
+  auto [ptr, ec] = std::from_chars(line.data(), line.data() + line.size(),
+                                   value);
+  return ec == std::errc();
+}
+
+/**
+ * @brief Parse a CPU list, e.g., `0-3,8,10-11`, the format of sysfs.
+ */
+inline bool cpulist_parse(std::string_view str, ss_cpu_set_t &set) {
+  ss_cpu_set_zero(&set);
+  while (!str.empty() && str.back() == '\n') {
+    str.remove_suffix(1);
+  }
+
+  const char *ptr = str.data();
+  const char *end = str.data() + str.size();
+  while (ptr < end) {
+    size_t first = 0, last = 0;
+    auto ret = std::from_chars(ptr, end, first);
+    if (ret.ec != std::errc())
+      return false;
+    ptr = ret.ptr;
+    last = first;
+    if (ptr < end && *ptr == '-') {
+      ret = std::from_chars(ptr + 1, end, last);
+      if (ret.ec != std::errc() || last < first)
+        return false;
+      ptr = ret.ptr;
+    }
+    for (size_t cpu = first; cpu <= last && cpu < SS_CPU_SETSIZE; ++cpu) {
+      ss_cpu_set_add(&set, cpu);
+    }
+    if (ptr < end && *ptr != ',')
+      return false;
+    if (ptr < end) {
+      ++ptr;
+    }
+  }
+  return true;
+}
+
+inline bool cpulist_read(const std::string &path, ss_cpu_set_t &set) {
+  std::string line;
+  return file_read_line(path, line) && cpulist_parse(line, set);
+}
+
+/**
+ * @brief The CPUs of a NUMA node.
+ */
+inline bool numa_node_cpus(int node, ss_cpu_set_t &set) {
+  if (node < 0)
+    return false;
+  return cpulist_read(std::string(kSysfsNodeDir) + "/node" +
+                        std::to_string(node) + "/cpulist",
+                      set);
+}
+
+/**
+ * @brief Prefer the memory of `node` for the allocations of the calling
+ * thread.
+ *
+ * @return 0 on success, or an `errno` value on failure.
+ */
+inline int numa_prefer(int node) {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+  constexpr size_t kNodeBits = 8 * sizeof(unsigned long);
+  unsigned long nodemask[16] {};
+  if (node < 0 || static_cast<size_t>(node) >= kNodeBits * std::size(nodemask))
+    return EINVAL;
+  nodemask[node / kNodeBits] = 1UL << (node % kNodeBits);
+
+  if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, nodemask,
+              kNodeBits * std::size(nodemask)) == -1)
+    return errno;
+  return 0;
+#else
+  (void)node;
+  return ENOTSUP;
+#endif
+}
+} // namespace cpu
+} // namespace sirius
@@ -0,0 +1,240 @@
+/**
+ * @brief Atomic operations and waits on 32-bit words, and a 3-state lock
+ * which sleeps on the futex of its word, see "Futexes Are Tricky" (Drepper),
+ * mutex 3.
+ *
+ * @note
+ * - (1) The waits and the wake-ups go through `utils/futex.h`. On Windows,
+ * `WaitOnAddress` takes the place of the futex.
+ *
+ * - (2) On the other platforms, a waiter yields instead of sleeping.
+ */
+
+#pragma once
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#endif
+
+#include "sirius/attributes.h"
+#include "sirius/foundation/sync.h"
+#include "utils/futex.h"
+
+enum SsFutexState {
+  kSsFutexUnlocked = 0,
+  kSsFutexLocked = 1,
+
+  /**
+   * @brief Locked, and there may be sleepers.
+   */
+  kSsFutexContended = 2,
+};
+
+/**
+ * @brief Spin bound of a lock without a spin history.
+ */
+#define SS_FUTEX_SPINS 100
+
+/**
+ * @brief Upper bound of the adaptive spin.
+ */
+#define SS_FUTEX_SPINS_MAX 1000
+
+#if defined(_MSC_VER) && !defined(__clang__)
+static inline uint32_t ss_futex_cas(volatile uint32_t *word, uint32_t expected,
+                                    uint32_t desired) {
+  return (uint32_t)_InterlockedCompareExchange((volatile long *)word,
+                                               (long)desired, (long)expected);
+}
+
+static inline uint32_t ss_futex_xchg(volatile uint32_t *word,
+                                     uint32_t desired) {
+  return (uint32_t)_InterlockedExchange((volatile long *)word, (long)desired);
+}
+
+static inline uint32_t ss_futex_load(volatile uint32_t *word) {
+  return *word;
+}
+
+static inline void ss_futex_store(volatile uint32_t *word, uint32_t value) {
+  *word = value;
+}
+
+/**
+ * @note The `_Interlocked` functions are full barriers.
+ */
+static inline uint32_t ss_futex_fetch_add(volatile uint32_t *word,
+                                          uint32_t value) {
+  return (uint32_t)_InterlockedExchangeAdd((volatile long *)word, (long)value);
+}
+
+static inline uint32_t ss_futex_fetch_and(volatile uint32_t *word,
+                                          uint32_t value) {
+  return (uint32_t)_InterlockedAnd((volatile long *)word, (long)value);
+}
+
+static inline uint32_t ss_futex_fetch_or(volatile uint32_t *word,
+                                         uint32_t value) {
+  return (uint32_t)_InterlockedOr((volatile long *)word, (long)value);
+}
+
+#  if defined(_M_IX86) || defined(_M_X64)
+#    define ss_futex_fence_acquire() _ReadWriteBarrier()
+#    define ss_futex_fence_release() _ReadWriteBarrier()
+#  else
+#    define ss_futex_fence_acquire() MemoryBarrier()
+#    define ss_futex_fence_release() MemoryBarrier()
+#  endif
+#  define ss_futex_fence_seq_cst() MemoryBarrier()
+
+static inline uint32_t ss_futex_load_acquire(volatile uint32_t *word) {
+  uint32_t value = *word;
+  ss_futex_fence_acquire();
+  return value;
+}
+
+/**
+ * @brief A load ordered after the preceding `_Interlocked` operation, which
+ * is already a full barrier.
+ */
+static inline uint32_t ss_futex_load_seq_cst(volatile uint32_t *word) {
+  return ss_futex_load_acquire(word);
+}
+#else
+static inline uint32_t ss_futex_cas(volatile uint32_t *word, uint32_t expected,
+                                    uint32_t desired) {
+  __atomic_compare_exchange_n(word, &expected, desired, false,
+                              __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+  return expected;
+}
+
+static inline uint32_t ss_futex_xchg(volatile uint32_t *word,
+                                     uint32_t desired) {
+  return __atomic_exchange_n(word, desired, __ATOMIC_ACQ_REL);
+}
+
+static inline uint32_t ss_futex_load(volatile uint32_t *word) {
+  return __atomic_load_n(word, __ATOMIC_RELAXED);
+}
+
+static inline void ss_futex_store(volatile uint32_t *word, uint32_t value) {
+  __atomic_store_n(word, value, __ATOMIC_RELAXED);
+}
+
+static inline uint32_t ss_futex_fetch_add(volatile uint32_t *word,
+                                          uint32_t value) {
+  return __atomic_fetch_add(word, value, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t ss_futex_fetch_and(volatile uint32_t *word,
+                                          uint32_t value) {
+  return __atomic_fetch_and(word, value, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t ss_futex_fetch_or(volatile uint32_t *word,
+                                         uint32_t value) {
+  return __atomic_fetch_or(word, value, __ATOMIC_SEQ_CST);
+}
+
+#  define ss_futex_fence_acquire() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#  define ss_futex_fence_release() __atomic_thread_fence(__ATOMIC_RELEASE)
+#  define ss_futex_fence_seq_cst() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+static inline uint32_t ss_futex_load_acquire(volatile uint32_t *word) {
+  return __atomic_load_n(word, __ATOMIC_ACQUIRE);
+}
+
+static inline uint32_t ss_futex_load_seq_cst(volatile uint32_t *word) {
+  return __atomic_load_n(word, __ATOMIC_SEQ_CST);
+}
+#endif
+
+/**
+ * @brief Sleep while `*word == expected`. Spurious wake-ups are possible.
+ */
+static inline void ss_futex_wait(volatile uint32_t *word, uint32_t expected) {
+#if UTILS_FUTEX_NATIVE
+  (void)utils_futex_wait(word, expected, UTILS_FUTEX_INFINITE);
+#else
+  (void)word, (void)expected;
+  ss_os_yield();
+#endif
+}
+
+static inline void ss_futex_wake_one(volatile uint32_t *word) {
+  utils_futex_wake(word, 1);
+}
+
+static inline void ss_futex_wake_all(volatile uint32_t *word) {
+  utils_futex_wake(word, INT_MAX);
+}
+
+/**
+ * @brief Lock `word`, spinning first while the owner is likely to release it
+ * soon.
+ *
+ * @param[in,out] spins Running average of the spins of the past acquisitions,
+ * it bounds the next spin. If `nullptr`, the bound is `SS_FUTEX_SPINS`.
+ *
+ * @note The spin only goes on while the word is `kSsFutexLocked`: a
+ * `kSsFutexContended` word means that a thread already gave up spinning on
+ * this owner, i.e., the owner is off CPU or its critical section is long.
+ */
+static inline void ss_futex_lock(volatile uint32_t *word,
+                                 volatile uint32_t *spins) {
+  uint32_t c = ss_futex_cas(word, kSsFutexUnlocked, kSsFutexLocked);
+  if (ss_likely(c == kSsFutexUnlocked))
+    return;
+
+  uint32_t max_spins = SS_FUTEX_SPINS;
+  if (spins) {
+    max_spins = 2 * ss_futex_load(spins) + 10;
+    if (max_spins > SS_FUTEX_SPINS_MAX) {
+      max_spins = SS_FUTEX_SPINS_MAX;
+    }
+  }
+
+  uint32_t nb_spins = 0;
+  while (c == kSsFutexLocked && nb_spins < max_spins) {
+    ss_cpu_pause();
+    ++nb_spins;
+    c = ss_futex_load(word);
+    if (c == kSsFutexUnlocked) {
+      c = ss_futex_cas(word, kSsFutexUnlocked, kSsFutexLocked);
+      if (c == kSsFutexUnlocked)
+        break;
+    }
+  }
+  if (spins) {
+    uint32_t average = ss_futex_load(spins);
+    ss_futex_store(spins, (uint32_t)((int32_t)average +
+                                     ((int32_t)nb_spins - (int32_t)average) /
+                                       8));
+  }
+  if (c == kSsFutexUnlocked)
+    return;
+
+  if (c != kSsFutexContended) {
+    c = ss_futex_xchg(word, kSsFutexContended);
+  }
+  while (c != kSsFutexUnlocked) {
+    ss_futex_wait(word, kSsFutexContended);
+    c = ss_futex_xchg(word, kSsFutexContended);
+  }
+}
+
+static inline int ss_futex_trylock(volatile uint32_t *word) {
+  return ss_futex_cas(word, kSsFutexUnlocked, kSsFutexLocked) ==
+      kSsFutexUnlocked
+    ? 0
+    : EBUSY;
+}
+
+static inline void ss_futex_unlock(volatile uint32_t *word) {
+  if (ss_futex_xchg(word, kSsFutexUnlocked) == kSsFutexContended) {
+    ss_futex_wake_one(word);
+  }
+}
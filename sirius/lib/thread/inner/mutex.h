@@ -15,9 +15,61 @@ typedef struct {
   } handle;
 } ss_mutex_s;
 
+utils_check_sizeof(ss_mutex_t, ss_mutex_s);
+utils_check_alignof(ss_mutex_t, ss_mutex_s);
+#elif defined(__linux__)
+typedef struct {
+  union {
+    pthread_mutex_t pthread;
+
+    /**
+     * @brief `kSsMutexTypeAdaptive`.
+     */
+    struct {
+      uint32_t word;
+      uint32_t spins;
+    } futex;
+  } handle;
+
+  /**
+   * @note Zero, i.e., `kSsMutexTypeNormal`, for `SS_MUTEX_INITIALIZER`.
+   */
+  enum SsMutexType type;
+} ss_mutex_s;
+
 utils_check_sizeof(ss_mutex_t, ss_mutex_s);
 utils_check_alignof(ss_mutex_t, ss_mutex_s);
 #else
 utils_check_sizeof(ss_mutex_t, pthread_mutex_t);
 utils_check_alignof(ss_mutex_t, pthread_mutex_t);
 #endif
+
+utils_check_sizeof(ss_mutex_lite_t, uint32_t);
+
+/**
+ * @brief Non-zero where robust mutexes, i.e., `pthread_mutexattr_setrobust`
+ * and `pthread_mutex_consistent`, are available. macOS and Android have
+ * neither.
+ */
+#if (defined(__linux__) && !defined(__ANDROID__)) || defined(__FreeBSD__)
+#  define SS_MUTEX_ROBUST 1
+#else
+#  define SS_MUTEX_ROBUST 0
+#endif
+
+#if !defined(_WIN32) && !defined(_WIN64)
+/**
+ * @brief Make a robust mutex acquired from a dead owner usable again, it
+ * stays locked by the caller.
+ */
+static inline int ss_mutex_pthread_recover(pthread_mutex_t *mutex, int ret) {
+#  if SS_MUTEX_ROBUST
+  if (ss_unlikely(ret == EOWNERDEAD)) {
+    (void)pthread_mutex_consistent(mutex);
+  }
+#  else
+  (void)mutex;
+#  endif
+  return ret;
+}
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @brief Per-thread records behind `ss_thread_stats`: the kernel thread id,
+ * and the time spent blocked in the mutexes, the condition variables and the
+ * semaphores, see `ss_thread_wait_accounting`.
+ */
+
+#pragma once
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include "lib/thread/inner/clock.h"
+#include "lib/thread/inner/futex.h"
+#include "sirius/thread/thread.h"
+#include "utils/attributes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Non-zero while the accounting is on.
+ */
+utils_hidden extern volatile uint32_t _ss_thread_wait_accounting_on;
+
+/**
+ * @brief Add a wait of `nanoseconds` to the calling thread.
+ */
+utils_hidden void _ss_thread_wait_add(uint64_t nanoseconds);
+
+#ifdef __cplusplus
+}
+
+namespace sirius {
+namespace stats {
+struct Snapshot {
+  uint64_t tid;
+  uint64_t wait_time_ns;
+  uint64_t nb_waits;
+};
+
+/**
+ * @brief Register the calling thread, whose handle is `self`, once. Called
+ * when the thread starts from `ss_thread_create`, and on its first accounted
+ * wait.
+ *
+ * @note A failure, e.g. out of memory, leaves the thread out.
+ */
+utils_hidden void register_self(ss_thread_t self) noexcept;
+
+/**
+ * @brief The record of `thread`.
+ *
+ * @return false if `thread` never registered, or exited.
+ */
+utils_hidden bool get(ss_thread_t thread, Snapshot &snapshot) noexcept;
+} // namespace stats
+} // namespace sirius
+#endif
+
+/**
+ * @brief `ret = call`, timed if the accounting is on. Off, it costs a load.
+ */
+#define SS_THREAD_WAIT_ACCOUNT(ret, call) \
+  do { \
+    if (ss_likely(!ss_futex_load(&_ss_thread_wait_accounting_on))) { \
+      ret = call; \
+    } else { \
+      uint64_t start_ns = ss_clock_monotonic_ns(); \
+      ret = call; \
+      _ss_thread_wait_add(ss_clock_monotonic_ns() - start_ns); \
+    } \
+  } while (0)
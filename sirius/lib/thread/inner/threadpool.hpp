@@ -0,0 +1,25 @@
+#pragma once
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include "sirius/thread/threadpool.h"
+
+namespace sirius {
+namespace threadpool {
+size_t nb_workers(ss_threadpool_t *pool);
+
+/**
+ * @brief Whether the calling thread is a worker of `pool`.
+ */
+bool is_worker(ss_threadpool_t *pool);
+
+/**
+ * @brief Run one pending task of `pool` on the calling thread, if it is a
+ * worker of `pool` and finds one.
+ *
+ * @return Whether a task ran.
+ */
+bool help(ss_threadpool_t *pool);
+} // namespace threadpool
+} // namespace sirius
@@ -4,6 +4,8 @@
 
 #include "lib/thread/mutex.h"
 
+#include "lib/thread/inner/stats.h"
+
 SIRIUS_API int ss_mutex_init(ss_mutex_t *mutex, const enum SsMutexType *type) {
   return ss_mutex_init_impl(mutex, type);
 }
@@ -13,7 +15,17 @@ SIRIUS_API int ss_mutex_destroy(ss_mutex_t *mutex) {
 }
 
 SIRIUS_API int ss_mutex_lock(ss_mutex_t *mutex) {
-  return ss_mutex_lock_impl(mutex);
+  if (ss_likely(!ss_futex_load(&_ss_thread_wait_accounting_on)))
+    return ss_mutex_lock_impl(mutex);
+
+  /**
+   * @note Only the contended locks are accounted.
+   */
+  int ret = ss_mutex_trylock_impl(mutex);
+  if (ret != EBUSY)
+    return ret;
+  SS_THREAD_WAIT_ACCOUNT(ret, ss_mutex_lock_impl(mutex));
+  return ret;
 }
 
 SIRIUS_API int ss_mutex_unlock(ss_mutex_t *mutex) {
@@ -23,3 +35,22 @@ SIRIUS_API int ss_mutex_unlock(ss_mutex_t *mutex) {
 SIRIUS_API int ss_mutex_trylock(ss_mutex_t *mutex) {
   return ss_mutex_trylock_impl(mutex);
 }
+
+SIRIUS_API int ss_mutex_lite_init(ss_mutex_lite_t *mutex) {
+  mutex->__word = kSsFutexUnlocked;
+  return 0;
+}
+
+SIRIUS_API int ss_mutex_lite_lock(ss_mutex_lite_t *mutex) {
+  ss_futex_lock(&mutex->__word, nullptr);
+  return 0;
+}
+
+SIRIUS_API int ss_mutex_lite_unlock(ss_mutex_lite_t *mutex) {
+  ss_futex_unlock(&mutex->__word);
+  return 0;
+}
+
+SIRIUS_API int ss_mutex_lite_trylock(ss_mutex_lite_t *mutex) {
+  return ss_futex_trylock(&mutex->__word);
+}
@@ -3,6 +3,7 @@
 #include "utils/decls.h"
 /* clang-format on */
 
+#include "lib/thread/inner/futex.h"
 #include "lib/thread/inner/mutex.h"
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -10,6 +11,15 @@ static inline int ss_mutex_init_impl(ss_mutex_t *mutex,
                                      const enum SsMutexType *type) {
   ss_mutex_s *m = (ss_mutex_s *)mutex;
   enum SsMutexType mt = type ? *type : kSsMutexTypeNormal;
+  /**
+   * @note `SRWLOCK` is already a lightweight lock, `kSsMutexTypeAdaptive`
+   * uses it as is.
+   */
+  if (mt == kSsMutexTypeAdaptive) {
+    mt = kSsMutexTypeNormal;
+  }
+  if (mt == kSsMutexTypeShared)
+    return ENOTSUP;
   m->type = mt;
 
   if (mt == kSsMutexTypeRecursive) {
@@ -82,13 +92,17 @@ static inline int ss_mutex_trylock_impl(ss_mutex_t *mutex) {
   }
 }
 #else
-static inline int ss_mutex_init_impl(ss_mutex_t *mutex,
-                                     const enum SsMutexType *type) {
+static inline int ss_mutex_pthread_init(pthread_mutex_t *mutex,
+                                        const enum SsMutexType *type) {
   int ret;
   pthread_mutexattr_t attr;
 
   if (!type)
-    return pthread_mutex_init((pthread_mutex_t *)mutex, nullptr);
+    return pthread_mutex_init(mutex, nullptr);
+#  if !SS_MUTEX_ROBUST
+  if (*type == kSsMutexTypeShared)
+    return ENOTSUP;
+#  endif
 
   ret = pthread_mutexattr_init(&attr);
   if (ret)
@@ -102,17 +116,81 @@ static inline int ss_mutex_init_impl(ss_mutex_t *mutex,
     return ret;
   }
 
-  ret = pthread_mutex_init((pthread_mutex_t *)mutex, &attr);
+#  if SS_MUTEX_ROBUST
+  if (*type == kSsMutexTypeShared) {
+    if ((ret = pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED)) ||
+        (ret = pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST))) {
+      pthread_mutexattr_destroy(&attr);
+      return ret;
+    }
+  }
+#  endif
+
+  ret = pthread_mutex_init(mutex, &attr);
   pthread_mutexattr_destroy(&attr);
   return ret;
 }
 
+#  if defined(__linux__)
+static inline int ss_mutex_init_impl(ss_mutex_t *mutex,
+                                     const enum SsMutexType *type) {
+  ss_mutex_s *m = (ss_mutex_s *)mutex;
+  m->type = type ? *type : kSsMutexTypeNormal;
+
+  if (m->type == kSsMutexTypeAdaptive) {
+    m->handle.futex.word = kSsFutexUnlocked;
+    m->handle.futex.spins = 0;
+    return 0;
+  }
+  return ss_mutex_pthread_init(&m->handle.pthread, type);
+}
+
+static inline int ss_mutex_destroy_impl(ss_mutex_t *mutex) {
+  ss_mutex_s *m = (ss_mutex_s *)mutex;
+  if (m->type == kSsMutexTypeAdaptive)
+    return 0;
+  return pthread_mutex_destroy(&m->handle.pthread);
+}
+
+static inline int ss_mutex_lock_impl(ss_mutex_t *mutex) {
+  ss_mutex_s *m = (ss_mutex_s *)mutex;
+  if (m->type == kSsMutexTypeAdaptive) {
+    ss_futex_lock(&m->handle.futex.word, &m->handle.futex.spins);
+    return 0;
+  }
+  return ss_mutex_pthread_recover(&m->handle.pthread,
+                                  pthread_mutex_lock(&m->handle.pthread));
+}
+
+static inline int ss_mutex_unlock_impl(ss_mutex_t *mutex) {
+  ss_mutex_s *m = (ss_mutex_s *)mutex;
+  if (m->type == kSsMutexTypeAdaptive) {
+    ss_futex_unlock(&m->handle.futex.word);
+    return 0;
+  }
+  return pthread_mutex_unlock(&m->handle.pthread);
+}
+
+static inline int ss_mutex_trylock_impl(ss_mutex_t *mutex) {
+  ss_mutex_s *m = (ss_mutex_s *)mutex;
+  if (m->type == kSsMutexTypeAdaptive)
+    return ss_futex_trylock(&m->handle.futex.word);
+  return ss_mutex_pthread_recover(&m->handle.pthread,
+                                  pthread_mutex_trylock(&m->handle.pthread));
+}
+#  else
+static inline int ss_mutex_init_impl(ss_mutex_t *mutex,
+                                     const enum SsMutexType *type) {
+  return ss_mutex_pthread_init((pthread_mutex_t *)mutex, type);
+}
+
 static inline int ss_mutex_destroy_impl(ss_mutex_t *mutex) {
   return pthread_mutex_destroy((pthread_mutex_t *)mutex);
 }
 
 static inline int ss_mutex_lock_impl(ss_mutex_t *mutex) {
-  return pthread_mutex_lock((pthread_mutex_t *)mutex);
+  pthread_mutex_t *m = (pthread_mutex_t *)mutex;
+  return ss_mutex_pthread_recover(m, pthread_mutex_lock(m));
 }
 
 static inline int ss_mutex_unlock_impl(ss_mutex_t *mutex) {
@@ -120,6 +198,8 @@ static inline int ss_mutex_unlock_impl(ss_mutex_t *mutex) {
 }
 
 static inline int ss_mutex_trylock_impl(ss_mutex_t *mutex) {
-  return pthread_mutex_trylock((pthread_mutex_t *)mutex);
+  pthread_mutex_t *m = (pthread_mutex_t *)mutex;
+  return ss_mutex_pthread_recover(m, pthread_mutex_trylock(m));
 }
+#  endif
 #endif
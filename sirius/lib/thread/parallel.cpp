@@ -0,0 +1,282 @@
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include "sirius/thread/parallel.h"
+
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include "lib/thread/inner/threadpool.hpp"
+#include "utils/futex.hpp"
+#include "utils/io.hpp"
+
+namespace sirius {
+namespace {
+/**
+ * @brief Chunks per worker when the grain is left to the library.
+ */
+inline constexpr size_t kChunksPerWorker = 8;
+
+/**
+ * @brief Timeout of a waiting worker between two attempts to help, unit: ms.
+ */
+inline constexpr uint64_t kHelpIntervalMs = 1;
+
+/**
+ * @note The pool lives until the process exits, joining its workers from a
+ * static destructor could deadlock.
+ */
+inline ss_threadpool_t *default_pool(int &ret) {
+  static std::once_flag flag;
+  static ss_threadpool_t *pool = nullptr;
+  static int pool_ret = 0;
+
+  std::call_once(flag, []() {
+    ss_threadpool_args_t args {};
+    args.nb_workers = UTILS_MAX(std::thread::hardware_concurrency(), 2U) - 1;
+    pool_ret = ss_threadpool_create(&pool, &args);
+    if (pool_ret) {
+      logln_error("ss_threadpool_create: {0}", pool_ret);
+    }
+  });
+  ret = pool_ret;
+  return pool;
+}
+
+struct Job {
+  ss_threadpool_t *pool;
+  size_t grain;
+
+  /**
+   * @brief Halves submitted to the pool and not started yet.
+   */
+  std::atomic<size_t> nb_queued {0};
+  size_t max_queued;
+
+  /**
+   * @brief Either `for_fn`, or `args` for a reduction.
+   */
+  ss_parallel_for_fn_t for_fn;
+  void *for_ctx;
+  const ss_parallel_reduce_args_t *args;
+
+  /**
+   * @brief Copy of the initial `*result`, when `args->init` is `nullptr`.
+   */
+  const void *identity;
+};
+
+/**
+ * @brief A half split off a range, with its partial result.
+ */
+struct Node {
+  Job *job;
+  size_t begin;
+  size_t end;
+  void *partial;
+
+  /**
+   * @brief The next half to the right, split off earlier by the same range.
+   */
+  Node *next;
+
+  std::atomic<uint32_t> done {0};
+
+  /**
+   * @brief Held by the runner and by the waiter, the runner still wakes the
+   * waiter up after `done`.
+   */
+  std::atomic<uint32_t> nb_refs {2};
+};
+
+/**
+ * @note The partial result is freed by the waiter beforehand, the job may be
+ * gone once the runner is done.
+ */
+inline void node_release(Node *node) {
+  if (node->nb_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete node;
+  }
+}
+
+inline void chunk_run(Job &job, size_t begin, size_t end, void *partial) {
+  if (job.for_fn) {
+    job.for_fn(begin, end, job.for_ctx);
+  } else {
+    job.args->body(begin, end, partial, job.args->ctx);
+  }
+}
+
+inline void partial_free(Job &job, void *partial) {
+  if (!partial)
+    return;
+  if (job.args->fini) {
+    job.args->fini(partial, job.args->ctx);
+  }
+  ::operator delete(partial);
+}
+
+void node_main(void *arg);
+
+/**
+ * @return `nullptr` if the half cannot be split off, then the caller keeps it.
+ */
+inline Node *node_spawn(Job &job, size_t begin, size_t end) {
+  auto node = new (std::nothrow) Node {&job, begin, end, nullptr, nullptr};
+  if (!node)
+    return nullptr;
+
+  if (job.args && job.args->partial_size > 0) {
+    node->partial = ::operator new(job.args->partial_size, std::nothrow);
+    if (!node->partial) {
+      delete node;
+      return nullptr;
+    }
+    if (job.args->init) {
+      job.args->init(node->partial, job.args->ctx);
+    } else {
+      std::memcpy(node->partial, job.identity, job.args->partial_size);
+    }
+  }
+
+  job.nb_queued.fetch_add(1, std::memory_order_relaxed);
+  if (ss_threadpool_submit(job.pool, node_main, node)) {
+    job.nb_queued.fetch_sub(1, std::memory_order_relaxed);
+    partial_free(job, node->partial);
+    delete node;
+    return nullptr;
+  }
+  return node;
+}
+
+/**
+ * @note A worker keeps running the pending tasks meanwhile, the halves of this
+ * loop first, so that a nested loop cannot exhaust the workers.
+ */
+inline void node_wait(Job &job, Node *node) {
+  const bool worker = threadpool::is_worker(job.pool);
+  while (!node->done.load(std::memory_order_acquire)) {
+    if (worker && threadpool::help(job.pool))
+      continue;
+    (void)utils::futex::wait(&node->done, 0,
+                             worker ? kHelpIntervalMs
+                                    : utils::futex::kInfinite);
+  }
+}
+
+/**
+ * @brief Run `[begin, end)` into `partial`, splitting off the right half while
+ * the halves already split off are being taken.
+ */
+inline void range_run(Job &job, size_t begin, size_t end, void *partial) {
+  Node *children = nullptr;
+  while (begin < end) {
+    while (end - begin > job.grain &&
+           job.nb_queued.load(std::memory_order_relaxed) < job.max_queued) {
+      size_t mid = begin + (end - begin) / 2;
+      Node *child = node_spawn(job, mid, end);
+      if (!child)
+        break;
+      child->next = children;
+      children = child;
+      end = mid;
+    }
+
+    size_t stop = UTILS_MIN(begin + job.grain, end);
+    chunk_run(job, begin, stop, partial);
+    begin = stop;
+  }
+
+  /**
+   * @note The latest child is the nearest to the right, join left to right.
+   */
+  while (children) {
+    Node *child = children;
+    children = child->next;
+    node_wait(job, child);
+    if (partial && child->partial) {
+      job.args->join(partial, child->partial, job.args->ctx);
+    }
+    partial_free(job, child->partial);
+    node_release(child);
+  }
+}
+
+void node_main(void *arg) {
+  auto node = static_cast<Node *>(arg);
+  auto &job = *node->job;
+
+  job.nb_queued.fetch_sub(1, std::memory_order_relaxed);
+  range_run(job, node->begin, node->end, node->partial);
+  node->done.store(1, std::memory_order_release);
+  utils::futex::wake(&node->done);
+  node_release(node);
+}
+
+inline int job_run(Job &job, size_t begin, size_t end, size_t grain,
+                   void *result) {
+  const size_t nb_indexes = end - begin;
+  if (grain > 0 && nb_indexes <= grain) {
+    job.grain = grain;
+    chunk_run(job, begin, end, result);
+    return 0;
+  }
+
+  int ret = 0;
+  job.pool = default_pool(ret);
+  if (ret)
+    return ret;
+
+  const size_t nb_workers = threadpool::nb_workers(job.pool);
+  job.max_queued = nb_workers;
+  const size_t nb_chunks = (nb_workers + 1) * kChunksPerWorker;
+  job.grain = grain > 0 ? grain : UTILS_MAX(nb_indexes / nb_chunks, size_t {1});
+  range_run(job, begin, end, result);
+  return 0;
+}
+} // namespace
+} // namespace sirius
+
+using namespace sirius;
+
+extern "C" SIRIUS_API int ss_parallel_for(size_t begin, size_t end,
+                                          size_t grain,
+                                          ss_parallel_for_fn_t fn, void *ctx) {
+  if (!fn || begin > end) [[unlikely]]
+    return EINVAL;
+  if (begin == end)
+    return 0;
+
+  Job job {};
+  job.for_fn = fn;
+  job.for_ctx = ctx;
+  return job_run(job, begin, end, grain, nullptr);
+}
+
+extern "C" SIRIUS_API int
+ss_parallel_reduce(size_t begin, size_t end, size_t grain, void *result,
+                   const ss_parallel_reduce_args_t *args) {
+  if (!args || !args->body || !args->join || begin > end) [[unlikely]]
+    return EINVAL;
+  if (!result && args->partial_size > 0) [[unlikely]]
+    return EINVAL;
+  if (begin == end)
+    return 0;
+
+  void *identity = nullptr;
+  if (!args->init && args->partial_size > 0) {
+    identity = ::operator new(args->partial_size, std::nothrow);
+    if (!identity)
+      return ENOMEM;
+    std::memcpy(identity, result, args->partial_size);
+  }
+
+  Job job {};
+  job.args = args;
+  job.identity = identity;
+  int ret = job_run(job, begin, end, grain, result);
+  ::operator delete(identity);
+  return ret;
+}
@@ -7,6 +7,11 @@
 
 #include "sirius/thread/thread.h"
 
+#include <new>
+#include <sstream>
+
+#include "lib/thread/inner/cpu.hpp"
+#include "lib/thread/inner/stats.h"
 #include "utils/io.hpp"
 
 #define ERRNO_ERR(err_code, fn_str) \
@@ -71,6 +76,137 @@ inline int get_thread_policy(pthread_t thread, int *posix_policy) {
   }
   return sched_check(*posix_policy);
 }
+
+#if defined(__linux__)
+inline void cpu_set_to_posix(const ss_cpu_set_t &src, cpu_set_t &dst) {
+  CPU_ZERO(&dst);
+  for (size_t cpu = 0; cpu < SS_CPU_SETSIZE && cpu < CPU_SETSIZE; ++cpu) {
+    if (ss_cpu_set_has(&src, cpu)) {
+      CPU_SET(cpu, &dst);
+    }
+  }
+}
+
+inline void cpu_set_from_posix(const cpu_set_t &src, ss_cpu_set_t &dst) {
+  ss_cpu_set_zero(&dst);
+  for (size_t cpu = 0; cpu < SS_CPU_SETSIZE && cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &src)) {
+      ss_cpu_set_add(&dst, cpu);
+    }
+  }
+}
+
+/**
+ * @brief Read the context switches from `status`, and the last CPU from
+ * `stat` of the task.
+ */
+inline void task_stats(pid_t tid, ss_thread_stats_t &stats) {
+  const std::string dir = "/proc/self/task/" + std::to_string(tid);
+
+  std::ifstream status(dir + "/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    std::string_view view(line);
+    uint64_t *value;
+    if (view.starts_with("voluntary_ctxt_switches:")) {
+      value = &stats.nb_voluntary_switches;
+    } else if (view.starts_with("nonvoluntary_ctxt_switches:")) {
+      value = &stats.nb_involuntary_switches;
+    } else {
+      continue;
+    }
+    view.remove_prefix(view.find(':') + 1);
+    while (!view.empty() && (view.front() == ' ' || view.front() == '\t')) {
+      view.remove_prefix(1);
+    }
+    (void)std::from_chars(view.data(), view.data() + view.size(), *value);
+  }
+
+  /**
+   * @note `processor` is the 39th field. The fields are counted after the
+   * name, the 2nd one, which is parenthesized and may contain spaces.
+   */
+  std::string stat;
+  if (!cpu::file_read_line(dir + "/stat", stat))
+    return;
+  size_t name_end = stat.rfind(')');
+  if (name_end == std::string::npos)
+    return;
+  std::istringstream fields(stat.substr(name_end + 1));
+  std::string field;
+  for (int index = 3; index <= 39 && fields >> field; ++index) {
+    if (index == 39) {
+      (void)std::from_chars(field.data(), field.data() + field.size(),
+                            stats.last_cpu);
+    }
+  }
+}
+#endif
+
+/**
+ * @brief The CPUs of a new thread: `affinity`, narrowed to the NUMA node.
+ */
+inline int attr_cpus(const ss_thread_attr_t *attr, ss_cpu_set_t &cpus) {
+  cpus = attr->affinity;
+  if (attr->numa_policy == SsThreadNuma::kSsThreadNumaNone)
+    return 0;
+  if (attr->numa_policy != SsThreadNuma::kSsThreadNumaPreferred) {
+    logln_error("Invalid argument. `numa_policy`: {0}",
+                static_cast<int64_t>(attr->numa_policy));
+    return EINVAL;
+  }
+
+#if defined(__linux__)
+  ss_cpu_set_t node_cpus;
+  if (!cpu::numa_node_cpus(attr->numa_node, node_cpus)) {
+    logln_error("Invalid argument. `numa_node`: {0}", attr->numa_node);
+    return EINVAL;
+  }
+  if (ss_cpu_set_count(&cpus) == 0) {
+    cpus = node_cpus;
+    return 0;
+  }
+  for (size_t i = 0; i < SS_CPU_SETSIZE / 64; ++i) {
+    cpus.bits[i] &= node_cpus.bits[i];
+  }
+  if (ss_cpu_set_count(&cpus) == 0) {
+    logln_error("No CPU of `affinity` on NUMA node: {0}", attr->numa_node);
+    return EINVAL;
+  }
+  return 0;
+#else
+  logln_error("NUMA placement is not supported");
+  return ENOTSUP;
+#endif
+}
+
+/**
+ * @brief Start routine of the threads, which registers the new thread for
+ * `ss_thread_stats`, and sets the memory policy of the NUMA node, if any,
+ * from within the new thread.
+ */
+struct ThreadStart {
+  void *(*start_routine)(void *);
+  void *arg;
+  /**
+   * @note -1 without a NUMA node.
+   */
+  int node;
+};
+
+inline void *thread_start_routine(void *arg) {
+  ThreadStart start = *static_cast<ThreadStart *>(arg);
+  delete static_cast<ThreadStart *>(arg);
+
+  stats::register_self((ss_thread_t)(uintptr_t)pthread_self());
+  if (start.node >= 0) {
+    if (int ret = cpu::numa_prefer(start.node); ret) {
+      logln_warnsp("{0}", utils::io::Fmt::errno_err(ret, "set_mempolicy",
+                                                    "Node: {0}", start.node));
+    }
+  }
+  return start.start_routine(start.arg);
+}
 } // namespace
 } // namespace sirius
 
@@ -87,6 +223,8 @@ extern "C" SIRIUS_API int ss_thread_create(ss_thread_t *thread,
   int ret;
   pthread_attr_t thread_attr;
   size_t stack_size = attr ? attr->stacksize : 0;
+  int numa_node = -1;
+  ThreadStart *thread_start = nullptr;
 
   pthread_attr_init(&thread_attr);
   if (attr) {
@@ -168,13 +306,45 @@ extern "C" SIRIUS_API int ss_thread_create(ss_thread_t *thread,
       ERRNO_ERR(ret, "pthread_attr_setschedparam");
       goto label_free;
     }
+
+    ss_cpu_set_t cpus;
+    ret = attr_cpus(attr, cpus);
+    if (ret)
+      goto label_free;
+    if (ss_cpu_set_count(&cpus) > 0) {
+#if defined(__linux__) && defined(__GLIBC__)
+      cpu_set_t posix_cpus;
+      cpu_set_to_posix(cpus, posix_cpus);
+      ret = pthread_attr_setaffinity_np(&thread_attr, sizeof(posix_cpus),
+                                        &posix_cpus);
+      if (ret) {
+        ERRNO_ERR(ret, "pthread_attr_setaffinity_np");
+        goto label_free;
+      }
+#else
+      logln_error("CPU affinity of the attributes is not supported");
+      ret = ENOTSUP;
+      goto label_free;
+#endif
+    }
+
+    if (attr->numa_policy == SsThreadNuma::kSsThreadNumaPreferred) {
+      numa_node = attr->numa_node;
+    }
+  }
+
+  thread_start = new (std::nothrow) ThreadStart {start_routine, arg, numa_node};
+  if (!thread_start) {
+    ret = ENOMEM;
+    goto label_free;
   }
 
   pthread_t thr;
-  ret = pthread_create(&thr, &thread_attr, start_routine, arg);
+  ret = pthread_create(&thr, &thread_attr, thread_start_routine, thread_start);
   pthread_attr_destroy(&thread_attr);
   if (ret) {
     ERRNO_ERR(ret, "pthread_create");
+    delete thread_start;
     return ret;
   }
   *thread = (ss_thread_t)thr;
@@ -182,6 +352,7 @@ extern "C" SIRIUS_API int ss_thread_create(ss_thread_t *thread,
 
 label_free:
   pthread_attr_destroy(&thread_attr);
+  delete thread_start;
   return ret;
 }
 
@@ -287,3 +458,91 @@ ss_thread_getschedparam(ss_thread_t thread, ss_thread_sched_args_t *param) {
   param->priority = UTILS_MAX(posix_priority, SS_THREAD_PRIORITY_NONE);
   return 0;
 }
+
+extern "C" SIRIUS_API int ss_thread_setaffinity(ss_thread_t thread,
+                                                const ss_cpu_set_t *set) {
+  if (!set || ss_cpu_set_count(set) == 0)
+    return EINVAL;
+
+#if defined(__linux__)
+  cpu_set_t posix_cpus;
+  cpu_set_to_posix(*set, posix_cpus);
+  int ret = pthread_setaffinity_np((pthread_t)(uintptr_t)thread,
+                                   sizeof(posix_cpus), &posix_cpus);
+  if (ret) {
+    ERRNO_ERR(ret, "pthread_setaffinity_np");
+    return ret;
+  }
+  return 0;
+#else
+  (void)thread;
+  return ENOTSUP;
+#endif
+}
+
+extern "C" SIRIUS_API int ss_thread_getaffinity(ss_thread_t thread,
+                                                ss_cpu_set_t *set) {
+  if (!set)
+    return EINVAL;
+
+#if defined(__linux__)
+  cpu_set_t posix_cpus;
+  int ret = pthread_getaffinity_np((pthread_t)(uintptr_t)thread,
+                                   sizeof(posix_cpus), &posix_cpus);
+  if (ret) {
+    ERRNO_ERR(ret, "pthread_getaffinity_np");
+    return ret;
+  }
+  cpu_set_from_posix(posix_cpus, *set);
+  return 0;
+#else
+  (void)thread;
+  return ENOTSUP;
+#endif
+}
+
+extern "C" SIRIUS_API int ss_thread_stats(ss_thread_t thread,
+                                          ss_thread_stats_t *stats) {
+  if (!stats)
+    return EINVAL;
+
+  *stats = {};
+  stats->last_cpu = -1;
+  stats::Snapshot snapshot {};
+  bool registered = stats::get(thread, snapshot);
+  stats->wait_time_ns = snapshot.wait_time_ns;
+  stats->nb_waits = snapshot.nb_waits;
+
+#if defined(_POSIX_THREAD_CPUTIME) && _POSIX_THREAD_CPUTIME >= 0
+  clockid_t clock_id;
+  int ret = pthread_getcpuclockid((pthread_t)(uintptr_t)thread, &clock_id);
+  if (ret) {
+    ERRNO_ERR(ret, "pthread_getcpuclockid");
+    return ret;
+  }
+  struct timespec ts;
+  if (clock_gettime(clock_id, &ts)) {
+    ret = errno;
+    ERRNO_ERR(ret, "clock_gettime");
+    return ret;
+  }
+  stats->cpu_time_ns =
+    (uint64_t)ts.tv_sec * SS_CLOCK_NS_PER_S + (uint64_t)ts.tv_nsec;
+
+#  if defined(__linux__)
+  if (!registered &&
+      pthread_equal((pthread_t)(uintptr_t)thread, pthread_self())) {
+    snapshot.tid = utils::thread::get_tid_impl();
+    registered = true;
+  }
+  if (registered) {
+    task_stats(static_cast<pid_t>(snapshot.tid), *stats);
+  }
+#  else
+  (void)registered;
+#  endif
+  return 0;
+#else
+  return ENOTSUP;
+#endif
+}
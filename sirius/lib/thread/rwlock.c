@@ -0,0 +1,255 @@
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include "sirius/thread/rwlock.h"
+
+#include "lib/thread/inner/futex.h"
+#include "sirius/thread/thread.h"
+#include "utils/attributes.h"
+#include "utils/utils.h"
+
+/**
+ * @brief Bits of `state`. For `kSsRwlockTypeNormal`, the low bits count the
+ * readers.
+ */
+#define RWLOCK_READERS_MASK 0x3FFFFFFFU
+#define RWLOCK_WRITER 0x40000000U
+#define RWLOCK_READERS_WAITING 0x80000000U
+
+#define RWLOCK_SLOT_SIZE 64
+#define RWLOCK_SLOTS_MAX 256
+
+/**
+ * @brief A reader counter of `kSsRwlockTypeDistributed`, alone on its cache
+ * line.
+ */
+typedef struct {
+  uint32_t count;
+  unsigned char padding[RWLOCK_SLOT_SIZE - sizeof(uint32_t)];
+} ss_rwlock_slot_s;
+
+typedef struct {
+  /**
+   * @brief The readers wait on it for the writer.
+   */
+  uint32_t state;
+
+  /**
+   * @brief Bumped by a reader which leaves while a writer holds the lock, the
+   * writer waits on it for the readers.
+   */
+  uint32_t drain;
+
+  /**
+   * @brief Mutual exclusion of the writers.
+   */
+  uint32_t writer_lock;
+
+  enum SsRwlockType type;
+
+  ss_rwlock_slot_s *slots;
+  void *slots_memory;
+  uint32_t slots_mask;
+} ss_rwlock_s;
+
+utils_check_sizeof(ss_rwlock_t, ss_rwlock_s);
+utils_check_alignof(ss_rwlock_t, ss_rwlock_s);
+
+static inline uint32_t rwlock_nb_cpus() {
+#if defined(_WIN32) || defined(_WIN64)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? (uint32_t)info.dwNumberOfProcessors
+                                       : 1;
+#else
+  long nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  return nb_cpus > 0 ? (uint32_t)nb_cpus : 1;
+#endif
+}
+
+/**
+ * @note The slot of a thread never changes, so a reader leaves on the slot
+ * it entered on, wherever it runs by then.
+ */
+static inline uint32_t *rwlock_slot(ss_rwlock_s *l) {
+  uint64_t hash = ss_thread_id() * 0x9E3779B97F4A7C15ULL;
+  return &l->slots[(uint32_t)(hash >> 32) & l->slots_mask].count;
+}
+
+static inline uint32_t rwlock_nb_readers(ss_rwlock_s *l) {
+  if (l->type != kSsRwlockTypeDistributed)
+    return ss_futex_load_seq_cst(&l->state) & RWLOCK_READERS_MASK;
+
+  uint32_t nb_readers = 0;
+  for (uint32_t i = 0; i <= l->slots_mask; ++i) {
+    nb_readers += ss_futex_load_seq_cst(&l->slots[i].count);
+  }
+  return nb_readers;
+}
+
+static inline void rwlock_drain_notify(ss_rwlock_s *l) {
+  (void)ss_futex_fetch_add(&l->drain, 1);
+  ss_futex_wake_one(&l->drain);
+}
+
+/**
+ * @brief Sleep until the writer observed in `state` leaves.
+ */
+static inline void rwlock_writer_wait(ss_rwlock_s *l, uint32_t state) {
+  if (!(state & RWLOCK_READERS_WAITING)) {
+    uint32_t desired = state | RWLOCK_READERS_WAITING;
+    if (ss_futex_cas(&l->state, state, desired) != state)
+      return;
+    state = desired;
+  }
+  ss_futex_wait(&l->state, state);
+}
+
+/**
+ * @return 0 if entered, `EBUSY` if a writer holds or waits for the lock.
+ */
+static inline int rwlock_rdenter(ss_rwlock_s *l, uint32_t *state) {
+  *state = ss_futex_load(&l->state);
+  if (*state & RWLOCK_WRITER)
+    return EBUSY;
+
+  if (l->type != kSsRwlockTypeDistributed) {
+    if ((*state & RWLOCK_READERS_MASK) == RWLOCK_READERS_MASK)
+      return EAGAIN;
+    return ss_futex_cas(&l->state, *state, *state + 1) == *state ? 0 : EINTR;
+  }
+
+  /**
+   * @note Either the writer sees this slot, or this reader sees the writer.
+   */
+  uint32_t *slot = rwlock_slot(l);
+  (void)ss_futex_fetch_add(slot, 1);
+  *state = ss_futex_load_seq_cst(&l->state);
+  if (ss_likely(!(*state & RWLOCK_WRITER)))
+    return 0;
+
+  (void)ss_futex_fetch_add(slot, (uint32_t)-1);
+  rwlock_drain_notify(l);
+  return EBUSY;
+}
+
+SIRIUS_API int ss_rwlock_init(ss_rwlock_t *rwlock,
+                              const enum SsRwlockType *type) {
+  ss_rwlock_s *l = (ss_rwlock_s *)rwlock;
+  memset(l, 0, sizeof(ss_rwlock_s));
+  l->type = type ? *type : kSsRwlockTypeNormal;
+  if (l->type != kSsRwlockTypeDistributed)
+    return l->type == kSsRwlockTypeNormal ? 0 : EINVAL;
+
+  uint32_t nb_slots =
+    (uint32_t)utils_next_power_of_2((size_t)rwlock_nb_cpus() * 2);
+  nb_slots = UTILS_MIN(nb_slots, RWLOCK_SLOTS_MAX);
+
+  l->slots_memory = calloc(1, nb_slots * sizeof(ss_rwlock_slot_s) +
+                                RWLOCK_SLOT_SIZE - 1);
+  if (!l->slots_memory)
+    return ENOMEM;
+  l->slots = (ss_rwlock_slot_s *)(((uintptr_t)l->slots_memory +
+                                   RWLOCK_SLOT_SIZE - 1) &
+                                  ~(uintptr_t)(RWLOCK_SLOT_SIZE - 1));
+  l->slots_mask = nb_slots - 1;
+  return 0;
+}
+
+SIRIUS_API int ss_rwlock_destroy(ss_rwlock_t *rwlock) {
+  ss_rwlock_s *l = (ss_rwlock_s *)rwlock;
+  if ((ss_futex_load(&l->state) & RWLOCK_WRITER) || rwlock_nb_readers(l))
+    return EBUSY;
+
+  free(l->slots_memory);
+  l->slots_memory = nullptr;
+  l->slots = nullptr;
+  return 0;
+}
+
+SIRIUS_API int ss_rwlock_rdlock(ss_rwlock_t *rwlock) {
+  ss_rwlock_s *l = (ss_rwlock_s *)rwlock;
+  uint32_t state;
+
+  for (;;) {
+    int ret = rwlock_rdenter(l, &state);
+    if (ss_likely(ret == 0))
+      return 0;
+    if (ret == EAGAIN)
+      return ret;
+    if (ret == EBUSY) {
+      rwlock_writer_wait(l, state);
+    }
+  }
+}
+
+SIRIUS_API int ss_rwlock_tryrdlock(ss_rwlock_t *rwlock) {
+  ss_rwlock_s *l = (ss_rwlock_s *)rwlock;
+  uint32_t state;
+
+  for (;;) {
+    int ret = rwlock_rdenter(l, &state);
+    if (ret != EINTR)
+      return ret;
+  }
+}
+
+SIRIUS_API int ss_rwlock_rdunlock(ss_rwlock_t *rwlock) {
+  ss_rwlock_s *l = (ss_rwlock_s *)rwlock;
+
+  if (l->type != kSsRwlockTypeDistributed) {
+    uint32_t state = ss_futex_fetch_add(&l->state, (uint32_t)-1);
+    if ((state & RWLOCK_WRITER) && (state & RWLOCK_READERS_MASK) == 1) {
+      rwlock_drain_notify(l);
+    }
+    return 0;
+  }
+
+  (void)ss_futex_fetch_add(rwlock_slot(l), (uint32_t)-1);
+  if (ss_futex_load_seq_cst(&l->state) & RWLOCK_WRITER) {
+    rwlock_drain_notify(l);
+  }
+  return 0;
+}
+
+SIRIUS_API int ss_rwlock_wrlock(ss_rwlock_t *rwlock) {
+  ss_rwlock_s *l = (ss_rwlock_s *)rwlock;
+
+  ss_futex_lock(&l->writer_lock, nullptr);
+  /**
+   * @note From here on, the new readers wait.
+   */
+  (void)ss_futex_fetch_or(&l->state, RWLOCK_WRITER);
+  for (;;) {
+    uint32_t drain = ss_futex_load_seq_cst(&l->drain);
+    if (rwlock_nb_readers(l) == 0)
+      return 0;
+    ss_futex_wait(&l->drain, drain);
+  }
+}
+
+SIRIUS_API int ss_rwlock_trywrlock(ss_rwlock_t *rwlock) {
+  ss_rwlock_s *l = (ss_rwlock_s *)rwlock;
+
+  if (ss_futex_trylock(&l->writer_lock))
+    return EBUSY;
+  (void)ss_futex_fetch_or(&l->state, RWLOCK_WRITER);
+  if (rwlock_nb_readers(l) == 0)
+    return 0;
+
+  (void)ss_rwlock_wrunlock(rwlock);
+  return EBUSY;
+}
+
+SIRIUS_API int ss_rwlock_wrunlock(ss_rwlock_t *rwlock) {
+  ss_rwlock_s *l = (ss_rwlock_s *)rwlock;
+
+  uint32_t state = ss_futex_fetch_and(
+    &l->state, ~(uint32_t)(RWLOCK_WRITER | RWLOCK_READERS_WAITING));
+  if (state & RWLOCK_READERS_WAITING) {
+    ss_futex_wake_all(&l->state);
+  }
+  ss_futex_unlock(&l->writer_lock);
+  return 0;
+}
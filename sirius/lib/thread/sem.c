@@ -4,6 +4,8 @@
 
 #include "lib/thread/sem.h"
 
+#include "lib/thread/inner/stats.h"
+
 SIRIUS_API int ss_sem_init(ss_sem_t *sem, int pshared, unsigned int value) {
   return ss_sem_init_impl(sem, pshared, value);
 }
@@ -13,7 +15,9 @@ SIRIUS_API int ss_sem_destroy(ss_sem_t *sem) {
 }
 
 SIRIUS_API int ss_sem_wait(ss_sem_t *sem) {
-  return ss_sem_wait_impl(sem);
+  int ret;
+  SS_THREAD_WAIT_ACCOUNT(ret, ss_sem_wait_impl(sem));
+  return ret;
 }
 
 SIRIUS_API int ss_sem_trywait(ss_sem_t *sem) {
@@ -21,7 +25,15 @@ SIRIUS_API int ss_sem_trywait(ss_sem_t *sem) {
 }
 
 SIRIUS_API int ss_sem_timedwait(ss_sem_t *sem, uint64_t milliseconds) {
-  return ss_sem_timedwait_impl(sem, milliseconds);
+  int ret;
+  SS_THREAD_WAIT_ACCOUNT(ret, ss_sem_timedwait_impl(sem, milliseconds));
+  return ret;
+}
+
+SIRIUS_API int ss_sem_wait_until(ss_sem_t *sem, uint64_t deadline_ns) {
+  int ret;
+  SS_THREAD_WAIT_ACCOUNT(ret, ss_sem_wait_until_impl(sem, deadline_ns));
+  return ret;
 }
 
 SIRIUS_API int ss_sem_post(ss_sem_t *sem) {
@@ -3,6 +3,7 @@
 #include "utils/decls.h"
 /* clang-format on */
 
+#include "lib/thread/inner/clock.h"
 #include "sirius/thread/sem.h"
 #include "utils/attributes.h"
 #include "utils/errno.h"
@@ -114,6 +115,13 @@ static inline int ss_sem_timedwait_impl(ss_sem_t *sem, uint64_t milliseconds) {
   return ETIMEDOUT;
 }
 
+static inline int ss_sem_wait_until_impl(ss_sem_t *sem, uint64_t deadline_ns) {
+  uint64_t milliseconds = ss_clock_remaining_ms(deadline_ns);
+  if (milliseconds == 0)
+    return ETIMEDOUT;
+  return ss_sem_timedwait_impl(sem, milliseconds);
+}
+
 static inline int ss_sem_post_impl(ss_sem_t *sem) {
   BOOL ok = ReleaseSemaphore(*((HANDLE *)sem), 1, nullptr);
   if (!ok)
@@ -151,25 +159,41 @@ static inline int ss_sem_trywait_impl(ss_sem_t *sem) {
   return sem_trywait((sem_t *)sem) == 0 ? 0 : errno;
 }
 
-static inline int ss_sem_timedwait_impl(ss_sem_t *sem, uint64_t milliseconds) {
+/**
+ * @note `sem_clockwait` is since glibc 2.30, and only declared with
+ * `_GNU_SOURCE`, else the `sem_timedwait` on `CLOCK_REALTIME`.
+ */
+#  if defined(__GLIBC__) && defined(__USE_GNU) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+#    define SS_SEM_CLOCKWAIT 1
+#  else
+#    define SS_SEM_CLOCKWAIT 0
+#  endif
+
+static inline int ss_sem_wait_until_impl(ss_sem_t *sem, uint64_t deadline_ns) {
+  int ret;
   struct timespec ts;
-  if (clock_gettime(CLOCK_REALTIME, &ts))
-    return errno;
-
-  ts.tv_sec += (time_t)(milliseconds / 1000);
-  ts.tv_nsec += (long)((milliseconds % 1000) * 1000000L);
-  if (ts.tv_nsec >= 1000000000L) {
-    ts.tv_sec += ts.tv_nsec / 1000000000L;
-    ts.tv_nsec = ts.tv_nsec % 1000000000L;
-  }
 
-  int ret;
+#  if SS_SEM_CLOCKWAIT
+  if ((ret = ss_clock_timespec(&ts, CLOCK_MONOTONIC, deadline_ns)))
+    return ret;
+  do {
+    ret = sem_clockwait((sem_t *)sem, CLOCK_MONOTONIC, &ts);
+  } while (ret == -1 && errno == EINTR);
+#  else
+  if ((ret = ss_clock_timespec(&ts, CLOCK_REALTIME, deadline_ns)))
+    return ret;
   do {
     ret = sem_timedwait((sem_t *)sem, &ts);
   } while (ret == -1 && errno == EINTR);
+#  endif
   return ret == 0 ? 0 : errno;
 }
 
+static inline int ss_sem_timedwait_impl(ss_sem_t *sem, uint64_t milliseconds) {
+  return ss_sem_wait_until_impl(sem, ss_clock_deadline_ns(milliseconds));
+}
+
 static inline int ss_sem_post_impl(ss_sem_t *sem) {
   return sem_post((sem_t *)sem) == 0 ? 0 : errno;
 }
@@ -0,0 +1,58 @@
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include "sirius/thread/seqlock.h"
+
+#include "lib/thread/inner/futex.h"
+
+/**
+ * @brief Spins of a reader on a writer in progress, before it yields.
+ */
+#define SEQLOCK_READ_SPINS 100
+
+SIRIUS_API int ss_seqlock_init(ss_seqlock_t *seqlock) {
+  seqlock->__seq = 0;
+  seqlock->__lock = kSsFutexUnlocked;
+  return 0;
+}
+
+SIRIUS_API uint32_t ss_seqlock_read_begin(const ss_seqlock_t *seqlock) {
+  volatile uint32_t *seq = (volatile uint32_t *)&seqlock->__seq;
+  uint32_t s;
+  int nb_spins = 0;
+
+  while ((s = ss_futex_load_acquire(seq)) & 1) {
+    if (++nb_spins < SEQLOCK_READ_SPINS) {
+      ss_cpu_pause();
+    } else {
+      ss_os_yield();
+    }
+  }
+  return s;
+}
+
+SIRIUS_API int ss_seqlock_read_retry(const ss_seqlock_t *seqlock,
+                                     uint32_t seq) {
+  /**
+   * @note Orders the reads of the data before the read of the sequence.
+   */
+  ss_futex_fence_acquire();
+  return ss_futex_load((volatile uint32_t *)&seqlock->__seq) != seq;
+}
+
+SIRIUS_API int ss_seqlock_write_lock(ss_seqlock_t *seqlock) {
+  ss_futex_lock(&seqlock->__lock, nullptr);
+  (void)ss_futex_fetch_add(&seqlock->__seq, 1);
+  /**
+   * @note Orders the odd sequence before the writes of the data.
+   */
+  ss_futex_fence_release();
+  return 0;
+}
+
+SIRIUS_API int ss_seqlock_write_unlock(ss_seqlock_t *seqlock) {
+  (void)ss_futex_fetch_add(&seqlock->__seq, 1);
+  ss_futex_unlock(&seqlock->__lock);
+  return 0;
+}
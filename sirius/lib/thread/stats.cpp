@@ -0,0 +1,130 @@
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include "lib/thread/inner/stats.h"
+
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+#include "utils/thread.hpp"
+
+volatile uint32_t _ss_thread_wait_accounting_on = 0;
+
+namespace sirius {
+namespace stats {
+namespace {
+struct Record {
+  uint64_t tid = 0;
+  std::atomic<uint64_t> wait_time_ns {0};
+  std::atomic<uint64_t> nb_waits {0};
+};
+
+/**
+ * @note
+ * - (1) It lives until the process exits, the `thread_local` records of the
+ * last threads may be destroyed after the static objects.
+ *
+ * - (2) Reached from C, e.g. an accounted wait of `mutex.c`, so nothing
+ * throws out of it: a thread that cannot be registered is left out.
+ */
+class Registry {
+ public:
+  static Registry *instance() noexcept {
+    static auto *registry = new (std::nothrow) Registry();
+    return registry;
+  }
+
+  bool add(ss_thread_t thread, Record *record) noexcept {
+    try {
+      std::lock_guard<std::mutex> lock(mutex_);
+      records_[thread] = record;
+      return true;
+    } catch (...) {
+      return false;
+    }
+  }
+
+  void remove(ss_thread_t thread, Record *record) noexcept {
+    try {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = records_.find(thread);
+      if (it != records_.end() && it->second == record) {
+        records_.erase(it);
+      }
+    } catch (...) {
+    }
+  }
+
+  bool get(ss_thread_t thread, Snapshot &snapshot) noexcept {
+    try {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = records_.find(thread);
+      if (it == records_.end())
+        return false;
+      snapshot.tid = it->second->tid;
+      snapshot.wait_time_ns =
+        it->second->wait_time_ns.load(std::memory_order_relaxed);
+      snapshot.nb_waits =
+        it->second->nb_waits.load(std::memory_order_relaxed);
+      return true;
+    } catch (...) {
+      return false;
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<ss_thread_t, Record *> records_;
+};
+
+struct Registration {
+  ss_thread_t thread = nullptr;
+  bool registered = false;
+  Record record;
+
+  ~Registration() {
+    if (registered) {
+      Registry::instance()->remove(thread, &record);
+    }
+  }
+};
+
+thread_local Registration tls_registration;
+} // namespace
+
+void register_self(ss_thread_t self) noexcept {
+  Registration &registration = tls_registration;
+  if (ss_likely(registration.registered) || !self)
+    return;
+
+  Registry *registry = Registry::instance();
+  registration.thread = self;
+  registration.record.tid = utils::thread::get_tid_impl();
+  registration.registered =
+    registry && registry->add(self, &registration.record);
+}
+
+bool get(ss_thread_t thread, Snapshot &snapshot) noexcept {
+  Registry *registry = Registry::instance();
+  return registry && registry->get(thread, snapshot);
+}
+} // namespace stats
+} // namespace sirius
+
+using namespace sirius;
+
+extern "C" void _ss_thread_wait_add(uint64_t nanoseconds) {
+  stats::Registration &registration = stats::tls_registration;
+  if (ss_unlikely(!registration.registered)) {
+    stats::register_self(ss_thread_self());
+  }
+  registration.record.wait_time_ns.fetch_add(nanoseconds,
+                                             std::memory_order_relaxed);
+  registration.record.nb_waits.fetch_add(1, std::memory_order_relaxed);
+}
+
+extern "C" SIRIUS_API void ss_thread_wait_accounting(int enable) {
+  ss_futex_store(&_ss_thread_wait_accounting_on, enable ? 1 : 0);
+}
@@ -0,0 +1,580 @@
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include "sirius/thread/threadpool.h"
+
+#include <bit>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "lib/thread/inner/threadpool.hpp"
+#include "sirius/foundation/sync.h"
+#include "utils/futex.hpp"
+#include "utils/io.hpp"
+
+namespace sirius {
+namespace {
+inline constexpr size_t kCacheLineSize = 64;
+inline constexpr size_t kDequeCapacityDefault = 4096;
+
+/**
+ * @brief Rounds of search, each followed by a yield, before a worker parks.
+ */
+inline constexpr int kIdleRounds = 64;
+
+using Task = ss_threadpool_task_t;
+
+/**
+ * @brief Chase-Lev work-stealing deque, with the C11 memory orderings of
+ * Lê et al., "Correct and Efficient Work-Stealing for Weak Memory Models".
+ *
+ * @note
+ * - (1) The owner pushes and takes at the bottom, the thieves steal at the
+ * top. The capacity is fixed, `push` fails when the deque is full.
+ *
+ * - (2) A slot is read by a thief before its claim is confirmed, so the task
+ * is stored as two relaxed atomics instead of a plain struct.
+ */
+class Deque {
+ public:
+  explicit Deque(size_t capacity)
+      : mask_(capacity - 1), slots_(std::make_unique<Slot[]>(capacity)) {}
+
+  bool push(const Task &task) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    if (b - t > static_cast<int64_t>(mask_))
+      return false;
+
+    store(b, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool take(Task &task) {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+
+    load(b, task);
+    if (t < b)
+      return true;
+
+    /**
+     * @note The last task, race the thieves for it.
+     */
+    bool won = top_.compare_exchange_strong(t, t + 1,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  /**
+   * @note May fail on a lost race even if the deque is not empty.
+   */
+  bool steal(Task &task) {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b)
+      return false;
+
+    load(t, task);
+    return top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed);
+  }
+
+  /**
+   * @note Only a hint.
+   */
+  bool empty() const {
+    return top_.load(std::memory_order_relaxed) >=
+      bottom_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Slot {
+    std::atomic<ss_threadpool_fn_t> fn {nullptr};
+    std::atomic<void *> arg {nullptr};
+  };
+
+  alignas(kCacheLineSize) std::atomic<int64_t> top_ {0};
+  alignas(kCacheLineSize) std::atomic<int64_t> bottom_ {0};
+  alignas(kCacheLineSize) const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+
+  void store(int64_t index, const Task &task) {
+    auto &slot = slots_[static_cast<size_t>(index) & mask_];
+    slot.fn.store(task.fn, std::memory_order_relaxed);
+    slot.arg.store(task.arg, std::memory_order_relaxed);
+  }
+
+  void load(int64_t index, Task &task) const {
+    const auto &slot = slots_[static_cast<size_t>(index) & mask_];
+    task.fn = slot.fn.load(std::memory_order_relaxed);
+    task.arg = slot.arg.load(std::memory_order_relaxed);
+  }
+};
+
+/**
+ * @brief Tasks submitted to a worker from outside the pool, and the overflow
+ * of its deque.
+ */
+class Inbox {
+ public:
+  void put(const Task *tasks, size_t nb_tasks) {
+    auto lock = std::lock_guard(mutex_);
+    tasks_.insert(tasks_.end(), tasks, tasks + nb_tasks);
+    size_.store(tasks_.size(), std::memory_order_release);
+  }
+
+  /**
+   * @brief Take one task, and move as many of the rest as fit into `deque`,
+   * where the thieves reach them without the lock.
+   *
+   * @note Only the owner of `deque` may call it.
+   */
+  bool drain(Deque &deque, Task &task) {
+    if (size_.load(std::memory_order_acquire) == 0)
+      return false;
+
+    auto lock = std::lock_guard(mutex_);
+    if (tasks_.empty())
+      return false;
+    task = tasks_.front();
+    tasks_.pop_front();
+    while (!tasks_.empty() && deque.push(tasks_.front())) {
+      tasks_.pop_front();
+    }
+    size_.store(tasks_.size(), std::memory_order_release);
+    return true;
+  }
+
+  bool steal(Task &task) {
+    if (size_.load(std::memory_order_acquire) == 0)
+      return false;
+
+    auto lock = std::unique_lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || tasks_.empty())
+      return false;
+    task = tasks_.front();
+    tasks_.pop_front();
+    size_.store(tasks_.size(), std::memory_order_release);
+    return true;
+  }
+
+ private:
+  std::mutex mutex_ {};
+  std::deque<Task> tasks_ {};
+  std::atomic<size_t> size_ {0};
+};
+
+struct Worker {
+  Worker(ss_threadpool_t *pool, size_t index, size_t capacity)
+      : pool(pool),
+        index(index),
+        seed(0x9e3779b97f4a7c15ULL * (index + 1)),
+        deque(capacity) {}
+
+  ss_threadpool_t *const pool;
+  const size_t index;
+
+  /**
+   * @brief State of the xorshift which picks the first victim.
+   */
+  uint64_t seed;
+
+  ss_thread_t thread {};
+  Deque deque;
+  Inbox inbox;
+};
+
+/**
+ * @brief The worker running on the calling thread, if any.
+ */
+thread_local Worker *tls_worker = nullptr;
+} // namespace
+} // namespace sirius
+
+struct ss_threadpool_s {
+  std::vector<std::unique_ptr<sirius::Worker>> workers {};
+
+  /**
+   * @brief Tasks submitted and not finished yet.
+   */
+  alignas(sirius::kCacheLineSize) std::atomic<uint64_t> nb_pending {0};
+
+  /**
+   * @brief Futex of the parked workers, bumped by a submission only when
+   * `nb_parked` is not 0.
+   */
+  alignas(sirius::kCacheLineSize) std::atomic<uint32_t> work_epoch {0};
+  std::atomic<uint32_t> nb_parked {0};
+
+  /**
+   * @brief Futex of `ss_threadpool_wait_idle`, bumped when `nb_pending`
+   * drops to 0.
+   */
+  alignas(sirius::kCacheLineSize) std::atomic<uint32_t> idle_epoch {0};
+  std::atomic<uint32_t> nb_idle_waiters {0};
+
+  alignas(sirius::kCacheLineSize) std::atomic<size_t> next_inbox {0};
+  std::atomic<bool> stop {false};
+};
+
+namespace sirius {
+namespace {
+/**
+ * @note Pairs with the `seq_cst` fence in `worker_park`: either the submitter
+ * sees the parked worker, or the worker sees the submitted task.
+ */
+inline void work_notify(ss_threadpool_t *pool, size_t count) {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (pool->nb_parked.load(std::memory_order_relaxed) == 0)
+    return;
+
+  pool->work_epoch.fetch_add(1, std::memory_order_seq_cst);
+  utils::futex::wake(&pool->work_epoch,
+                     static_cast<int>(UTILS_MIN(count, size_t {INT_MAX})));
+}
+
+inline void pending_done(ss_threadpool_t *pool, uint64_t count) {
+  if (pool->nb_pending.fetch_sub(count, std::memory_order_seq_cst) != count)
+    return;
+
+  pool->idle_epoch.fetch_add(1, std::memory_order_seq_cst);
+  if (pool->nb_idle_waiters.load(std::memory_order_seq_cst) > 0) {
+    utils::futex::wake(&pool->idle_epoch);
+  }
+}
+
+inline bool worker_steal(Worker *self, Task &task) {
+  const auto &workers = self->pool->workers;
+  const size_t nb_workers = workers.size();
+
+  self->seed ^= self->seed << 13;
+  self->seed ^= self->seed >> 7;
+  self->seed ^= self->seed << 17;
+  const size_t start = static_cast<size_t>(self->seed % nb_workers);
+  for (size_t i = 0; i < nb_workers; ++i) {
+    auto &victim = *workers[(start + i) % nb_workers];
+    if (&victim == self)
+      continue;
+    if (victim.deque.steal(task) || victim.inbox.steal(task)) {
+      /**
+       * @note Wake one more thief while there is something left to steal,
+       * so the parked workers join one by one.
+       */
+      if (!victim.deque.empty()) {
+        work_notify(self->pool, 1);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+inline bool worker_find(Worker *self, Task &task) {
+  if (self->deque.take(task))
+    return true;
+  if (self->inbox.drain(self->deque, task)) {
+    if (!self->deque.empty()) {
+      work_notify(self->pool, 1);
+    }
+    return true;
+  }
+  return worker_steal(self, task);
+}
+
+inline void worker_run(ss_threadpool_t *pool, const Task &task) {
+  task.fn(task.arg);
+  pending_done(pool, 1);
+}
+
+/**
+ * @return `false` once the pool is stopping.
+ */
+inline bool worker_park(Worker *self, Task &task, bool &found) {
+  auto pool = self->pool;
+
+  pool->nb_parked.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  uint32_t epoch = pool->work_epoch.load(std::memory_order_seq_cst);
+  bool stop = pool->stop.load(std::memory_order_seq_cst);
+  found = !stop && worker_find(self, task);
+  if (!stop && !found) {
+    (void)utils::futex::wait(&pool->work_epoch, epoch);
+  }
+  pool->nb_parked.fetch_sub(1, std::memory_order_relaxed);
+  return !stop;
+}
+
+void *worker_main(void *arg) {
+  auto self = static_cast<Worker *>(arg);
+  auto pool = self->pool;
+  tls_worker = self;
+
+  Task task {};
+  int idle = 0;
+  for (;;) {
+    if (worker_find(self, task)) {
+      worker_run(pool, task);
+      idle = 0;
+      continue;
+    }
+    if (++idle < kIdleRounds) {
+      ss_os_yield();
+      continue;
+    }
+
+    idle = 0;
+    bool found = false;
+    if (!worker_park(self, task, found))
+      break;
+    if (found) {
+      worker_run(pool, task);
+    }
+  }
+
+  tls_worker = nullptr;
+  return nullptr;
+}
+
+/**
+ * @brief Stop the workers and join the first `nb_started` of them.
+ */
+inline int pool_stop(ss_threadpool_t *pool, size_t nb_started) {
+  pool->stop.store(true, std::memory_order_seq_cst);
+  pool->work_epoch.fetch_add(1, std::memory_order_seq_cst);
+  utils::futex::wake(&pool->work_epoch);
+
+  int ret = 0;
+  for (size_t i = 0; i < nb_started; ++i) {
+    int join_ret = ss_thread_join(pool->workers[i]->thread, nullptr);
+    if (join_ret) {
+      logln_error("ss_thread_join: {0}", join_ret);
+      ret = ret ? ret : join_ret;
+    }
+  }
+  return ret;
+}
+
+inline bool is_worker_of(ss_threadpool_t *pool) {
+  return tls_worker && tls_worker->pool == pool;
+}
+} // namespace
+
+namespace threadpool {
+size_t nb_workers(ss_threadpool_t *pool) {
+  return pool->workers.size();
+}
+
+bool is_worker(ss_threadpool_t *pool) {
+  return is_worker_of(pool);
+}
+
+bool help(ss_threadpool_t *pool) {
+  if (!is_worker_of(pool))
+    return false;
+
+  Task task {};
+  if (!worker_find(tls_worker, task))
+    return false;
+  worker_run(pool, task);
+  return true;
+}
+} // namespace threadpool
+} // namespace sirius
+
+using namespace sirius;
+
+extern "C" SIRIUS_API int
+ss_threadpool_create(ss_threadpool_t **__restrict pool,
+                     const ss_threadpool_args_t *__restrict args) {
+  if (!pool) [[unlikely]] {
+    logln_error("Null pointer");
+    return EINVAL;
+  }
+
+  size_t nb_workers = args ? args->nb_workers : 0;
+  if (nb_workers == 0) {
+    nb_workers = UTILS_MAX(std::thread::hardware_concurrency(), 1U);
+  }
+  size_t capacity = args && args->deque_capacity ? args->deque_capacity
+                                                 : kDequeCapacityDefault;
+  capacity = std::bit_ceil(UTILS_MAX(capacity, size_t {2}));
+
+  ss_thread_attr_t attr {};
+  const ss_thread_attr_t *pattr = nullptr;
+  if (args && args->thread_attr) {
+    attr = *args->thread_attr;
+    attr.detach_state = SsThreadCreate::kSsThreadCreateJoinable;
+    pattr = &attr;
+  }
+
+  std::unique_ptr<ss_threadpool_t> p;
+  try {
+    p = std::make_unique<ss_threadpool_t>();
+    p->workers.reserve(nb_workers);
+    for (size_t i = 0; i < nb_workers; ++i) {
+      p->workers.push_back(std::make_unique<Worker>(p.get(), i, capacity));
+    }
+  } catch (const std::bad_alloc &) {
+    logln_error("Out of memory. `nb_workers`: {0}; `deque_capacity`: {1}",
+                nb_workers, capacity);
+    return ENOMEM;
+  }
+
+  for (size_t i = 0; i < nb_workers; ++i) {
+    auto &worker = *p->workers[i];
+    int ret = ss_thread_create(&worker.thread, pattr, worker_main, &worker);
+    if (ret) {
+      logln_error("ss_thread_create: {0}", ret);
+      (void)pool_stop(p.get(), i);
+      return ret;
+    }
+  }
+
+  *pool = p.release();
+  return 0;
+}
+
+extern "C" SIRIUS_API int ss_threadpool_destroy(ss_threadpool_t *pool) {
+  if (!pool) [[unlikely]]
+    return EINVAL;
+  if (is_worker_of(pool)) [[unlikely]] {
+    logln_error("Destroyed from a worker of the pool");
+    return EDEADLK;
+  }
+
+  (void)ss_threadpool_wait_idle(pool, kSsTimeoutInfinite);
+  int ret = pool_stop(pool, pool->workers.size());
+  delete pool;
+  return ret;
+}
+
+extern "C" SIRIUS_API int ss_threadpool_submit(ss_threadpool_t *pool,
+                                               ss_threadpool_fn_t fn,
+                                               void *arg) {
+  if (!pool || !fn) [[unlikely]]
+    return EINVAL;
+
+  const Task task {fn, arg};
+  pool->nb_pending.fetch_add(1, std::memory_order_relaxed);
+  if (is_worker_of(pool) && tls_worker->deque.push(task)) {
+    work_notify(pool, 1);
+    return 0;
+  }
+
+  auto &workers = pool->workers;
+  auto &worker = is_worker_of(pool)
+    ? *tls_worker
+    : *workers[pool->next_inbox.fetch_add(1, std::memory_order_relaxed) %
+               workers.size()];
+  try {
+    worker.inbox.put(&task, 1);
+  } catch (const std::bad_alloc &) {
+    pending_done(pool, 1);
+    return ENOMEM;
+  }
+  work_notify(pool, 1);
+  return 0;
+}
+
+extern "C" SIRIUS_API int
+ss_threadpool_submit_batch(ss_threadpool_t *pool,
+                           const ss_threadpool_task_t *tasks,
+                           size_t nb_tasks) {
+  if (!pool || (!tasks && nb_tasks > 0)) [[unlikely]]
+    return EINVAL;
+  for (size_t i = 0; i < nb_tasks; ++i) {
+    if (!tasks[i].fn) [[unlikely]]
+      return EINVAL;
+  }
+  if (nb_tasks == 0)
+    return 0;
+
+  pool->nb_pending.fetch_add(nb_tasks, std::memory_order_relaxed);
+  size_t nb_put = 0;
+  try {
+    if (is_worker_of(pool)) {
+      while (nb_put < nb_tasks && tls_worker->deque.push(tasks[nb_put])) {
+        ++nb_put;
+      }
+      if (nb_put < nb_tasks) {
+        tls_worker->inbox.put(tasks + nb_put, nb_tasks - nb_put);
+        nb_put = nb_tasks;
+      }
+    } else {
+      auto &workers = pool->workers;
+      const size_t nb_workers = workers.size();
+      const size_t chunk = (nb_tasks + nb_workers - 1) / nb_workers;
+      size_t index = pool->next_inbox.fetch_add(1, std::memory_order_relaxed);
+      while (nb_put < nb_tasks) {
+        size_t count = UTILS_MIN(chunk, nb_tasks - nb_put);
+        workers[index++ % nb_workers]->inbox.put(tasks + nb_put, count);
+        nb_put += count;
+      }
+    }
+  } catch (const std::bad_alloc &) {
+    if (nb_put > 0) {
+      work_notify(pool, nb_put);
+    }
+    pending_done(pool, nb_tasks - nb_put);
+    return ENOMEM;
+  }
+
+  work_notify(pool, nb_tasks);
+  return 0;
+}
+
+extern "C" SIRIUS_API int ss_threadpool_wait_idle(ss_threadpool_t *pool,
+                                                  uint64_t milliseconds) {
+  if (!pool) [[unlikely]]
+    return EINVAL;
+  if (is_worker_of(pool)) [[unlikely]]
+    return EDEADLK;
+  if (pool->nb_pending.load(std::memory_order_seq_cst) == 0)
+    return 0;
+  if (milliseconds == kSsTimeoutNoWaiting)
+    return ETIMEDOUT;
+
+  using Clock = std::chrono::steady_clock;
+  const auto deadline = milliseconds == kSsTimeoutInfinite
+    ? Clock::time_point::max()
+    : Clock::now() + std::chrono::milliseconds(milliseconds);
+
+  int ret = 0;
+  pool->nb_idle_waiters.fetch_add(1, std::memory_order_seq_cst);
+  for (;;) {
+    uint32_t epoch = pool->idle_epoch.load(std::memory_order_seq_cst);
+    if (pool->nb_pending.load(std::memory_order_seq_cst) == 0)
+      break;
+
+    uint64_t timeout_ms = utils::futex::kInfinite;
+    if (milliseconds != kSsTimeoutInfinite) {
+      auto now = Clock::now();
+      if (now >= deadline) {
+        ret = ETIMEDOUT;
+        break;
+      }
+      timeout_ms = static_cast<uint64_t>(
+        std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count());
+    }
+    (void)utils::futex::wait(&pool->idle_epoch, epoch, timeout_ms);
+  }
+  pool->nb_idle_waiters.fetch_sub(1, std::memory_order_relaxed);
+  return ret;
+}
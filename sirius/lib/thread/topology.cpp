@@ -0,0 +1,143 @@
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include "sirius/thread/thread.h"
+
+#include <map>
+#include <set>
+#include <thread>
+
+#include "lib/thread/inner/cpu.hpp"
+#include "utils/utils.h"
+
+namespace sirius {
+namespace {
+inline size_t cpu_set_first(const ss_cpu_set_t &set) {
+  for (size_t cpu = 0; cpu < SS_CPU_SETSIZE; ++cpu) {
+    if (ss_cpu_set_has(&set, cpu))
+      return cpu;
+  }
+  return SS_CPU_SETSIZE;
+}
+
+/**
+ * @brief Each online CPU as a core of its own, on package 0.
+ */
+inline void topology_fallback(ss_cpu_topology_t &topology) {
+  size_t nb_cpus = UTILS_MAX(std::thread::hardware_concurrency(), 1U);
+  nb_cpus = UTILS_MIN(nb_cpus, size_t {SS_CPU_SETSIZE});
+
+  ss_cpu_set_zero(&topology.online);
+  for (size_t cpu = 0; cpu < nb_cpus; ++cpu) {
+    ss_cpu_set_add(&topology.online, cpu);
+    topology.cpus[cpu].core = static_cast<int>(cpu);
+    topology.cpus[cpu].package = 0;
+  }
+  topology.nb_cpus = nb_cpus;
+  topology.nb_cores = nb_cpus;
+  topology.nb_packages = 1;
+}
+
+#if defined(__linux__)
+inline bool topology_linux(ss_cpu_topology_t &topology) {
+  if (!cpu::cpulist_read(std::string(cpu::kSysfsCpuDir) + "/online",
+                         topology.online))
+    return false;
+
+  std::map<std::pair<int, int>, int> cores;
+  std::map<size_t, int> l3s;
+  std::set<int> packages;
+  for (size_t cpu = 0; cpu < SS_CPU_SETSIZE; ++cpu) {
+    if (!ss_cpu_set_has(&topology.online, cpu))
+      continue;
+
+    auto &info = topology.cpus[cpu];
+    const std::string dir =
+      std::string(cpu::kSysfsCpuDir) + "/cpu" + std::to_string(cpu);
+
+    int package = -1, core_id = -1;
+    (void)cpu::file_read_int(dir + "/topology/physical_package_id", package);
+    (void)cpu::file_read_int(dir + "/topology/core_id", core_id);
+    info.package = package;
+    if (package >= 0) {
+      packages.insert(package);
+    }
+
+    /**
+     * @note Without a `core_id`, the CPU is a core of its own.
+     */
+    auto key = core_id >= 0 ? std::pair(package, core_id)
+                            : std::pair(package, -1 - static_cast<int>(cpu));
+    auto [core, core_inserted] =
+      cores.try_emplace(key, static_cast<int>(cores.size()));
+    info.core = core->second;
+
+    for (int index = 0;; ++index) {
+      const std::string cache = dir + "/cache/index" + std::to_string(index);
+      int level = 0;
+      if (!cpu::file_read_int(cache + "/level", level))
+        break;
+      if (level != 3)
+        continue;
+
+      ss_cpu_set_t shared;
+      if (cpu::cpulist_read(cache + "/shared_cpu_list", shared)) {
+        auto [l3, l3_inserted] = l3s.try_emplace(
+          cpu_set_first(shared), static_cast<int>(l3s.size()));
+        info.l3 = l3->second;
+      }
+      break;
+    }
+  }
+
+  ss_cpu_set_t nodes;
+  if (cpu::cpulist_read(std::string(cpu::kSysfsNodeDir) + "/online", nodes)) {
+    for (size_t node = 0; node < SS_CPU_SETSIZE; ++node) {
+      ss_cpu_set_t node_cpus;
+      if (!ss_cpu_set_has(&nodes, node) ||
+          !cpu::numa_node_cpus(static_cast<int>(node), node_cpus))
+        continue;
+
+      ++topology.nb_numa_nodes;
+      for (size_t cpu = 0; cpu < SS_CPU_SETSIZE; ++cpu) {
+        if (ss_cpu_set_has(&node_cpus, cpu) &&
+            ss_cpu_set_has(&topology.online, cpu)) {
+          topology.cpus[cpu].numa_node = static_cast<int>(node);
+        }
+      }
+    }
+  }
+
+  topology.nb_cpus = ss_cpu_set_count(&topology.online);
+  topology.nb_cores = cores.size();
+  topology.nb_packages = packages.size();
+  topology.nb_l3 = l3s.size();
+  return true;
+}
+#endif
+} // namespace
+} // namespace sirius
+
+using namespace sirius;
+
+extern "C" SIRIUS_API int ss_cpu_topology(ss_cpu_topology_t *topology) {
+  if (!topology)
+    return EINVAL;
+
+  std::memset(topology, 0, sizeof(ss_cpu_topology_t));
+  for (auto &info : topology->cpus) {
+    info = {-1, -1, -1, -1};
+  }
+
+  try {
+#if defined(__linux__)
+    if (topology_linux(*topology))
+      return 0;
+#endif
+    topology_fallback(*topology);
+    return 0;
+  } catch (const std::bad_alloc &) {
+    return ENOMEM;
+  }
+}
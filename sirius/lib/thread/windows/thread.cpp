@@ -15,6 +15,7 @@
 #include <thread>
 
 #include "lib/foundation/structor.h"
+#include "lib/thread/inner/stats.h"
 #include "sirius/thread/spinlock.h"
 #include "utils/errno.h"
 #include "utils/io.hpp"
@@ -303,6 +304,7 @@ inline unsigned __stdcall thread_wrapper(void *pv) {
     try_cleanup(thr);
     return 0;
   }
+  stats::register_self(thr);
 
   try {
     if (warg.start_routine) {
@@ -384,6 +386,72 @@ inline int set_thread_priority(HANDLE thread, int posix_priority) {
 #undef C
 #undef E
 }
+
+/**
+ * @note Only the first processor group, i.e., the first 64 CPUs.
+ */
+inline int cpu_set_to_mask(const ss_cpu_set_t &set, DWORD_PTR &mask) {
+  for (size_t i = 1; i < SS_CPU_SETSIZE / 64; ++i) {
+    if (set.bits[i])
+      return EINVAL;
+  }
+  if (set.bits[0] > static_cast<uint64_t>(static_cast<DWORD_PTR>(-1)))
+    return EINVAL;
+  mask = static_cast<DWORD_PTR>(set.bits[0]);
+  return mask ? 0 : EINVAL;
+}
+
+inline int set_thread_affinity(HANDLE thread, const ss_cpu_set_t &set) {
+  DWORD_PTR mask = 0;
+  if (int ret = cpu_set_to_mask(set, mask); ret) {
+    logln_error("Invalid argument. Only the first 64 CPUs can be used");
+    return ret;
+  }
+  if (!SetThreadAffinityMask(thread, mask)) {
+    const DWORD dw_err = GetLastError();
+    WIN_ERR(dw_err, "SetThreadAffinityMask");
+    return utils_winerr_to_errno(dw_err);
+  }
+  return 0;
+}
+
+/**
+ * @brief Apply `affinity`, narrowed to the NUMA node. The memory follows the
+ * first touch, from the CPUs of the node.
+ */
+inline int set_thread_placement(HANDLE thread, const ss_thread_attr_t *attr) {
+  ss_cpu_set_t cpus = attr->affinity;
+  if (attr->numa_policy == SsThreadNuma::kSsThreadNumaPreferred) {
+    ULONGLONG node_mask = 0;
+    if (attr->numa_node < 0 || attr->numa_node > UCHAR_MAX ||
+        !GetNumaNodeProcessorMask(static_cast<UCHAR>(attr->numa_node),
+                                  &node_mask) ||
+        node_mask == 0) {
+      logln_error("Invalid argument. `numa_node`: {0}", attr->numa_node);
+      return EINVAL;
+    }
+    if (ss_cpu_set_count(&cpus) == 0) {
+      cpus.bits[0] = node_mask;
+    } else {
+      cpus.bits[0] &= node_mask;
+      for (size_t i = 1; i < SS_CPU_SETSIZE / 64; ++i) {
+        cpus.bits[i] = 0;
+      }
+      if (ss_cpu_set_count(&cpus) == 0) {
+        logln_error("No CPU of `affinity` on NUMA node: {0}", attr->numa_node);
+        return EINVAL;
+      }
+    }
+  } else if (attr->numa_policy != SsThreadNuma::kSsThreadNumaNone) {
+    logln_error("Invalid argument. `numa_policy`: {0}",
+                static_cast<int64_t>(attr->numa_policy));
+    return EINVAL;
+  }
+
+  if (ss_cpu_set_count(&cpus) == 0)
+    return 0;
+  return set_thread_affinity(thread, cpus);
+}
 } // namespace
 } // namespace sirius
 
@@ -440,6 +508,9 @@ extern "C" SIRIUS_API int ss_thread_create(ss_thread_t *thread,
   thr->thread_id = (uint64_t)thread_id;
   if (initflags == CREATE_SUSPENDED && attr) {
     ret = set_thread_priority(thr->handle, attr->sched_param.priority);
+    if (ret)
+      goto label_free2;
+    ret = set_thread_placement(thr->handle, attr);
     if (ret)
       goto label_free2;
 
@@ -730,3 +801,74 @@ ss_thread_getschedparam(ss_thread_t thread, ss_thread_sched_args_t *param) {
 #undef C
 #undef E
 }
+
+extern "C" SIRIUS_API int ss_thread_setaffinity(ss_thread_t thread,
+                                                const ss_cpu_set_t *set) {
+  if (!thread || !set)
+    return EINVAL;
+  return set_thread_affinity(thread->handle, *set);
+}
+
+/**
+ * @note Windows has no getter, the mask is read by setting the affinity of the
+ * process and restoring the previous one.
+ */
+extern "C" SIRIUS_API int ss_thread_getaffinity(ss_thread_t thread,
+                                                ss_cpu_set_t *set) {
+  if (!thread || !set)
+    return EINVAL;
+
+  DWORD_PTR process_mask = 0, system_mask = 0;
+  if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask,
+                              &system_mask)) {
+    const DWORD dw_err = GetLastError();
+    WIN_ERR(dw_err, "GetProcessAffinityMask");
+    return utils_winerr_to_errno(dw_err);
+  }
+  DWORD_PTR mask = SetThreadAffinityMask(thread->handle, process_mask);
+  if (!mask) {
+    const DWORD dw_err = GetLastError();
+    WIN_ERR(dw_err, "SetThreadAffinityMask");
+    return utils_winerr_to_errno(dw_err);
+  }
+  (void)SetThreadAffinityMask(thread->handle, mask);
+
+  ss_cpu_set_zero(set);
+  set->bits[0] = static_cast<uint64_t>(mask);
+  return 0;
+}
+
+extern "C" SIRIUS_API int ss_thread_stats(ss_thread_t thread,
+                                          ss_thread_stats_t *stats) {
+  if (!thread || !stats)
+    return EINVAL;
+
+  *stats = {};
+  stats->last_cpu = -1;
+  stats::Snapshot snapshot {};
+  if (stats::get(thread, snapshot)) {
+    stats->wait_time_ns = snapshot.wait_time_ns;
+    stats->nb_waits = snapshot.nb_waits;
+  }
+
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(thread->handle, &creation_time, &exit_time,
+                      &kernel_time, &user_time)) {
+    const DWORD dw_err = GetLastError();
+    WIN_ERR(dw_err, "GetThreadTimes");
+    return utils_winerr_to_errno(dw_err);
+  }
+  auto ticks = [](const FILETIME &time) {
+    return (static_cast<uint64_t>(time.dwHighDateTime) << 32) |
+      time.dwLowDateTime;
+  };
+  /**
+   * @note Unit: 100 ns.
+   */
+  stats->cpu_time_ns = (ticks(kernel_time) + ticks(user_time)) * 100;
+
+  if (thread == ss_thread_self()) {
+    stats->last_cpu = static_cast<int>(GetCurrentProcessorNumber());
+  }
+  return 0;
+}
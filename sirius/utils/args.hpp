@@ -35,7 +35,8 @@ class Parser {
     bool required = false;
 
     /**
-     * @brief If not empty, only these values are allowed.
+     * @brief If not empty, only these values are allowed. Otherwise any value
+     * is.
      */
     std::vector<std::string> allowed_values;
     std::string help;
@@ -59,10 +60,6 @@ class Parser {
     }
 
     if (requires_value) {
-      if (allowed_values.empty()) {
-        auto es = std::format("Missing value for option `--{0}`", option);
-        return std::unexpected(UTrace(std::move(es)));
-      }
       for (auto v : allowed_values) {
         if (first_valid_pos(v) != 0 || v.starts_with("--")) {
           auto es = std::format(
@@ -159,7 +156,8 @@ class Parser {
       }
 
       // requires_value
-      if (!std::ranges::contains(spec->allowed_values, value)) {
+      if (!spec->allowed_values.empty() &&
+          !std::ranges::contains(spec->allowed_values, value)) {
         auto es = std::format(
           "\nInvalid argument. The `value` for option `--{0}`. "
           "Actual: {1}; Allowed: {2}",
@@ -14,6 +14,20 @@
 
 // clang-format on
 
+// --- utils_hidden ---
+/**
+ * @brief A symbol internal to its library, even where the visibility preset
+ * of the build is not hidden.
+ */
+#undef utils_hidden
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_WIN32) && \
+  !defined(_WIN64)
+#  define utils_hidden __attribute__((visibility("hidden")))
+#else
+#  define utils_hidden
+#endif
+
 // --- utils_pretty_fn ---
 #undef utils_pretty_fn
 
@@ -47,7 +47,70 @@
  * CFLAGS += -D_SIRIUS_LOG_SHM_CAPACITY=$(_SIRIUS_LOG_SHM_CAPACITY)
  */
 #ifndef _SIRIUS_LOG_SHM_CAPACITY
-#  define _SIRIUS_LOG_SHM_CAPACITY 512
+#  define _SIRIUS_LOG_SHM_CAPACITY 4096
+#endif
+
+/**
+ * @brief The bytes of a slot of the shared memory in the log module. A
+ * message longer than a slot spans several contiguous slots.
+ *
+ * @note Rounded up to the cache line, and raised if needed so that the longest
+ * message spans at most half a shard.
+ *
+ * @example
+ * CFLAGS += -D_SIRIUS_LOG_SHM_SLOT_SIZE=$(_SIRIUS_LOG_SHM_SLOT_SIZE)
+ */
+#ifndef _SIRIUS_LOG_SHM_SLOT_SIZE
+#  define _SIRIUS_LOG_SHM_SLOT_SIZE 256
+#endif
+
+/**
+ * @brief The number of the rings that the shared memory of the log module is
+ * sharded into, by the CPU of the producer. Each ring holds
+ * `_SIRIUS_LOG_SHM_CAPACITY / _SIRIUS_LOG_SHM_SHARDS` slots.
+ *
+ * @example
+ * CFLAGS += -D_SIRIUS_LOG_SHM_SHARDS=$(_SIRIUS_LOG_SHM_SHARDS)
+ */
+#ifndef _SIRIUS_LOG_SHM_SHARDS
+#  define _SIRIUS_LOG_SHM_SHARDS 8
+#endif
+
+/**
+ * @brief On Linux, advise the kernel to back the shared memory of the log
+ * module with transparent huge pages (`madvise(MADV_HUGEPAGE)`), the size is
+ * rounded up to 2 MiB.
+ *
+ * @note Takes effect only if `/sys/kernel/mm/transparent_hugepage/
+ * shmem_enabled` is `advise`, `within_size` or `always`.
+ *
+ * @example
+ * CFLAGS += -D_SIRIUS_LOG_SHM_HUGEPAGE=$(_SIRIUS_LOG_SHM_HUGEPAGE)
+ */
+#ifndef _SIRIUS_LOG_SHM_HUGEPAGE
+#  define _SIRIUS_LOG_SHM_HUGEPAGE 0
+#endif
+
+/**
+ * @brief On Linux, pre-fault the shared memory of the log module when it is
+ * mapped, so that the producers do not take the first-touch page faults.
+ *
+ * @example
+ * CFLAGS += -D_SIRIUS_LOG_SHM_POPULATE=$(_SIRIUS_LOG_SHM_POPULATE)
+ */
+#ifndef _SIRIUS_LOG_SHM_POPULATE
+#  define _SIRIUS_LOG_SHM_POPULATE 0
+#endif
+
+/**
+ * @brief On Linux, prefer the NUMA node of the daemon consumer thread for the
+ * shared memory of the log module.
+ *
+ * @example
+ * CFLAGS += -D_SIRIUS_LOG_SHM_NUMA=$(_SIRIUS_LOG_SHM_NUMA)
+ */
+#ifndef _SIRIUS_LOG_SHM_NUMA
+#  define _SIRIUS_LOG_SHM_NUMA 0
 #endif
 
 /**
@@ -0,0 +1,147 @@
+/**
+ * @brief Waits and wake-ups on 32-bit words, the only layer which talks to
+ * the operating system: the futex on Linux, `WaitOnAddress` on Windows.
+ *
+ * @note
+ * - (1) `WaitOnAddress` does not work across the processes, so a shared wait
+ * on Windows degrades into a sleep of at most 1 ms, as does any wait on the
+ * other platforms, @ref `UTILS_FUTEX_NATIVE`.
+ *
+ * - (2) The shared and the private operations are separate functions, so
+ * that the programs which only use the former do not link `WaitOnAddress`.
+ */
+
+#pragma once
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#if defined(__linux__)
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#endif
+
+#undef UTILS_FUTEX_INFINITE
+#define UTILS_FUTEX_INFINITE UINT64_MAX
+
+/**
+ * @brief Whether a private wait sleeps until it is woken up.
+ */
+#undef UTILS_FUTEX_NATIVE
+#if defined(__linux__) || defined(_WIN32) || defined(_WIN64)
+#  define UTILS_FUTEX_NATIVE 1
+#else
+#  define UTILS_FUTEX_NATIVE 0
+#endif
+
+static inline uint32_t utils_futex_load(volatile uint32_t *word) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  return *word;
+#else
+  return __atomic_load_n(word, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * @return 0 if the word changed, ETIMEDOUT otherwise.
+ */
+static inline int utils_futex_sleep(volatile uint32_t *word, uint32_t expected,
+                                    uint64_t timeout_ms) {
+  if (utils_futex_load(word) != expected)
+    return 0;
+  if (timeout_ms > 0) {
+#if defined(_WIN32) || defined(_WIN64)
+    Sleep(1);
+#else
+    usleep(1000);
+#endif
+  }
+  return utils_futex_load(word) != expected ? 0 : ETIMEDOUT;
+}
+
+#if defined(__linux__)
+static inline int utils_futex_linux_wait(volatile uint32_t *word,
+                                         uint32_t expected,
+                                         uint64_t timeout_ms, int op) {
+  struct timespec ts;
+  struct timespec *pts = nullptr;
+  if (timeout_ms != UTILS_FUTEX_INFINITE) {
+    ts.tv_sec = (time_t)(timeout_ms / 1000);
+    ts.tv_nsec = (long)((timeout_ms % 1000) * 1000000);
+    pts = &ts;
+  }
+  if (syscall(SYS_futex, word, op, expected, pts, nullptr, 0) == -1) {
+    const int errno_err = errno;
+    return errno_err == EAGAIN ? 0 : errno_err;
+  }
+  return 0;
+}
+#endif
+
+// --- utils_futex_wait ---
+/**
+ * @brief Block while `*word == expected`, until a wake-up or `timeout_ms`,
+ * within a process.
+ *
+ * @return 0 on wake-up or value mismatch, ETIMEDOUT / EINTR otherwise.
+ *
+ * @note Spurious wake-ups are possible, the caller should re-check the
+ * condition.
+ */
+static inline int utils_futex_wait(volatile uint32_t *word, uint32_t expected,
+                                   uint64_t timeout_ms) {
+#if defined(__linux__)
+  return utils_futex_linux_wait(word, expected, timeout_ms,
+                                FUTEX_WAIT_PRIVATE);
+#elif defined(_WIN32) || defined(_WIN64)
+  DWORD ms = timeout_ms >= INFINITE ? INFINITE : (DWORD)timeout_ms;
+  if (!WaitOnAddress(word, &expected, sizeof(expected), ms))
+    return GetLastError() == ERROR_TIMEOUT ? ETIMEDOUT : 0;
+  return 0;
+#else
+  return utils_futex_sleep(word, expected, timeout_ms);
+#endif
+}
+
+/**
+ * @brief Same as above, for a word in memory shared between processes.
+ */
+static inline int utils_futex_wait_shared(volatile uint32_t *word,
+                                          uint32_t expected,
+                                          uint64_t timeout_ms) {
+#if defined(__linux__)
+  return utils_futex_linux_wait(word, expected, timeout_ms, FUTEX_WAIT);
+#else
+  return utils_futex_sleep(word, expected, timeout_ms);
+#endif
+}
+
+// --- utils_futex_wake ---
+/**
+ * @brief Wake at most `count` waiters of `word`, within a process.
+ *
+ * @note Async-signal-safe on Linux, it is a bare system call.
+ */
+static inline void utils_futex_wake(volatile uint32_t *word, int count) {
+#if defined(__linux__)
+  (void)syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr,
+                0);
+#elif defined(_WIN32) || defined(_WIN64)
+  if (count == 1) {
+    WakeByAddressSingle((PVOID)word);
+  } else {
+    WakeByAddressAll((PVOID)word);
+  }
+#else
+  (void)word, (void)count;
+#endif
+}
+
+static inline void utils_futex_wake_shared(volatile uint32_t *word,
+                                           int count) {
+#if defined(__linux__)
+  (void)syscall(SYS_futex, word, FUTEX_WAKE, count, nullptr, nullptr, 0);
+#else
+  (void)word, (void)count;
+#endif
+}
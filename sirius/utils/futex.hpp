@@ -0,0 +1,55 @@
+#pragma once
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include "utils/futex.h"
+
+namespace sirius {
+namespace utils {
+namespace futex {
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+              std::atomic<uint32_t>::is_always_lock_free);
+
+inline constexpr uint64_t kInfinite = UTILS_FUTEX_INFINITE;
+
+inline volatile uint32_t *word(std::atomic<uint32_t> *addr) {
+  return reinterpret_cast<volatile uint32_t *>(addr);
+}
+
+/**
+ * @brief Block while `*addr == expected`, until a `wake` or `timeout_ms`.
+ *
+ * @return 0 on wake-up or value mismatch, ETIMEDOUT / EINTR otherwise.
+ *
+ * @note Spurious wake-ups are possible, the caller should re-check the
+ * condition, @ref `utils_futex_wait`.
+ */
+inline int wait(std::atomic<uint32_t> *addr, uint32_t expected,
+                uint64_t timeout_ms = kInfinite) {
+  return utils_futex_wait(word(addr), expected, timeout_ms);
+}
+
+/**
+ * @brief Same as above, for `addr` in memory shared between processes.
+ */
+inline int wait_shared(std::atomic<uint32_t> *addr, uint32_t expected,
+                       uint64_t timeout_ms = kInfinite) {
+  return utils_futex_wait_shared(word(addr), expected, timeout_ms);
+}
+
+/**
+ * @brief Wake at most `count` waiters of `addr`.
+ *
+ * @note Async-signal-safe on Linux, it is a bare system call.
+ */
+inline void wake(std::atomic<uint32_t> *addr, int count = INT_MAX) {
+  utils_futex_wake(word(addr), count);
+}
+
+inline void wake_shared(std::atomic<uint32_t> *addr, int count = INT_MAX) {
+  utils_futex_wake_shared(word(addr), count);
+}
+} // namespace futex
+} // namespace utils
+} // namespace sirius
@@ -112,21 +112,30 @@ class Fmt {
 
   static std::string s_pre(std::string_view prefix, std::string_view module,
                            std::string_view file, int line = 0) {
+    return s_pre(prefix, module, file, line, std::time(nullptr),
+                 thread::get_tid_impl());
+  }
+
+  /**
+   * @brief Same as above, but the time and the thread id are given by the
+   * caller (e.g. rendered by the daemon on behalf of a producer).
+   */
+  static std::string s_pre(std::string_view prefix, std::string_view module,
+                           std::string_view file, int line, time_t raw_time,
+                           uint64_t tid) {
     std::string inner;
     std::string result;
     inner.reserve(kPrefixLength + 16);
     result.reserve(kPrefixLength + 2);
 
-    time_t raw_time;
     struct tm tm_info;
-    std::time(&raw_time);
     utils_localtime_r(&raw_time, &tm_info);
     std::string f_str = back_strip(file);
     std::string f_pos =
       f_str.empty() ? "" : std::format("{0}:{1} ", f_str, line);
     inner = std::format("{0:5} [{1:02d}:{2:02d}:{3:02d} {4} {5}] {6}", prefix,
                         tm_info.tm_hour, tm_info.tm_min, tm_info.tm_sec, module,
-                        thread::get_tid_impl(), f_pos);
+                        tid, f_pos);
     result =
       std::vformat("{0:-<{1}}", std::make_format_args(inner, kPrefixLength));
     return result;
@@ -0,0 +1,388 @@
+#pragma once
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "utils/log/record.hpp"
+#include "utils/time.hpp"
+
+namespace sirius {
+namespace utils {
+namespace log {
+/**
+ * @brief The binary log archive, @ref `SsLogEncoder::kSsLogEncoderBinary`.
+ *
+ * @note
+ * - (1) An archive is a sequence of chunks. A chunk is a `ChunkHeader`
+ * followed by `ChunkHeader::size` bytes of records, each a `RecordHeader`
+ * followed by its strings and padded to 8 bytes.
+ *
+ * - (2) The `ChunkHeader` is the sparse index: the time range, the levels,
+ * and the bloom filters of the pids and the modules of its records. So a
+ * query skips the chunks that cannot match without touching their records.
+ *
+ * - (3) A chunk is written with one call, so a torn chunk can only be at the
+ * end of a session. The reader resynchronizes on the next `kChunkMagic`.
+ *
+ * - (4) Native byte order, read back on the machine that wrote it.
+ */
+namespace archive {
+inline constexpr uint32_t kChunkMagic = 0x4B434C53; // "SLCK"
+inline constexpr uint32_t kVersion = 1;
+inline constexpr size_t kChunkBytesMax = 64 * 1024;
+inline constexpr uint64_t kChunkFlushMs = 1000;
+
+struct ChunkHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size; // The bytes of the records.
+  uint32_t nb_records;
+  uint64_t timestamp_min_ms;
+  uint64_t timestamp_max_ms;
+  uint64_t pid_bloom;
+  uint64_t module_bloom;
+  uint32_t level_mask;
+  uint32_t checksum; // FNV-1a of the records.
+};
+
+/**
+ * @note The module, the file, the message and the key-value pairs follow,
+ * the pairs packed as in `record::pack`.
+ */
+struct RecordHeader {
+  uint32_t size; // The whole record, padding included.
+  int32_t level;
+  uint64_t timestamp_ms; // Wall clock, since the epoch.
+  int64_t pid;
+  uint64_t tid;
+  int32_t line;
+  uint16_t module_size;
+  uint16_t file_size;
+  uint32_t msg_size;
+  uint32_t kvs_size;
+  uint32_t nb_kvs;
+};
+
+namespace inner {
+inline constexpr size_t kAlign = 8;
+
+inline uint32_t fnv1a(const char *data, size_t size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+  }
+  return hash;
+}
+
+inline uint64_t mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+/**
+ * @brief Two bits out of 64.
+ */
+inline uint64_t bloom(uint64_t hash) {
+  return (uint64_t {1} << (hash & 63)) | (uint64_t {1} << ((hash >> 6) & 63));
+}
+
+inline uint64_t pid_bloom(int64_t pid) {
+  return bloom(mix(static_cast<uint64_t>(pid)));
+}
+
+inline uint64_t module_bloom(std::string_view module) {
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : module) {
+    hash = (hash ^ c) * 1099511628211ull;
+  }
+  return bloom(mix(hash));
+}
+
+inline uint32_t level_bit(int level) {
+  return uint32_t {1} << (level >= 0 && level < 31 ? level : 31);
+}
+
+inline void put_kv(std::string &dst, std::string_view sv) {
+  auto size = static_cast<record::field_size_t>(
+    UTILS_MIN(sv.size(), std::numeric_limits<record::field_size_t>::max()));
+  dst.append(reinterpret_cast<const char *>(&size), sizeof(size));
+  dst.append(sv.data(), size);
+}
+} // namespace inner
+
+/**
+ * @brief Accumulates the records of one chunk, owned by a destination of the
+ * daemon.
+ */
+class Writer {
+ public:
+  Writer() = default;
+
+  ~Writer() = default;
+
+  bool empty() const { return nb_records_ == 0; }
+
+  /**
+   * @brief The steady time of the first record of the chunk.
+   */
+  uint64_t since_ms() const { return since_ms_; }
+
+  /**
+   * @return false if the chunk is full, it should be sealed and written
+   * first. A record always fits into an empty chunk.
+   */
+  bool append(const record::View &view) {
+    kvs_.clear();
+    for (const auto &[key, value] : view.kvs) {
+      inner::put_kv(kvs_, key);
+      inner::put_kv(kvs_, value);
+    }
+    auto module = view.module.substr(0, UINT16_MAX);
+    auto file = view.file.substr(0, UINT16_MAX);
+    size_t size = sizeof(RecordHeader) + module.size() + file.size() +
+      view.msg.size() + kvs_.size();
+    size = (size + inner::kAlign - 1) & ~(inner::kAlign - 1);
+
+    if (empty()) {
+      buf_.assign(sizeof(ChunkHeader), '\0');
+      header_ = {};
+      header_.timestamp_min_ms = UINT64_MAX;
+      since_ms_ = time::get_monotonic_steady_ms();
+    } else if (buf_.size() + size > sizeof(ChunkHeader) + kChunkBytesMax) {
+      return false;
+    }
+
+    RecordHeader rh {};
+    rh.size = static_cast<uint32_t>(size);
+    rh.level = view.level;
+    rh.timestamp_ms = view.timestamp_ms;
+    rh.pid = view.pid;
+    rh.tid = view.tid;
+    rh.line = view.line;
+    rh.module_size = static_cast<uint16_t>(module.size());
+    rh.file_size = static_cast<uint16_t>(file.size());
+    rh.msg_size = static_cast<uint32_t>(view.msg.size());
+    rh.kvs_size = static_cast<uint32_t>(kvs_.size());
+    rh.nb_kvs = static_cast<uint32_t>(view.kvs.size());
+
+    size_t begin = buf_.size();
+    buf_.append(reinterpret_cast<const char *>(&rh), sizeof(rh))
+      .append(module)
+      .append(file)
+      .append(view.msg)
+      .append(kvs_);
+    buf_.append(begin + size - buf_.size(), '\0');
+
+    ++nb_records_;
+    header_.timestamp_min_ms =
+      UTILS_MIN(header_.timestamp_min_ms, view.timestamp_ms);
+    header_.timestamp_max_ms =
+      UTILS_MAX(header_.timestamp_max_ms, view.timestamp_ms);
+    header_.pid_bloom |= inner::pid_bloom(view.pid);
+    header_.module_bloom |= inner::module_bloom(module);
+    header_.level_mask |= inner::level_bit(view.level);
+    return true;
+  }
+
+  /**
+   * @brief Complete the header, and return the whole chunk.
+   *
+   * @note Valid until the next `append`, the writer is empty afterwards.
+   */
+  std::string_view seal() {
+    if (empty())
+      return {};
+
+    header_.magic = kChunkMagic;
+    header_.version = kVersion;
+    header_.size = static_cast<uint32_t>(buf_.size() - sizeof(ChunkHeader));
+    header_.nb_records = nb_records_;
+    header_.checksum =
+      inner::fnv1a(buf_.data() + sizeof(ChunkHeader), header_.size);
+    std::memcpy(buf_.data(), &header_, sizeof(header_));
+    nb_records_ = 0;
+    return buf_;
+  }
+
+ private:
+  ChunkHeader header_ {};
+  uint32_t nb_records_ = 0;
+  uint64_t since_ms_ = 0;
+  std::string buf_ {};
+  std::string kvs_ {};
+};
+
+/**
+ * @brief The conditions of a query, an empty list matches everything.
+ */
+struct Filter {
+  uint64_t since_ms = 0;
+  uint64_t until_ms = UINT64_MAX;
+  int level = INT_MAX; // The least severe level to keep.
+  std::vector<int64_t> pids {};
+  std::vector<std::string> modules {};
+
+  /**
+   * @brief Whether a chunk may hold a match, from its header alone.
+   */
+  bool chunk_match(const ChunkHeader &header) const {
+    if (header.timestamp_max_ms < since_ms ||
+        header.timestamp_min_ms > until_ms) {
+      return false;
+    }
+    if (level != INT_MAX) {
+      uint32_t mask = 0;
+      for (int l = SS_LOG_LEVEL_ERROR; l <= UTILS_MIN(level, 30); ++l) {
+        mask |= inner::level_bit(l);
+      }
+      if (!(header.level_mask & mask))
+        return false;
+    }
+    if (!pids.empty() &&
+        std::ranges::none_of(pids, [&](int64_t pid) {
+          uint64_t b = inner::pid_bloom(pid);
+          return (header.pid_bloom & b) == b;
+        })) {
+      return false;
+    }
+    if (!modules.empty() &&
+        std::ranges::none_of(modules, [&](const std::string &module) {
+          uint64_t b = inner::module_bloom(module);
+          return (header.module_bloom & b) == b;
+        })) {
+      return false;
+    }
+    return true;
+  }
+
+  bool match(const record::View &view) const {
+    return view.timestamp_ms >= since_ms && view.timestamp_ms <= until_ms &&
+      (level == INT_MAX ||
+       (view.level >= SS_LOG_LEVEL_ERROR && view.level <= level)) &&
+      (pids.empty() || std::ranges::contains(pids, view.pid)) &&
+      (modules.empty() || std::ranges::contains(modules, view.module));
+  }
+};
+
+/**
+ * @brief Counters of a `scan`.
+ */
+struct ScanResult {
+  uint64_t nb_chunks = 0;
+  uint64_t nb_chunks_skipped = 0; // Ruled out by the header.
+  uint64_t nb_corrupted = 0;      // Chunks or ranges that failed to decode.
+  uint64_t nb_records = 0;        // Matched.
+};
+
+namespace inner {
+/**
+ * @return false if the chunk is corrupted.
+ */
+template <typename Fn>
+bool chunk_scan(std::string_view records, uint32_t nb_records,
+                const Filter &filter, Fn &fn, ScanResult &result) {
+  size_t pos = 0;
+  for (uint32_t i = 0; i < nb_records; ++i) {
+    RecordHeader rh;
+    if (pos + sizeof(rh) > records.size())
+      return false;
+    std::memcpy(&rh, records.data() + pos, sizeof(rh));
+    size_t payload = size_t {rh.module_size} + rh.file_size + rh.msg_size +
+      rh.kvs_size;
+    if (rh.size < sizeof(rh) + payload || pos + rh.size > records.size())
+      return false;
+
+    const char *p = records.data() + pos + sizeof(rh);
+    record::View view {};
+    view.level = rh.level;
+    view.timestamp_ms = rh.timestamp_ms;
+    view.tid = rh.tid;
+    view.pid = rh.pid;
+    view.line = rh.line;
+    view.module = std::string_view(p, rh.module_size);
+    p += rh.module_size;
+    view.file = std::string_view(p, rh.file_size);
+    p += rh.file_size;
+    view.msg = std::string_view(p, rh.msg_size);
+    p += rh.msg_size;
+    pos += rh.size;
+
+    if (!filter.match(view))
+      continue;
+
+    size_t kv_pos = 0;
+    view.kvs.reserve(rh.nb_kvs);
+    for (uint32_t k = 0; k < rh.nb_kvs; ++k) {
+      std::string_view key, value;
+      if (!record::inner::get(p, rh.kvs_size, kv_pos, key) ||
+          !record::inner::get(p, rh.kvs_size, kv_pos, value)) {
+        return false;
+      }
+      view.kvs.emplace_back(key, value);
+    }
+    ++result.nb_records;
+    fn(view);
+  }
+  return true;
+}
+} // namespace inner
+
+/**
+ * @brief Visit the records of an archive that pass the `filter`, in the
+ * order of the archive.
+ *
+ * @param[in] data The whole archive, e.g. memory-mapped.
+ * @param[in] fn `void(const record::View &)`, the views point into `data`.
+ */
+template <typename Fn>
+ScanResult scan(std::string_view data, const Filter &filter, Fn &&fn) {
+  ScanResult result {};
+  size_t pos = 0;
+
+  auto resync = [&](size_t from) {
+    ++result.nb_corrupted;
+    const uint32_t magic = kChunkMagic;
+    auto it = std::search(
+      data.begin() + UTILS_MIN(from, data.size()), data.end(),
+      reinterpret_cast<const char *>(&magic),
+      reinterpret_cast<const char *>(&magic) + sizeof(magic));
+    pos = static_cast<size_t>(it - data.begin());
+  };
+
+  while (pos + sizeof(ChunkHeader) <= data.size()) {
+    ChunkHeader header;
+    std::memcpy(&header, data.data() + pos, sizeof(header));
+    if (header.magic != kChunkMagic || header.version != kVersion ||
+        header.size > data.size() - pos - sizeof(header)) {
+      resync(pos + 1);
+      continue;
+    }
+
+    ++result.nb_chunks;
+    auto records = data.substr(pos + sizeof(header), header.size);
+    if (!filter.chunk_match(header)) {
+      ++result.nb_chunks_skipped;
+      pos += sizeof(header) + header.size;
+      continue;
+    }
+    if (inner::fnv1a(records.data(), records.size()) != header.checksum ||
+        !inner::chunk_scan(records, header.nb_records, filter, fn, result)) {
+      resync(pos + 1);
+      continue;
+    }
+    pos += sizeof(header) + header.size;
+  }
+  if (pos < data.size()) {
+    ++result.nb_corrupted; // A torn tail.
+  }
+  return result;
+}
+} // namespace archive
+} // namespace log
+} // namespace utils
+} // namespace sirius
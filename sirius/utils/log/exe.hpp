@@ -22,6 +22,16 @@ class Args {
   static constexpr const char *kArgDaemon = "daemon";
   static constexpr const char *kArgDaemonSpawn = "spawn";
 
+  static constexpr const char *kArgStats = "stats";
+
+  static constexpr const char *kArgQuery = "query";
+  static constexpr const char *kArgQuerySince = "since";
+  static constexpr const char *kArgQueryUntil = "until";
+  static constexpr const char *kArgQueryLevel = "level";
+  static constexpr const char *kArgQueryPid = "pid";
+  static constexpr const char *kArgQueryModule = "module";
+  static constexpr const char *kArgQueryFormat = "format";
+
   static inline args::Parser parser;
 
  private:
@@ -65,6 +75,14 @@ class Args {
     return parser.add_option(kArgHelp, false, {}, false, false, "Helper")
       .E(parser.add_option(kArgVersion, false, {}, false, false, "Print version"))
       .E(parser.add_option(kArgDaemon, true, {kArgDaemonSpawn}, false, false, "Daemon"))
+      .E(parser.add_option(kArgStats, false, {}, false, false, "Print the metrics of the log ring"))
+      .E(parser.add_option(kArgQuery, true, {}, false, false, "Print the records of a binary log archive"))
+      .E(parser.add_option(kArgQuerySince, true, {}, false, false, "Query: from the time, epoch milliseconds or `YYYY-MM-DDTHH:MM:SS[.mmm]Z`"))
+      .E(parser.add_option(kArgQueryUntil, true, {}, false, false, "Query: until the time, same format as `--since`"))
+      .E(parser.add_option(kArgQueryLevel, true, {"error", "warn", "info", "debug"}, false, false, "Query: the least severe level"))
+      .E(parser.add_option(kArgQueryPid, true, {}, false, true, "Query: the process id"))
+      .E(parser.add_option(kArgQueryModule, true, {}, false, true, "Query: the module name"))
+      .E(parser.add_option(kArgQueryFormat, true, {"human", "json", "logfmt"}, false, false, "Query: the output format"))
       .E(parser.parse(argc, argv))
       .utrace_transform_error_default();
     // clang-format on
@@ -0,0 +1,216 @@
+#pragma once
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "sirius/kit/log.h"
+#include "utils/env.h"
+#include "utils/io.hpp"
+
+namespace sirius {
+namespace utils {
+namespace log {
+/**
+ * @brief Registry of the runtime log levels of the modules.
+ *
+ * @implements Singleton pattern.
+ *
+ * @note The levels and the gate words bound by `bind` are written with relaxed
+ * atomic stores, and the gate words are read by the log macros with relaxed
+ * atomic loads. The entries are never released, so a bound word is kept in
+ * step until the process exits.
+ */
+class Level {
+ private:
+  struct Entry {
+    int level;
+    bool is_explicit;
+    std::vector<int *> words {};
+  };
+
+ private:
+  Level() { env_configure(); }
+
+  ~Level() = default;
+
+ public:
+  Level(const Level &) = delete;
+  Level &operator=(const Level &) = delete;
+
+  static Level &instance() {
+    static Level instance;
+    return instance;
+  }
+
+  static bool is_valid(int level) {
+    return level >= SS_LOG_LEVEL_NONE && level <= SS_LOG_LEVEL_DEBUG;
+  }
+
+  /**
+   * @note An unknown module is not registered, its level is the default one.
+   */
+  int get(std::string_view module) {
+    auto lock = std::lock_guard(mutex_);
+    if (!module.empty()) {
+      if (auto it = modules_.find(std::string(module)); it != modules_.end())
+        return load(it->second->level);
+    }
+    return load(default_level_);
+  }
+
+  /**
+   * @return The gate word, @ref `ss_log_level_bind`.
+   */
+  int bind(std::string_view module, int *word) {
+    auto lock = std::lock_guard(mutex_);
+    Entry &e = entry(module);
+    e.words.push_back(word);
+    store(*word, gate(e.level));
+    return gate(e.level);
+  }
+
+  /**
+   * @brief Turn on or off the flight recorder bit of the gate words.
+   */
+  void flight(bool enable) {
+    auto lock = std::lock_guard(mutex_);
+    flight_ = enable;
+    for (auto &e : entries_) {
+      level_store(e, load(e.level));
+    }
+  }
+
+  /**
+   * @return 0 on success, or an `errno` value on failure.
+   */
+  int set(std::string_view module, int level) {
+    if (!is_valid(level))
+      return EINVAL;
+
+    auto lock = std::lock_guard(mutex_);
+    if (module.empty()) {
+      store(default_level_, level);
+      for (auto &e : entries_) {
+        if (!e.is_explicit) {
+          level_store(e, level);
+        }
+      }
+    } else {
+      Entry &e = entry(module);
+      e.is_explicit = true;
+      level_store(e, level);
+    }
+    return 0;
+  }
+
+ private:
+  std::mutex mutex_ {};
+  int default_level_ = SS_LOG_LEVEL_DEBUG;
+  bool flight_ = false;
+  std::deque<Entry> entries_ {};
+  std::unordered_map<std::string, Entry *> modules_ {};
+
+  static int load(int &level) {
+    return std::atomic_ref<int>(level).load(std::memory_order_relaxed);
+  }
+
+  static void store(int &level, int value) {
+    std::atomic_ref<int>(level).store(value, std::memory_order_relaxed);
+  }
+
+  int gate(int level) const {
+    return level | (flight_ ? _SS_INNER_LOG_GATE_FLIGHT : 0);
+  }
+
+  /**
+   * @note This function must be guarded by the `mutex_`.
+   */
+  void level_store(Entry &e, int level) {
+    store(e.level, level);
+    for (int *word : e.words) {
+      store(*word, gate(level));
+    }
+  }
+
+  /**
+   * @note This function must be guarded by the `mutex_`.
+   */
+  Entry &entry(std::string_view module) {
+    std::string key(module);
+    if (auto it = modules_.find(key); it != modules_.end())
+      return *it->second;
+
+    Entry &e = entries_.emplace_back(Entry {load(default_level_), false});
+    modules_.emplace(std::move(key), &e);
+    return e;
+  }
+
+  static int parse_level(std::string_view sv) {
+    if (sv.size() == 1 && sv[0] >= '0' && sv[0] <= '4')
+      return sv[0] - '0';
+
+    constexpr std::pair<std::string_view, int> kNames[] = {
+      {"none", SS_LOG_LEVEL_NONE},
+      {"error", SS_LOG_LEVEL_ERROR},
+      {"warn", SS_LOG_LEVEL_WARN},
+      {"info", SS_LOG_LEVEL_INFO},
+      {"debug", SS_LOG_LEVEL_DEBUG},
+    };
+    for (const auto &[name, level] : kNames) {
+      if (sv == name)
+        return level;
+    }
+    return -1;
+  }
+
+  /**
+   * @brief Parse `_SIRIUS_ENV_LOG_LEVEL`, e.g. "warn,net=debug".
+   */
+  void env_configure() {
+    std::string env = env::get_env(_SIRIUS_ENV_LOG_LEVEL);
+    std::string_view rest = env;
+    while (!rest.empty()) {
+      size_t pos = rest.find(',');
+      std::string_view item = rest.substr(0, pos);
+      rest = pos == std::string_view::npos ? std::string_view {}
+                                           : rest.substr(pos + 1);
+      if (item.empty())
+        continue;
+
+      std::string_view module {};
+      std::string_view level_str = item;
+      if (size_t eq = item.find('='); eq != std::string_view::npos) {
+        module = item.substr(0, eq);
+        level_str = item.substr(eq + 1);
+      }
+      int level = parse_level(level_str);
+      if (level < 0 || (item.find('=') != std::string_view::npos &&
+                        module.empty())) {
+        logln_warnsp("Invalid argument. `{0}`: {1}", _SIRIUS_ENV_LOG_LEVEL,
+                     item);
+        continue;
+      }
+
+      if (module.empty()) {
+        default_level_ = level;
+        for (auto &e : entries_) {
+          if (!e.is_explicit) {
+            e.level = level;
+          }
+        }
+      } else {
+        Entry &e = entry(module);
+        e.is_explicit = true;
+        e.level = level;
+      }
+    }
+  }
+};
+} // namespace log
+} // namespace utils
+} // namespace sirius
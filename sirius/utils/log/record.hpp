@@ -0,0 +1,405 @@
+#pragma once
+/* clang-format off */
+#include "utils/decls.h"
+/* clang-format on */
+
+#include <optional>
+#include <vector>
+
+#include "utils/io.hpp"
+#include "utils/log/shm.hpp"
+
+namespace sirius {
+namespace utils {
+namespace log {
+namespace record {
+/**
+ * @brief The decoded view of a `ShmBufDataType::kRecord` buffer.
+ *
+ * @note The string views point into the source `ShmBuf`.
+ */
+struct View {
+  int level;
+  uint64_t timestamp_ms;
+  uint64_t tid;
+  int64_t pid;
+  int line;
+  std::string_view module;
+  std::string_view file;
+  std::string_view msg;
+  std::vector<std::pair<std::string_view, std::string_view>> kvs;
+};
+
+using field_size_t = uint16_t;
+
+/**
+ * @brief Wall clock in milliseconds, since the epoch.
+ */
+inline uint64_t realtime_ms() {
+  auto duration = std::chrono::system_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+    .count();
+}
+
+namespace inner {
+inline bool put(char *buf, size_t &pos, std::string_view sv) {
+  if (sv.size() > std::numeric_limits<field_size_t>::max() ||
+      pos + sizeof(field_size_t) + sv.size() > kLogBufferSize) {
+    return false;
+  }
+  field_size_t size = static_cast<field_size_t>(sv.size());
+  std::memcpy(buf + pos, &size, sizeof(size));
+  pos += sizeof(size);
+  std::memcpy(buf + pos, sv.data(), sv.size());
+  pos += sv.size();
+  return true;
+}
+
+inline bool get(const char *buf, size_t buf_size, size_t &pos,
+                std::string_view &sv) {
+  field_size_t size;
+  if (pos + sizeof(size) > buf_size)
+    return false;
+  std::memcpy(&size, buf + pos, sizeof(size));
+  pos += sizeof(size);
+  if (pos + size > buf_size)
+    return false;
+  sv = std::string_view(buf + pos, size);
+  pos += size;
+  return true;
+}
+
+inline void json_escape(std::string &dst, std::string_view src) {
+  for (unsigned char c : src) {
+    switch (c) {
+    case '"':
+      dst.append("\\\"");
+      break;
+    case '\\':
+      dst.append("\\\\");
+      break;
+    case '\n':
+      dst.append("\\n");
+      break;
+    case '\r':
+      dst.append("\\r");
+      break;
+    case '\t':
+      dst.append("\\t");
+      break;
+    default:
+      if (c < 0x20) {
+        dst.append(std::format("\\u{0:04x}", static_cast<unsigned>(c)));
+      } else {
+        dst.push_back(static_cast<char>(c));
+      }
+      break;
+    }
+  }
+}
+
+inline void json_field(std::string &dst, std::string_view key,
+                       std::string_view value) {
+  dst.append(",\"");
+  json_escape(dst, key);
+  dst.append("\":\"");
+  json_escape(dst, value);
+  dst.push_back('"');
+}
+
+/**
+ * @note A quoted value is escaped as a string of JSON, the control bytes
+ * included.
+ */
+inline void logfmt_value(std::string &dst, std::string_view value) {
+  bool quote = value.empty();
+  for (unsigned char c : value) {
+    if (c <= ' ' || c == 0x7f || c == '=' || c == '"' || c == '\\') {
+      quote = true;
+      break;
+    }
+  }
+  if (!quote) {
+    dst.append(value);
+    return;
+  }
+
+  dst.push_back('"');
+  json_escape(dst, value);
+  dst.push_back('"');
+}
+
+/**
+ * @brief A key of logfmt cannot be quoted: the bytes that would end or split
+ * it are replaced by `_`, and an empty key is `_`.
+ */
+inline void logfmt_key(std::string &dst, std::string_view key) {
+  if (key.empty()) {
+    dst.push_back('_');
+    return;
+  }
+  for (unsigned char c : key) {
+    if (c <= ' ' || c == 0x7f || c == '=' || c == '"' || c == '\\') {
+      dst.push_back('_');
+    } else {
+      dst.push_back(static_cast<char>(c));
+    }
+  }
+}
+
+inline void logfmt_field(std::string &dst, std::string_view key,
+                         std::string_view value) {
+  dst.push_back(' ');
+  logfmt_key(dst, key);
+  dst.push_back('=');
+  logfmt_value(dst, value);
+}
+
+/**
+ * @brief A user key named as one of the fields of the encoders is prefixed
+ * with `_`, so that it never overrides the field.
+ */
+inline std::string user_key(std::string_view key) {
+  for (std::string_view field :
+       {"ts", "level", "module", "pid", "tid", "file", "line", "msg"}) {
+    if (key == field)
+      return "_" + std::string(key);
+  }
+  return std::string(key);
+}
+
+inline std::string_view level_name(int level) {
+  switch (level) {
+  case SS_LOG_LEVEL_ERROR:
+    return "error";
+  case SS_LOG_LEVEL_WARN:
+    return "warn";
+  case SS_LOG_LEVEL_INFO:
+    return "info";
+  case SS_LOG_LEVEL_DEBUG:
+    return "debug";
+  default:
+    return "print";
+  }
+}
+
+/**
+ * @brief RFC 3339, UTC, with milliseconds.
+ */
+inline std::string utc_time(uint64_t timestamp_ms) {
+  time_t raw_time = static_cast<time_t>(timestamp_ms / 1000);
+  struct tm tm_info {};
+#if defined(_WIN32) || defined(_WIN64)
+  gmtime_s(&tm_info, &raw_time);
+#else
+  gmtime_r(&raw_time, &tm_info);
+#endif
+  return std::format("{0:04d}-{1:02d}-{2:02d}T{3:02d}:{4:02d}:{5:02d}.{6:03d}Z",
+                     tm_info.tm_year + 1900, tm_info.tm_mon + 1,
+                     tm_info.tm_mday, tm_info.tm_hour, tm_info.tm_min,
+                     tm_info.tm_sec, static_cast<int>(timestamp_ms % 1000));
+}
+} // namespace inner
+
+/**
+ * @brief Pack the binary fields of a structured record into `buffer`.
+ *
+ * @return false if the fields do not fit into the buffer.
+ */
+inline bool pack(ShmBuf &buffer, int level, std::string_view module,
+                 std::string_view file, int line, std::string_view msg,
+                 size_t nb_kvs, const ss_log_kv_t *kvs) {
+  auto &data = buffer.data.record;
+  buffer.type = ShmBufDataType::kRecord;
+  buffer.level = level;
+  data.timestamp_ms = realtime_ms();
+  data.tid = thread::get_tid_impl();
+  data.line = line;
+  data.nb_kvs = 0;
+
+  size_t pos = 0;
+  if (!inner::put(data.buf, pos, module) || !inner::put(data.buf, pos, file) ||
+      !inner::put(data.buf, pos, msg)) {
+    return false;
+  }
+  for (size_t i = 0; i < nb_kvs; ++i) {
+    std::string_view key = kvs[i].key ? kvs[i].key : "";
+    std::string_view value = kvs[i].value ? kvs[i].value : "";
+    if (key.empty())
+      continue;
+    if (!inner::put(data.buf, pos, key) || !inner::put(data.buf, pos, value))
+      return false;
+    ++data.nb_kvs;
+  }
+  data.buf_size = pos;
+  return true;
+}
+
+/**
+ * @brief The number of bytes of `buffer` that have to be copied into a slot.
+ */
+inline size_t packed_size(const ShmBuf &buffer) {
+  return sizeof(ShmBuf) - kLogBufferSize + buffer.data.record.buf_size;
+}
+
+inline std::optional<View> unpack(const ShmBuf &buffer, int64_t pid) {
+  const auto &data = buffer.data.record;
+  if (buffer.type != ShmBufDataType::kRecord || data.buf_size > kLogBufferSize)
+    return std::nullopt;
+
+  View view {};
+  view.level = buffer.level;
+  view.timestamp_ms = data.timestamp_ms;
+  view.tid = data.tid;
+  view.pid = pid;
+  view.line = data.line;
+
+  size_t pos = 0;
+  if (!inner::get(data.buf, data.buf_size, pos, view.module) ||
+      !inner::get(data.buf, data.buf_size, pos, view.file) ||
+      !inner::get(data.buf, data.buf_size, pos, view.msg)) {
+    return std::nullopt;
+  }
+  view.kvs.reserve(data.nb_kvs);
+  for (uint32_t i = 0; i < data.nb_kvs; ++i) {
+    std::string_view key, value;
+    if (!inner::get(data.buf, data.buf_size, pos, key) ||
+        !inner::get(data.buf, data.buf_size, pos, value)) {
+      return std::nullopt;
+    }
+    view.kvs.emplace_back(key, value);
+  }
+  return view;
+}
+
+/**
+ * @brief The printf-style log of `buffer` as a record, its prefix (time,
+ * thread id) is replaced by the fields.
+ *
+ * @note The string views point into `buffer`.
+ */
+inline View log_view(const ShmBuf &buffer, int64_t pid) {
+  const auto &data = buffer.data.log;
+  size_t buf_size = UTILS_MIN(data.buf_size, kLogBufferSize);
+  size_t prefix_size = UTILS_MIN(data.prefix_size, buf_size);
+  size_t module_size = UTILS_MIN(data.module_size, kLogBufferSize - buf_size);
+
+  View view {};
+  view.level = buffer.level;
+  view.timestamp_ms = data.timestamp_ms;
+  view.tid = data.tid;
+  view.pid = pid;
+  view.module = std::string_view(data.buf + buf_size, module_size);
+  view.msg = std::string_view(data.buf + prefix_size, buf_size - prefix_size);
+  while (view.msg.ends_with('\n')) {
+    view.msg.remove_suffix(1);
+  }
+  return view;
+}
+
+/**
+ * @brief Human-readable, the same layout as `Fmt::s_pre`.
+ */
+inline std::string encode_human(const View &view, bool ansi_enable) {
+  std::string_view prefix, color;
+  switch (view.level) {
+  case SS_LOG_LEVEL_ERROR:
+    prefix = "Error", color = ANSI_RED;
+    break;
+  case SS_LOG_LEVEL_WARN:
+    prefix = "Warn", color = ANSI_YELLOW;
+    break;
+  case SS_LOG_LEVEL_INFO:
+    prefix = "Info", color = ANSI_GREEN;
+    break;
+  case SS_LOG_LEVEL_DEBUG:
+    prefix = "Debug", color = ANSI_NONE;
+    break;
+  default:
+    prefix = "Print", color = ANSI_NONE;
+    break;
+  }
+
+  std::string body(view.msg);
+  for (const auto &[key, value] : view.kvs) {
+    inner::logfmt_field(body, key, value);
+  }
+
+  std::string result;
+  result.reserve(io::Fmt::kPrefixLength + body.size() + 32);
+  if (ansi_enable) {
+    result.append(color);
+  }
+  result.append(io::Fmt::s_pre(prefix, view.module, view.file, view.line,
+                               static_cast<time_t>(view.timestamp_ms / 1000),
+                               view.tid));
+  if (ansi_enable) {
+    result.append(ANSI_NONE);
+  }
+  result.append(io::Fmt::row_gs("{0}", body)).push_back('\n');
+  return result;
+}
+
+/**
+ * @brief JSON lines.
+ */
+inline std::string encode_json(const View &view) {
+  std::string result;
+  result.reserve(view.msg.size() + 160 + view.kvs.size() * 32);
+  result.append(std::format("{{\"ts\":\"{0}\",\"level\":\"{1}\"",
+                            inner::utc_time(view.timestamp_ms),
+                            inner::level_name(view.level)));
+  inner::json_field(result, "module", view.module);
+  result.append(
+    std::format(",\"pid\":{0},\"tid\":{1}", view.pid, view.tid));
+  if (!view.file.empty()) {
+    inner::json_field(result, "file", view.file);
+    result.append(std::format(",\"line\":{0}", view.line));
+  }
+  inner::json_field(result, "msg", view.msg);
+  for (const auto &[key, value] : view.kvs) {
+    inner::json_field(result, inner::user_key(key), value);
+  }
+  result.append("}\n");
+  return result;
+}
+
+/**
+ * @brief logfmt.
+ */
+inline std::string encode_logfmt(const View &view) {
+  std::string result;
+  result.reserve(view.msg.size() + 128 + view.kvs.size() * 32);
+  result.append("ts=").append(inner::utc_time(view.timestamp_ms));
+  inner::logfmt_field(result, "level", inner::level_name(view.level));
+  inner::logfmt_field(result, "module", view.module);
+  result.append(std::format(" pid={0} tid={1}", view.pid, view.tid));
+  if (!view.file.empty()) {
+    inner::logfmt_field(result, "file", view.file);
+    result.append(std::format(" line={0}", view.line));
+  }
+  inner::logfmt_field(result, "msg", view.msg);
+  for (const auto &[key, value] : view.kvs) {
+    inner::logfmt_field(result, inner::user_key(key), value);
+  }
+  result.push_back('\n');
+  return result;
+}
+
+/**
+ * @param[in] encoder @ref `enum SsLogEncoder`.
+ */
+inline std::string encode(int encoder, const View &view, bool ansi_enable) {
+  switch (encoder) {
+  case SsLogEncoder::kSsLogEncoderJson:
+    return encode_json(view);
+  case SsLogEncoder::kSsLogEncoderLogfmt:
+    return encode_logfmt(view);
+  default:
+    return encode_human(view, ansi_enable);
+  }
+}
+} // namespace record
+} // namespace log
+} // namespace utils
+} // namespace sirius
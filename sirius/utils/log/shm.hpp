@@ -3,6 +3,7 @@
 #include "utils/decls.h"
 /* clang-format on */
 
+#include "utils/futex.hpp"
 #include "utils/log/utils.hpp"
 #include "utils/process/mutex.hpp"
 #include "utils/time.hpp"
@@ -10,6 +11,9 @@
 #if defined(_WIN32) || defined(_WIN64)
 #else
 #  include <sys/mman.h>
+#  if defined(__linux__)
+#    include <linux/mempolicy.h>
+#  endif
 #endif
 
 #include <functional>
@@ -24,12 +28,6 @@ namespace log {
  */
 inline constexpr size_t kShmCacheLineSize = 64;
 
-enum class ShmSlotState : int {
-  kFree = 0,
-  kWaiting = 1,
-  kReady = 2,
-};
-
 enum class ShmBufDataFsType : int {
   kNone = 0, // Make no changes.
   kStd = 1,  // Set to default `stdout` / `stderr`.
@@ -39,16 +37,51 @@ enum class ShmBufDataFsType : int {
 enum class ShmBufDataType : int {
   kLog = 0,    // likely
   kConfig = 1, // unlikely
+  kRecord = 2, // Structured record, encoded by the consumer.
 };
 
 struct ShmBuf {
   ShmBufDataType type;
+
+  /**
+   * @note
+   * - (1) level <= SS_LOG_LEVEL_WARN: stderr.
+   *
+   * - (2) level > SS_LOG_LEVEL_WARN: stdout.
+   *
+   * - (3) Placed ahead of the `data`, since the producer only copies the used
+   * head of the buffer into the slot.
+   */
+  int level;
+
   union {
+    /**
+     * @note The `module_size` bytes of the module follow the `buf_size` bytes
+     * of the text, for the binary archive.
+     */
     struct {
+      uint64_t timestamp_ms; // Wall clock, since the epoch.
+      uint64_t tid;
+      size_t module_size;
+      size_t prefix_size; // The head of `buf` written by the `Fmt::s_pre`.
       size_t buf_size;
       char buf[kLogBufferSize];
     } log;
 
+    /**
+     * @note The `buf` is packed by `record::pack` and holds the module, the
+     * file, the message and the key-value pairs, each as a length-prefixed
+     * string.
+     */
+    struct {
+      uint64_t timestamp_ms; // Wall clock, since the epoch.
+      uint64_t tid;
+      int line;
+      uint32_t nb_kvs;
+      size_t buf_size;
+      char buf[kLogBufferSize];
+    } record;
+
     struct {
       ShmBufDataFsType type;
       char path[kLogPathMax];
@@ -60,36 +93,143 @@ struct ShmBuf {
 #  warning "--- Add Ansi ---"
 #endif
       int ansi_disable;
+
+      /**
+       * @ref `enum SsLogEncoder`.
+       */
+      int encoder;
+      int dedup;
     } fs;
   } data;
-
-  /**
-   * @note
-   * - (1) level <= SS_LOG_LEVEL_WARN: stderr.
-   *
-   * - (2) level > SS_LOG_LEVEL_WARN: stdout.
-   */
-  int level;
 };
 
+inline constexpr size_t kShmSlotHeadSize = 48;
+
+/**
+ * @brief The bytes of a message carried by a slot.
+ *
+ * @note Raised if needed so that the longest `ShmBuf` spans at most half a
+ * shard, thus it can always be claimed.
+ */
+inline constexpr size_t kShmSlotDataSize =
+  UTILS_MAX(kShmSlotSize - kShmSlotHeadSize,
+            (sizeof(ShmBuf) + kShmShardCapacity / 2 - 1) /
+              (kShmShardCapacity / 2));
+inline constexpr size_t kShmSlotPartsMax =
+  (sizeof(ShmBuf) + kShmSlotDataSize - 1) / kShmSlotDataSize;
+
 #if defined(_MSC_VER)
 #  pragma warning(push)
 #  pragma warning(disable: 4324)
 #endif
+/**
+ * @note
+ * - (1) A slot of a bounded MPMC ring in the manner of Dmitry Vyukov. For the
+ * position `pos` of a shard, whose slot is `pos & (kShmShardCapacity - 1)`,
+ * the `sequence` of the slot reads:
+ *   - `pos`: free, the producer which claims `pos` from the `write_index` owns
+ *   it;
+ *   - `pos + 1`: ready, the consumer owns it;
+ *   - `pos + kShmShardCapacity`: consumed, free for the next lap.
+ * So a position below the `write_index` whose `sequence` is still `pos` is
+ * being written by its `pid`.
+ *
+ * - (2) A message is the used head of a `ShmBuf`, split over `nb_parts`
+ * contiguous positions, claimed at once. The parts are published from the
+ * last one, so a ready head means a ready message.
+ *
+ * - (3) The producer reserves the free slots by a CAS of their `pid` from `0`
+ * before it claims them, and publishes each of them by a CAS of the
+ * `sequence` from `pos`. A slot published by someone else, e.g. a crash
+ * flush, is then never written back to an older `sequence`.
+ */
 struct alignas(kShmCacheLineSize) ShmSlot {
-  std::atomic<ShmSlotState> state;
+  std::atomic<uint64_t> sequence;
+
+  /**
+   * @brief The producer that reserved the slot, `0` once consumed.
+   */
+  std::atomic<int64_t> pid;
   std::atomic<uint64_t> timestamp_ms;
 
-  int64_t pid;
-  ShmBuf buffer;
+  /**
+   * @brief Steady clock, the key with which the daemon merges the shards.
+   *
+   * @note Published by the `sequence`.
+   */
+  uint64_t timestamp_ns;
+
+  uint32_t part; // The index of the slot in its message.
+  uint32_t nb_parts;
+  uint64_t size; // The bytes of the whole message.
+  char data[kShmSlotDataSize];
 };
 #if defined(_MSC_VER)
 #  pragma warning(pop)
 #endif
+ss_static_assert(offsetof(ShmSlot, data) == kShmSlotHeadSize);
+
+/**
+ * @note One cache line each, so the lock-free heartbeats of the processes do
+ * not contend with each other.
+ */
+struct alignas(kShmCacheLineSize) ShmSlotMap {
+  std::atomic<int64_t> pid;
 
-struct ShmSlotMap {
-  int64_t pid;
-  uint64_t timestamp_ms;
+  /**
+   * @brief Heartbeat, steady clock, refreshed by the producer of the process
+   * without any lock, @ref `Shm::Master::heartbeat`.
+   */
+  std::atomic<uint64_t> timestamp_ms;
+};
+
+struct ShmStatsPid {
+  std::atomic<int64_t> pid;
+  std::atomic<uint64_t> nb_bytes;
+};
+
+/**
+ * @brief Metrics of the ring, @ref `sirius_log --stats`.
+ *
+ * @note
+ * - (1) The counters are monotonic since the startup of the daemon, the rates
+ * are derived by the reader from two samples.
+ *
+ * - (2) Updated with relaxed atomics, so a snapshot is not exactly consistent.
+ */
+struct ShmStats {
+  // --- Producers ---
+  std::atomic<uint64_t> producer_spins;  // Retries waiting for a free slot.
+  std::atomic<uint64_t> producer_stalls; // Productions that had to retry.
+
+  // --- Consumer (daemon) ---
+  alignas(kShmCacheLineSize) std::atomic<uint64_t> occupancy;
+  std::atomic<uint64_t> occupancy_peak;
+  std::atomic<uint64_t> nb_slots;
+  std::atomic<uint64_t> nb_bytes;
+  std::atomic<uint64_t> nb_dropped;     // Corrupted / skipped slots.
+  std::atomic<uint64_t> nb_recovered;   // Stuck slots recovered by the monitor.
+  std::atomic<uint64_t> latency_ms_sum; // From the enqueue to the write.
+  std::atomic<uint64_t> latency_ms_max;
+  std::atomic<uint64_t> nb_writes; // `write` system calls.
+  std::atomic<uint64_t> write_ns_sum;
+  std::atomic<uint64_t> write_ns_max;
+  std::atomic<uint64_t> timestamp_ms; // Last sample of the consumer.
+  ShmStatsPid pids[kProcessMax];
+
+  void reset() {
+    for (auto *v :
+         {&producer_spins, &producer_stalls, &occupancy, &occupancy_peak,
+          &nb_slots, &nb_bytes, &nb_dropped, &nb_recovered, &latency_ms_sum,
+          &latency_ms_max, &nb_writes, &write_ns_sum, &write_ns_max,
+          &timestamp_ms}) {
+      v->store(0, std::memory_order_relaxed);
+    }
+    for (auto &p : pids) {
+      p.pid.store(0, std::memory_order_relaxed);
+      p.nb_bytes.store(0, std::memory_order_relaxed);
+    }
+  }
 };
 
 struct ShmHeader {
@@ -106,16 +246,45 @@ struct ShmHeader {
 
   std::atomic<bool> is_daemon_ready;
 
+  /**
+   * @brief Futex word, bumped after each change of `is_daemon_ready`.
+   */
+  std::atomic<uint32_t> daemon_ready_wake;
+
   /** ---
-   * @note These parameters should be guarded by the `mutex_shm`.
+   * @note These parameters should be guarded by the `mutex_shm`. Except that
+   * the fields of `slot_map` may also be read and the heartbeats written
+   * without the lock.
    */
   size_t slot_attached_count;
   enum MasterType slot_master_type[kProcessMax];
   ShmSlotMap slot_map[kProcessMax];
   //  ---
 
-  std::atomic<uint64_t> write_index;
-  std::atomic<uint64_t> read_index;
+  /**
+   * @brief One ring per shard, each over `kShmShardCapacity` slots, @ref
+   * `Shm::Master::get_shard_slots`.
+   */
+  struct alignas(kShmCacheLineSize) Shard {
+    std::atomic<uint64_t> write_index;
+    alignas(kShmCacheLineSize) std::atomic<uint64_t> read_index;
+  } shards[kShmNbShards];
+
+  uint64_t occupancy() const {
+    uint64_t count = 0;
+    for (const auto &shard : shards) {
+      count += shard.write_index.load(std::memory_order_relaxed) -
+        shard.read_index.load(std::memory_order_relaxed);
+    }
+    return count;
+  }
+
+  /**
+   * @brief Futex word of the idle consumer, bumped to wake it up.
+   */
+  std::atomic<uint32_t> consumer_wake;
+
+  ShmStats stats;
 
 #if !defined(_WIN32) && !defined(_WIN64)
   pthread_mutex_t mutex_shm;
@@ -129,8 +298,14 @@ class Shm {
  private:
   static constexpr size_t kHeaderOffset =
     (sizeof(ShmHeader) + kShmCacheLineSize - 1) & ~(kShmCacheLineSize - 1);
+#if _SIRIUS_LOG_SHM_HUGEPAGE
+  static constexpr size_t kShmAlignSize = 2 * 1024 * 1024;
+#else
+  static constexpr size_t kShmAlignSize = 1;
+#endif
   static constexpr size_t kTotalShmSize =
-    kHeaderOffset + (kShmCapacity * sizeof(ShmSlot));
+    (kHeaderOffset + (kShmCapacity * sizeof(ShmSlot)) + kShmAlignSize - 1) /
+    kShmAlignSize * kShmAlignSize;
 
  private:
   class LockGuard {
@@ -186,8 +361,40 @@ class Shm {
     auto mutex_crash_unlock() { return parent_.mutex_crash_->unlock(); }
     ShmHeader *get_shm_header() const { return header_; }
     ShmSlot *get_shm_slots() const { return reinterpret_cast<ShmSlot *>(reinterpret_cast<uint8_t *>(header_) + kHeaderOffset); }
+    ShmSlot *get_shard_slots(size_t shard) const { return get_shm_slots() + shard * kShmShardCapacity; }
+    void numa_bind() { parent_.numa_bind(); }
     // clang-format on
 
+    /**
+     * @note Async-signal-safe.
+     */
+    void consumer_wake() {
+      header_->consumer_wake.fetch_add(1, std::memory_order_release);
+      futex::wake_shared(&header_->consumer_wake);
+    }
+
+    /**
+     * @brief Refresh the heartbeat of this process, at most once per
+     * `kProcessFeedGuardMs`.
+     *
+     * @note Lock-free, the cache line is written only by this process.
+     */
+    void heartbeat(uint64_t timestamp_ms) {
+      if (slot_index_ >= kProcessMax) [[unlikely]]
+        return;
+      auto &ts = header_->slot_map[slot_index_].timestamp_ms;
+      if (timestamp_ms - ts.load(std::memory_order_relaxed) >=
+          kProcessFeedGuardMs) {
+        ts.store(timestamp_ms, std::memory_order_relaxed);
+      }
+    }
+
+    void daemon_ready_store(bool ready) {
+      header_->is_daemon_ready.store(ready, std::memory_order_seq_cst);
+      header_->daemon_ready_wake.fetch_add(1, std::memory_order_release);
+      futex::wake_shared(&header_->daemon_ready_wake);
+    }
+
     void slots_free() {
       if (header_) {
         master_free();
@@ -202,8 +409,19 @@ class Shm {
         for (auto &t : header_->slot_master_type) {
           t = MasterType::kNone;
         }
-        header_->write_index.store(0);
-        header_->read_index.store(0);
+        for (auto &shard : header_->shards) {
+          shard.write_index.store(0);
+          shard.read_index.store(0);
+        }
+        for (size_t i = 0; i < kShmNbShards; ++i) {
+          ShmSlot *slots = get_shard_slots(i);
+          for (size_t j = 0; j < kShmShardCapacity; ++j) {
+            slots[j].sequence.store(j);
+            slots[j].pid.store(0);
+          }
+        }
+        header_->consumer_wake.store(0);
+        header_->stats.reset();
       } else {
         if (header_->magic != ShmHeader::kMagicHeader) {
           auto es = std::format("Invalid argument. `magic`: {0}{1}",
@@ -264,7 +482,7 @@ class Shm {
     ShmHeader *&header_;
     MasterType master_type_;
     std::jthread thread_guard_ {};
-    std::atomic<bool> thread_guard_ready_ = false;
+    size_t slot_index_ = kProcessMax;
 
     auto master_alloc() -> std::expected<void, UTrace> {
       logln_infosp("Master: {0}. Alloc", static_cast<int>(master_type_));
@@ -294,7 +512,8 @@ class Shm {
 
     bool slot_check(size_t index) const {
       return (header_->slot_master_type[index] == master_type_ &&
-              header_->slot_map[index].pid == process::pid());
+              header_->slot_map[index].pid.load(std::memory_order_relaxed) ==
+                process::pid());
     }
 
     /**
@@ -302,7 +521,9 @@ class Shm {
      * called
      */
     void slot_reset(size_t index) {
-      std::memset(header_->slot_map + index, 0, sizeof(ShmSlotMap));
+      header_->slot_map[index].pid.store(0, std::memory_order_relaxed);
+      header_->slot_map[index].timestamp_ms.store(0,
+                                                   std::memory_order_relaxed);
       header_->slot_master_type[index] = MasterType::kNone;
       header_->slot_attached_count =
         header_->slot_attached_count ? header_->slot_attached_count - 1 : 0;
@@ -316,6 +537,7 @@ class Shm {
         for (size_t i = 0; i < kProcessMax; ++i) {
           if (slot_check(i)) {
             slot_reset(i);
+            slot_index_ = kProcessMax;
             found = true;
             break;
           }
@@ -334,8 +556,11 @@ class Shm {
         if (header_->slot_master_type[i] == MasterType::kNone) {
           ++header_->slot_attached_count;
           header_->slot_master_type[i] = master_type_;
-          header_->slot_map[i].pid = process::pid();
-          header_->slot_map[i].timestamp_ms = time::get_monotonic_steady_ms();
+          header_->slot_map[i].pid.store(process::pid(),
+                                         std::memory_order_relaxed);
+          header_->slot_map[i].timestamp_ms.store(
+            time::get_monotonic_steady_ms(), std::memory_order_relaxed);
+          slot_index_ = i;
           break;
         }
         if (i == kProcessMax - 1) {
@@ -370,8 +595,19 @@ class Shm {
         .utrace_transform_error_default();
     }
 
+    /**
+     * @brief Reclaim the slots of the native processes that are gone.
+     *
+     * @note
+     * - (1) A fresh heartbeat proves liveness without a system call, a stale
+     * one is only a hint, the process is reclaimed once `process::is_alive`
+     * says it no longer exists. So an idle process is never evicted.
+     *
+     * - (2) The scan is lock-free, the `mutex_shm` is taken only to reset a
+     * dead slot.
+     */
     void daemon_thread_guard(std::stop_token stop_token) {
-      constexpr uint64_t kOnceSleepMs = 2000;
+      constexpr uint64_t kOnceSleepMs = 500;
       constexpr int kSplits =
         UTILS_MAX(1, kProcessGuardTimeoutMs / kOnceSleepMs);
       while (!stop_token.stop_requested()) {
@@ -381,78 +617,35 @@ class Shm {
             return;
         }
 
-        {
-          auto lock = lock_guard();
-          if (header_->slot_attached_count == kProcessNbDaemon)
+        uint64_t timestamp_ms = time::get_monotonic_steady_ms();
+        for (size_t i = 0; i < kProcessMax; ++i) {
+          ShmSlotMap &ssm = header_->slot_map[i];
+          int64_t pid = ssm.pid.load(std::memory_order_relaxed);
+          if (pid == 0 || pid == process::pid())
+            continue;
+          if (timestamp_ms - ssm.timestamp_ms.load(std::memory_order_relaxed) <=
+                kProcessGuardTimeoutMs ||
+              process::is_alive(pid)) {
             continue;
-          uint64_t timestamp_ms = time::get_monotonic_steady_ms();
-          for (size_t i = 0; i < kProcessMax; ++i) {
-            if (header_->slot_master_type[i] != MasterType::kNative)
-              continue;
-            ShmSlotMap &ssm = header_->slot_map[i];
-            if (timestamp_ms - ssm.timestamp_ms > kProcessGuardTimeoutMs) {
-              slot_reset(i);
-            }
-          }
-        }
-      }
-    }
-
-    auto native_master_alloc() -> std::expected<void, UTrace> {
-      if (auto ret = slot_alloc(); !ret.has_value())
-        utrace_return(ret);
-
-      thread_guard_ =
-        std::jthread(std::bind_front(&Master::native_thread_guard, this));
-      constexpr int kRetryTimes = 10;
-      for (int i = 0; i < kRetryTimes; ++i) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        if (thread_guard_ready_.load(std::memory_order_relaxed))
-          break;
-        if (i == kRetryTimes - 1) {
-          master_free_impl();
-          return std::unexpected(UTrace("Fail to start `thread_guard`"));
-        }
-      }
-
-      return {};
-    }
-
-    void native_thread_guard(std::stop_token stop_token) {
-      size_t index = 0;
-
-      {
-        auto lock = lock_guard();
-        for (; !slot_check(index); ++index) {
-          if (index == kProcessMax - 1) {
-            logln_error("No valid pid was matched");
-            return;
           }
-        }
-      }
-      thread_guard_ready_.store(true, std::memory_order_relaxed);
 
-      constexpr int kOnceSleepMs = 1000;
-      constexpr int kSplits = UTILS_MAX(1, kProcessFeedGuardMs / kOnceSleepMs);
-      while (!stop_token.stop_requested()) {
-        {
-          uint64_t timestamp_ms = time::get_monotonic_steady_ms();
           auto lock = lock_guard();
-          if (slot_check(index)) [[likely]] {
-            header_->slot_map[index].timestamp_ms = timestamp_ms;
-          } else {
-            logln_error("\nInvalid argument. `{0}` exit", __func__);
-            return;
+          if (header_->slot_master_type[i] == MasterType::kNative &&
+              ssm.pid.load(std::memory_order_relaxed) == pid) {
+            logln_infosp("Reclaim the slot of the dead process: {0}", pid);
+            slot_reset(i);
           }
         }
-
-        for (int i = 0; i < kSplits; ++i) {
-          std::this_thread::sleep_for(std::chrono::milliseconds(kOnceSleepMs));
-          if (stop_token.stop_requested())
-            return;
-        }
       }
     }
+
+    /**
+     * @note No guard thread, the heartbeat is fed by the producer and the
+     * daemon checks the liveness, @ref `daemon_thread_guard`.
+     */
+    auto native_master_alloc() -> std::expected<void, UTrace> {
+      return slot_alloc().utrace_transform_error_default();
+    }
   };
 
  private:
@@ -629,6 +822,7 @@ class Shm {
       const int errno_err = errno;
       return std::unexpected(UTrace(c_error(errno_err, "mmap")));
     }
+    memory_place(ptr);
 
     return mutex_create(static_cast<ShmHeader *>(ptr))
       .and_then([&]() -> std::expected<void, UTrace> {
@@ -641,6 +835,38 @@ class Shm {
       });
   }
 
+  /**
+   * @brief Huge pages, then pre-fault, in this order, so that the faults are
+   * served by huge pages.
+   *
+   * @note Best effort, a failure only costs the latency.
+   */
+  void memory_place([[maybe_unused]] void *ptr) {
+#  if _SIRIUS_LOG_SHM_HUGEPAGE && defined(MADV_HUGEPAGE)
+    if (madvise(ptr, kTotalShmSize, MADV_HUGEPAGE) == -1) {
+      const int errno_err = errno;
+      logln_warnsp("{0}", c_error(errno_err, "madvise (MADV_HUGEPAGE)"));
+    }
+#  endif
+
+#  if _SIRIUS_LOG_SHM_POPULATE
+#    if defined(MADV_POPULATE_WRITE)
+    if (madvise(ptr, kTotalShmSize, MADV_POPULATE_WRITE) == 0)
+      return;
+#    endif
+    /**
+     * @note Fallback for the kernels before 5.14. A read fault on the shared
+     * memory allocates the page as well, and leaves the content untouched.
+     */
+    const long page_size = sysconf(_SC_PAGESIZE);
+    const size_t step = page_size > 0 ? static_cast<size_t>(page_size) : 4096;
+    auto base = static_cast<volatile const uint8_t *>(ptr);
+    for (size_t offset = 0; offset < kTotalShmSize; offset += step) {
+      (void)base[offset];
+    }
+#  endif
+  }
+
   void memory_unmap() {
     if (!header_)
       return;
@@ -659,6 +885,47 @@ class Shm {
   }
 #endif
 
+  /**
+   * @brief Prefer the NUMA node of the calling thread for the shared memory,
+   * and migrate the pages which are already placed.
+   *
+   * @note Best effort. Migrating the pages mapped by the other processes
+   * requires `CAP_SYS_NICE`, otherwise only the future faults follow the
+   * policy.
+   */
+  void numa_bind() {
+#if _SIRIUS_LOG_SHM_NUMA && defined(__linux__) && defined(SYS_mbind) && \
+  defined(SYS_getcpu)
+    if (!header_)
+      return;
+
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == -1) {
+      const int errno_err = errno;
+      logln_warnsp("{0}", c_error(errno_err, "getcpu"));
+      return;
+    }
+
+    constexpr size_t kNodeBits = 8 * sizeof(unsigned long);
+    unsigned long nodemask[16] {};
+    if (node >= kNodeBits * std::size(nodemask))
+      return;
+    nodemask[node / kNodeBits] = 1UL << (node % kNodeBits);
+
+    for (unsigned flags : {MPOL_MF_MOVE_ALL, MPOL_MF_MOVE}) {
+      if (syscall(SYS_mbind, header_, kTotalShmSize, MPOL_PREFERRED, nodemask,
+                  kNodeBits * std::size(nodemask), flags) == 0) {
+        logln_infosp("Shared memory prefers NUMA node: {0}", node);
+        return;
+      }
+      if (errno != EPERM)
+        break;
+    }
+    const int errno_err = errno;
+    logln_warnsp("{0}", c_error(errno_err, "mbind"));
+#endif
+  }
+
   auto mutex_create([[maybe_unused]] ShmHeader *header)
     -> std::expected<void, UTrace> {
     auto fn_destroy = [&](std::optional<process::GMutex> &mutex) {
@@ -21,17 +21,30 @@ ss_static_assert(kMutexProcessKey != kMutexShmKey &&
                    kMutexShmKey != kMutexCrashKey,
                  "The mutex name must be unique");
 
-inline constexpr size_t kLogBufferSize = 4096;
+inline constexpr size_t kLogBufferSize = 16384;
 inline constexpr size_t kLogPathMax = 4096;
 inline constexpr size_t kProcessMax = 128;
 inline constexpr size_t kProcessNbDaemon = 1;
 inline constexpr uint64_t kProcessFeedGuardMs = 2000;
 inline constexpr uint64_t kProcessGuardTimeoutMs = 8000;
 ss_static_assert(kProcessFeedGuardMs <= kProcessGuardTimeoutMs);
-inline constexpr uint64_t kShmSlotResetTimeoutMs = 5000;
 inline constexpr size_t kShmCapacity =
   utils::next_power_of_2(_SIRIUS_LOG_SHM_CAPACITY);
 
+/**
+ * @note At least 8 slots per shard.
+ */
+inline constexpr size_t kShmNbShards =
+  UTILS_MAX(1, UTILS_MIN(utils::next_power_of_2(_SIRIUS_LOG_SHM_SHARDS),
+                         kShmCapacity / 8));
+inline constexpr size_t kShmShardCapacity = kShmCapacity / kShmNbShards;
+
+/**
+ * @note At least two cache lines.
+ */
+inline constexpr size_t kShmSlotSize =
+  (UTILS_MAX(_SIRIUS_LOG_SHM_SLOT_SIZE, 128) + 63) & ~static_cast<size_t>(63);
+
 enum class MasterType : int {
   kNone = 0,
   kDaemon = 1,
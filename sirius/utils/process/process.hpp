@@ -3,6 +3,10 @@
 #include "utils/decls.h"
 /* clang-format on */
 
+#if !defined(_WIN32) && !defined(_WIN64)
+#  include <signal.h>
+#endif
+
 namespace sirius {
 namespace utils {
 namespace process {
@@ -18,6 +22,30 @@ inline int64_t pid() {
   return static_cast<int64_t>(getpid()); // pid_t
 #endif
 }
+
+/**
+ * @brief Whether the process `pid` still exists.
+ *
+ * @note A process that cannot be inspected for lack of permission counts as
+ * alive, only a definite "no such process" counts as dead.
+ */
+inline bool is_alive(int64_t pid) {
+  if (pid <= 0)
+    return false;
+#if defined(_WIN32) || defined(_WIN64)
+  HANDLE handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE,
+                              static_cast<DWORD>(pid));
+  if (!handle)
+    return GetLastError() != ERROR_INVALID_PARAMETER;
+  DWORD exit_code = 0;
+  bool alive =
+    !GetExitCodeProcess(handle, &exit_code) || exit_code == STILL_ACTIVE;
+  CloseHandle(handle);
+  return alive;
+#else
+  return kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH;
+#endif
+}
 } // namespace process
 } // namespace utils
 } // namespace sirius
@@ -3,6 +3,10 @@
 #include "utils/decls.h"
 /* clang-format on */
 
+#if defined(__linux__)
+#  include <sched.h>
+#endif
+
 namespace sirius {
 namespace utils {
 namespace thread {
@@ -171,6 +175,21 @@ inline uint64_t get_tid_impl() {
   return (uint64_t)(uintptr_t)pthread_self();
 #endif
 }
+
+/**
+ * @return The CPU the calling thread is running on, or -1 if unknown.
+ *
+ * @note Only a hint, the thread may migrate right after.
+ */
+inline int64_t get_cpu_impl() {
+#if defined(__linux__) && defined(__GLIBC__)
+  return static_cast<int64_t>(sched_getcpu());
+#elif defined(_WIN32) || defined(_WIN64)
+  return static_cast<int64_t>(GetCurrentProcessorNumber());
+#else
+  return -1;
+#endif
+}
 } // namespace thread
 } // namespace utils
 } // namespace sirius
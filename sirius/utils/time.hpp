@@ -29,6 +29,13 @@ inline uint64_t get_process_cputime_ns() noexcept {
 #endif
 }
 
+inline uint64_t get_monotonic_steady_ns() {
+  auto now = std::chrono::steady_clock::now();
+  auto duration = now.time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+    .count();
+}
+
 inline uint64_t get_monotonic_steady_ms() {
   auto now = std::chrono::steady_clock::now();
   auto duration = now.time_since_epoch();
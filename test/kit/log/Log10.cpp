@@ -0,0 +1,111 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "inner/utils.h"
+
+#ifndef _GEN_FILE_NAME
+#  define _GEN_FILE_NAME "./_gen_log.txt"
+#endif
+
+namespace {
+inline constexpr const char *kGenFileName = _GEN_FILE_NAME;
+inline constexpr int kNbRows = 64;
+inline constexpr int kNbLongRows = 64;
+
+inline std::string row(const char *mode, int i) {
+  return std::string(mode) + "," + std::to_string(i) + "," +
+    std::to_string(i * i) + "\n";
+}
+
+/**
+ * @note 64 rows of 600 bytes, a text longer than a log.
+ */
+inline std::string long_row(const char *mode, int i) {
+  return std::string(mode) + ",long," + std::to_string(i) + "," +
+    std::string(600, static_cast<char>('a' + i % 26));
+}
+
+inline void rows_write(SsThreadProcess shared, const char *mode) {
+  ss_log_config_t cfg {};
+  cfg.out.flags = kSS_O_RDWR | kSS_O_CREAT | kSS_O_APPEND;
+  cfg.out.mode = SS_FS_PERM_RW;
+  cfg.out.shared = shared;
+  cfg.out.log_path = kGenFileName;
+  cfg.err = cfg.out;
+  ss_log_configure(&cfg);
+
+  for (int i = 0; i < kNbRows; ++i) {
+    std::string line = row(mode, i);
+    UTILS_ASSERT(ss_log_write_raw(SS_LOG_LEVEL_INFO, line.data(),
+                                  line.size()) == 0);
+  }
+
+  std::string text;
+  for (int i = 0; i < kNbLongRows; ++i) {
+    text += long_row(mode, i) + "\n";
+  }
+  ss_log_info("%s", text.c_str());
+
+  cfg.out.log_path = nullptr;
+  cfg.err = cfg.out;
+  ss_log_configure(&cfg);
+}
+
+inline int main_impl() {
+  std::filesystem::remove(kGenFileName);
+
+  UTILS_ASSERT(ss_log_write_raw(SS_LOG_LEVEL_INFO, nullptr, 1) == EINVAL);
+  UTILS_ASSERT(ss_log_write_raw(SS_LOG_LEVEL_NONE, "x\n", 2) == EINVAL);
+  UTILS_ASSERT(ss_log_write_raw(SS_LOG_LEVEL_INFO, nullptr, 0) == 0);
+
+  rows_write(SsThreadProcess::kSsThreadProcessPrivate, "private");
+  rows_write(SsThreadProcess::kSsThreadProcessShared, "shared");
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  std::ifstream ifs(kGenFileName, std::ios::binary);
+  UTILS_ASSERT(ifs.is_open());
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  const std::string text = ss.str();
+
+  /**
+   * @note Each row is a whole line, with neither prefix nor color.
+   */
+  for (const char *mode : {"private", "shared"}) {
+    for (int i = 0; i < kNbRows; ++i) {
+      std::string line = row(mode, i);
+      UTILS_ASSERT(text.starts_with(line) ||
+                   text.find("\n" + line) != std::string::npos);
+    }
+  }
+
+  /**
+   * @note The long text is split at its lines, none of them is lost.
+   */
+  for (const char *mode : {"private", "shared"}) {
+    for (int i = 0; i < kNbLongRows; ++i) {
+      UTILS_ASSERT(text.find(" > " + long_row(mode, i) + "\n") !=
+                   std::string::npos);
+    }
+  }
+
+  ss_log_infosp("Test passed\n");
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
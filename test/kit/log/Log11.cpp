@@ -0,0 +1,291 @@
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#  include <sched.h>
+#endif
+#if !defined(_WIN32) && !defined(_WIN64)
+#  include <signal.h>
+#  include <sys/mman.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+#include "inner/utils.h"
+
+#ifndef _GEN_FILE_NAME
+#  define _GEN_FILE_NAME "./_gen_log.txt"
+#endif
+
+/**
+ * @brief The shared ring of the log module: several producers over many laps
+ * of each shard, messages spanning several slots, the merge of the shards,
+ * and the recovery from a producer killed while writing.
+ */
+
+namespace {
+inline constexpr const char *kGenFileName = _GEN_FILE_NAME;
+inline constexpr int kNbThreads = 4;
+inline constexpr int kNbRows = 2000;
+inline constexpr int kNbMergeRows = 1000;
+inline constexpr int kNbKills = 8;
+inline constexpr int kNbAfterRows = 500;
+inline constexpr int kWaitMs = 10000;
+
+/**
+ * @note Up to 800 bytes of padding, so that a row spans up to 4 slots of the
+ * default size.
+ */
+inline std::string row(const char *tag, int producer, int i) {
+  return std::string(tag) + "," + std::to_string(producer) + "," +
+    std::to_string(i) + "," +
+    std::string(static_cast<size_t>(i % 5) * 200,
+                 static_cast<char>('a' + i % 26)) +
+    "\n";
+}
+
+inline void row_write(const char *tag, int producer, int i) {
+  std::string line = row(tag, producer, i);
+  UTILS_ASSERT(ss_log_write_raw(SS_LOG_LEVEL_INFO, line.data(),
+                                line.size()) == 0);
+}
+
+inline void sink_configure(const char *path) {
+  ss_log_config_t cfg {};
+  cfg.out.flags = kSS_O_RDWR | kSS_O_CREAT | kSS_O_APPEND;
+  cfg.out.mode = SS_FS_PERM_RW;
+  cfg.out.shared = SsThreadProcess::kSsThreadProcessShared;
+  cfg.out.log_path = path;
+  cfg.err = cfg.out;
+  ss_log_configure(&cfg);
+}
+
+/**
+ * @brief The indexes of the rows of each `tag,producer`, in the order of the
+ * file.
+ */
+using Rows = std::map<std::string, std::vector<int>>;
+
+inline std::string key(const char *tag, int producer) {
+  return std::string(tag) + "," + std::to_string(producer);
+}
+
+/**
+ * @note A line that starts with a tag of this test must be a whole row,
+ * anything else, e.g. the loss notice of a killed producer, is skipped.
+ */
+inline Rows rows_read() {
+  std::ifstream ifs(kGenFileName, std::ios::binary);
+  UTILS_ASSERT(ifs.is_open());
+  Rows rows;
+  std::string line;
+  while (std::getline(ifs, line)) {
+    for (const char *tag : {"lap", "merge", "kill", "after"}) {
+      if (!line.starts_with(std::string(tag) + ","))
+        continue;
+      std::istringstream fields(line.substr(std::strlen(tag) + 1));
+      int producer = -1;
+      int i = -1;
+      char comma = 0;
+      fields >> producer >> comma >> i;
+      UTILS_ASSERT(row(tag, producer, i) == line + "\n");
+      rows[key(tag, producer)].push_back(i);
+      break;
+    }
+  }
+  return rows;
+}
+
+inline bool rows_complete(const Rows &rows,
+                          const std::map<std::string, int> &expected) {
+  for (const auto &[k, nb] : expected) {
+    auto it = rows.find(k);
+    if (it == rows.end() || it->second.size() < static_cast<size_t>(nb))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Wait for the daemon to write the expected rows.
+ */
+inline Rows rows_wait(const std::map<std::string, int> &expected) {
+  Rows rows;
+  for (int ms = 0; ms < kWaitMs; ms += 100) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    rows = rows_read();
+    if (rows_complete(rows, expected))
+      break;
+  }
+  return rows;
+}
+
+/**
+ * @brief Each row of `rows` once, in any order.
+ */
+inline void rows_assert_all(const std::vector<int> &rows, int nb_rows) {
+  UTILS_ASSERT(rows.size() == static_cast<size_t>(nb_rows));
+  std::vector<bool> seen(static_cast<size_t>(nb_rows), false);
+  for (int i : rows) {
+    UTILS_ASSERT(i >= 0 && i < nb_rows && !seen[static_cast<size_t>(i)]);
+    seen[static_cast<size_t>(i)] = true;
+  }
+}
+
+/**
+ * @brief Walk the calling thread over the CPUs, and so over the shards.
+ */
+inline void cpu_next([[maybe_unused]] int i) {
+#if defined(__linux__)
+  static cpu_set_t allowed = []() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    (void)sched_getaffinity(0, sizeof(set), &set);
+    return set;
+  }();
+  int nb_cpus = CPU_COUNT(&allowed);
+  if (nb_cpus <= 1)
+    return;
+  int nth = i % nb_cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed) && nth-- == 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+      (void)sched_setaffinity(0, sizeof(set), &set);
+      return;
+    }
+  }
+#endif
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+inline int wait_child(pid_t pid) {
+  int status = 0;
+  UTILS_ASSERT(waitpid(pid, &status, 0) == pid);
+  return status;
+}
+
+/**
+ * @brief Kill producers while they write rows of several slots, then check
+ * that the shards still move: the rows of the survivors get through.
+ */
+inline void test_kill() {
+  void *memory = mmap(nullptr, sizeof(std::atomic<int>), PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  UTILS_ASSERT(memory != MAP_FAILED);
+  auto nb_written = new (memory) std::atomic<int>(0);
+
+  for (int k = 0; k < kNbKills; ++k) {
+    nb_written->store(0);
+    pid_t pid = fork();
+    UTILS_ASSERT(pid >= 0);
+    if (pid == 0) {
+      sink_configure(kGenFileName);
+      for (int i = 0;; ++i) {
+        row_write("kill", k, i);
+        nb_written->fetch_add(1);
+      }
+    }
+    while (nb_written->load() < 100) {
+      std::this_thread::yield();
+    }
+    UTILS_ASSERT(kill(pid, SIGKILL) == 0);
+    int status = wait_child(pid);
+    UTILS_ASSERT(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+  }
+  UTILS_ASSERT(munmap(memory, sizeof(std::atomic<int>)) == 0);
+
+  pid_t pid = fork();
+  UTILS_ASSERT(pid >= 0);
+  if (pid == 0) {
+    sink_configure(kGenFileName);
+    for (int i = 0; i < kNbAfterRows; ++i) {
+      row_write("after", 1, i);
+    }
+    _exit(0);
+  }
+  for (int i = 0; i < kNbAfterRows; ++i) {
+    row_write("after", 0, i);
+  }
+  int status = wait_child(pid);
+  UTILS_ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  Rows rows = rows_wait(
+    {{key("after", 0), kNbAfterRows}, {key("after", 1), kNbAfterRows}});
+  rows_assert_all(rows[key("after", 0)], kNbAfterRows);
+  rows_assert_all(rows[key("after", 1)], kNbAfterRows);
+}
+#endif
+
+inline int main_impl() {
+  std::filesystem::remove(kGenFileName);
+  sink_configure(kGenFileName);
+  std::map<std::string, int> expected;
+
+  // --- Laps, several producers and several slots per row ---
+  {
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < kNbThreads; ++t) {
+      threads.emplace_back([t]() {
+        for (int i = 0; i < kNbRows; ++i) {
+          row_write("lap", t, i);
+        }
+      });
+    }
+  }
+  for (int t = 0; t < kNbThreads; ++t) {
+    expected[key("lap", t)] = kNbRows;
+  }
+
+  // --- Merge, the rows of a thread over the shards stay in order ---
+  std::jthread([]() {
+    for (int i = 0; i < kNbMergeRows; ++i) {
+      cpu_next(i);
+      row_write("merge", 0, i);
+    }
+  }).join();
+  expected[key("merge", 0)] = kNbMergeRows;
+
+  /**
+   * @note Read before the kills, the head of a shard claimed by a killed
+   * producer delays the merge until it is recovered.
+   */
+  Rows rows = rows_wait(expected);
+  for (int t = 0; t < kNbThreads; ++t) {
+    rows_assert_all(rows[key("lap", t)], kNbRows);
+  }
+  const std::vector<int> &merged = rows[key("merge", 0)];
+  UTILS_ASSERT(merged.size() == static_cast<size_t>(kNbMergeRows));
+  for (int i = 0; i < kNbMergeRows; ++i) {
+    UTILS_ASSERT(merged[static_cast<size_t>(i)] == i);
+  }
+
+  // --- Producers killed while writing ---
+#if !defined(_WIN32) && !defined(_WIN64)
+  test_kill();
+#endif
+
+  sink_configure(nullptr);
+  ss_log_infosp("Test passed\n");
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
@@ -0,0 +1,69 @@
+#include <thread>
+
+#include "inner/utils.h"
+
+namespace {
+inline void log_records() {
+  ss_log_kv_t kvs[] = {
+    {"user", "alice"},
+    {"code", "404"},
+    {"path", "/api/v1/items?id=3"},
+    {"detail", "quote \" and\nnewline"},
+    {"control", "tab\tcarriage\rbell\a"},
+    {"level", "written as _level"},
+    {"", "skipped"},
+  };
+  constexpr size_t kNbKvs = sizeof(kvs) / sizeof(kvs[0]);
+
+  ss_log_kv_error("Request failed", kNbKvs, kvs);
+  ss_log_kv_warn("Request slow", kNbKvs, kvs);
+  ss_log_kv_info("Request done", 2, kvs);
+  ss_log_kv_debug("No fields", 0, nullptr);
+}
+
+inline int main_impl() {
+  ss_log_config_t cfg {};
+
+  for (auto shared : {SsThreadProcess::kSsThreadProcessShared,
+                      SsThreadProcess::kSsThreadProcessPrivate}) {
+    for (auto encoder : {SsLogEncoder::kSsLogEncoderHuman,
+                         SsLogEncoder::kSsLogEncoderJson,
+                         SsLogEncoder::kSsLogEncoderLogfmt}) {
+      cfg.out.shared = shared;
+      cfg.out.encoder = encoder;
+      cfg.err = cfg.out;
+      ss_log_configure(&cfg);
+
+      ss_log_infosp("--- shared: %d, encoder: %d ---\n", (int)shared,
+                    (int)encoder);
+      log_records();
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+  }
+
+  /**
+   * @note Records that do not fit into a slot are dropped.
+   */
+  char ultra_long_string[8192];
+  std::memset(ultra_long_string, 'Q', sizeof(ultra_long_string));
+  ultra_long_string[sizeof(ultra_long_string) - 1] = '\0';
+  ss_log_kv_t kv_long = {"long", ultra_long_string};
+  ss_log_kv_info("Ultra-long record", 1, &kv_long);
+
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
@@ -0,0 +1,74 @@
+#include "inner/utils.h"
+
+namespace {
+inline int g_nb_evaluated = 0;
+inline int g_gate_word = _SS_INNER_LOG_GATE_UNBOUND;
+
+inline int evaluated() {
+  return ++g_nb_evaluated;
+}
+
+inline int main_impl() {
+  const char *module = _SIRIUS_LOG_MODULE_NAME;
+  const int default_level = ss_log_get_level(nullptr);
+
+  UTILS_ASSERT(ss_log_set_level(module, SS_LOG_LEVEL_DEBUG + 1) == EINVAL);
+  UTILS_ASSERT(ss_log_set_level(module, SS_LOG_LEVEL_NONE - 1) == EINVAL);
+
+  // --- Module level ---
+  UTILS_ASSERT(ss_log_set_level(module, SS_LOG_LEVEL_WARN) == 0);
+  UTILS_ASSERT(ss_log_get_level(module) == SS_LOG_LEVEL_WARN);
+
+  g_nb_evaluated = 0;
+  ss_log_info("Disabled: %d\n", evaluated());
+  ss_log_debugsp("Disabled: %d\n", evaluated());
+  UTILS_ASSERT(g_nb_evaluated == 0);
+
+  ss_log_warn("Enabled: %d\n", evaluated());
+  ss_log_errorsp("Enabled: %d\n", evaluated());
+  UTILS_ASSERT(g_nb_evaluated == (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_WARN) +
+                 (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_ERROR));
+
+  // --- Default level does not override an explicit module level ---
+  UTILS_ASSERT(ss_log_set_level(nullptr, SS_LOG_LEVEL_NONE) == 0);
+  UTILS_ASSERT(ss_log_get_level(module) == SS_LOG_LEVEL_WARN);
+  UTILS_ASSERT(ss_log_get_level("Log3.other") == SS_LOG_LEVEL_NONE);
+
+  // --- Level is seen by the log macros ---
+  UTILS_ASSERT(ss_log_set_level(module, SS_LOG_LEVEL_NONE) == 0);
+  UTILS_ASSERT(ss_log_get_level(module) == SS_LOG_LEVEL_NONE);
+
+  g_nb_evaluated = 0;
+  ss_log_error("Disabled: %d\n", evaluated());
+  UTILS_ASSERT(g_nb_evaluated == 0);
+
+  // --- Gate word follows the level and the flight recorder ---
+  UTILS_ASSERT(ss_log_level_bind(module, &g_gate_word) == SS_LOG_LEVEL_NONE);
+  UTILS_ASSERT(ss_log_set_level(module, SS_LOG_LEVEL_INFO) == 0);
+  UTILS_ASSERT(g_gate_word == SS_LOG_LEVEL_INFO);
+  UTILS_ASSERT(ss_log_flight_recorder(4) == 0);
+  UTILS_ASSERT(g_gate_word == (SS_LOG_LEVEL_INFO | _SS_INNER_LOG_GATE_FLIGHT));
+  UTILS_ASSERT(ss_log_flight_recorder(0) == 0);
+  UTILS_ASSERT(g_gate_word == SS_LOG_LEVEL_INFO);
+
+  UTILS_ASSERT(ss_log_set_level(nullptr, default_level) == 0);
+  UTILS_ASSERT(ss_log_set_level(module, SS_LOG_LEVEL_DEBUG) == 0);
+  ss_log_infosp("Test passed\n");
+
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
@@ -0,0 +1,98 @@
+#include <thread>
+
+#include "inner/utils.h"
+
+namespace {
+inline int g_nb_evaluated = 0;
+
+inline int evaluated() {
+  return ++g_nb_evaluated;
+}
+
+inline void test_ratelimit() {
+  ss_log_ratelimit_t rl = SS_LOG_RATELIMIT_INITIALIZER;
+
+  for (int i = 0; i < 3; ++i) {
+    UTILS_ASSERT(ss_log_ratelimit(&rl, 60 * 1000, 3) == 0);
+  }
+  for (int i = 0; i < 5; ++i) {
+    UTILS_ASSERT(ss_log_ratelimit(&rl, 60 * 1000, 3) == -1);
+  }
+
+  ss_log_ratelimit_t rl_short = SS_LOG_RATELIMIT_INITIALIZER;
+  UTILS_ASSERT(ss_log_ratelimit(&rl_short, 50, 1) == 0);
+  UTILS_ASSERT(ss_log_ratelimit(&rl_short, 50, 1) == -1);
+  UTILS_ASSERT(ss_log_ratelimit(&rl_short, 50, 1) == -1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  UTILS_ASSERT(ss_log_ratelimit(&rl_short, 50, 1) == 2);
+  UTILS_ASSERT(ss_log_ratelimit(&rl_short, 50, 1) == -1);
+
+  /**
+   * @note The arguments of the dropped messages are not evaluated.
+   */
+  g_nb_evaluated = 0;
+  for (int i = 0; i < 10; ++i) {
+    ss_log_error_ratelimited(60 * 1000, 2, "Ratelimited: %d\n", evaluated());
+  }
+  UTILS_ASSERT(g_nb_evaluated ==
+               (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_ERROR ? 2 : 0));
+}
+
+inline void test_once() {
+  int flag = 0;
+  UTILS_ASSERT(ss_log_once(&flag) == 1);
+  UTILS_ASSERT(ss_log_once(&flag) == 0);
+
+  g_nb_evaluated = 0;
+  for (int i = 0; i < 10; ++i) {
+    ss_log_warn_once("Once: %d\n", evaluated());
+  }
+  UTILS_ASSERT(g_nb_evaluated ==
+               (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_WARN ? 1 : 0));
+}
+
+inline void test_dedup() {
+  ss_log_config_t cfg {};
+  cfg.out.shared = SsThreadProcess::kSsThreadProcessShared;
+  cfg.out.dedup = 1;
+  cfg.err = cfg.out;
+  ss_log_configure(&cfg);
+
+  ss_log_kv_t kv = {"key", "value"};
+  for (int i = 0; i < 8; ++i) {
+    ss_log_info("Duplicated\n");
+  }
+  for (int i = 0; i < 8; ++i) {
+    ss_log_kv_warn("Duplicated record", 1, &kv);
+  }
+  ss_log_info("Not duplicated\n");
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  cfg.out.dedup = 0;
+  cfg.err = cfg.out;
+  ss_log_configure(&cfg);
+}
+
+inline int main_impl() {
+  test_ratelimit();
+  test_once();
+  test_dedup();
+
+  ss_log_infosp("Test passed\n");
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
@@ -0,0 +1,56 @@
+#include <csignal>
+#include <thread>
+
+#include "inner/utils.h"
+
+namespace {
+inline volatile std::sig_atomic_t g_nb_handled = 0;
+
+inline void signal_handler(int) {
+  ss_log_crash_flush();
+  g_nb_handled = g_nb_handled + 1;
+}
+
+inline int main_impl() {
+  /**
+   * @note Nothing to flush yet.
+   */
+  ss_log_crash_flush();
+
+  for (int i = 0; i < 32; ++i) {
+    ss_log_error("Before crash: %d\n", i);
+  }
+
+#if defined(_WIN32) || defined(_WIN64)
+  ss_log_crash_flush();
+  g_nb_handled = 1;
+#else
+  struct sigaction sa {};
+  sa.sa_handler = signal_handler;
+  sigemptyset(&sa.sa_mask);
+  UTILS_ASSERT(sigaction(SIGUSR1, &sa, nullptr) == 0);
+  UTILS_ASSERT(raise(SIGUSR1) == 0);
+#endif
+  UTILS_ASSERT(g_nb_handled == 1);
+
+  ss_log_infosp("After crash flush\n");
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  ss_log_infosp("Test passed\n");
+
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
@@ -0,0 +1,42 @@
+#include <thread>
+
+#include "inner/utils.h"
+
+namespace {
+inline int main_impl() {
+  UTILS_ASSERT(ss_log_init_async() == 0);
+  /**
+   * @note Repeated calls are harmless.
+   */
+  UTILS_ASSERT(ss_log_init_async() == 0);
+
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < 64; ++i) {
+    ss_log_info("Early message: %d\n", i);
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - begin);
+  ss_log_infosp("Early messages took %lld ms\n",
+                static_cast<long long>(elapsed.count()));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  ss_log_info("Late message\n");
+  ss_log_infosp("Test passed\n");
+
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
@@ -0,0 +1,72 @@
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "inner/utils.h"
+
+#ifndef _GEN_FILE_NAME
+#  define _GEN_FILE_NAME "./_gen_log.bin"
+#endif
+
+namespace {
+inline constexpr const char *kGenFileName = _GEN_FILE_NAME;
+
+/**
+ * @note "SLCK", the magic of a chunk of the binary archive.
+ */
+inline constexpr char kChunkMagic[4] = {'S', 'L', 'C', 'K'};
+
+inline int main_impl() {
+  std::filesystem::remove(kGenFileName);
+
+  ss_log_config_t cfg {};
+  cfg.out.flags = kSS_O_RDWR | kSS_O_CREAT | kSS_O_APPEND;
+  cfg.out.mode = SS_FS_PERM_RW;
+  cfg.out.shared = SsThreadProcess::kSsThreadProcessShared;
+  cfg.out.encoder = SsLogEncoder::kSsLogEncoderBinary;
+  cfg.out.log_path = kGenFileName;
+  cfg.err = cfg.out;
+  ss_log_configure(&cfg);
+
+  for (int i = 0; i < 256; ++i) {
+    ss_log_info("Archived message: %d\n", i);
+    ss_log_warn("Archived warning: %d\n", i);
+    std::string value = std::to_string(i);
+    ss_log_kv_t kvs[] = {{"index", value.c_str()}, {"kind", "record"}};
+    ss_log_kv_info("Archived record", 2, kvs);
+  }
+
+  /**
+   * @note Back to `stdout` / `stderr`, which writes the pending chunks out.
+   */
+  cfg.out.log_path = nullptr;
+  cfg.out.encoder = SsLogEncoder::kSsLogEncoderHuman;
+  cfg.err = cfg.out;
+  ss_log_configure(&cfg);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  std::ifstream ifs(kGenFileName, std::ios::binary);
+  UTILS_ASSERT(ifs.is_open());
+  char magic[sizeof(kChunkMagic)] {};
+  ifs.read(magic, sizeof(magic));
+  UTILS_ASSERT(ifs.gcount() == sizeof(magic));
+  UTILS_ASSERT(std::memcmp(magic, kChunkMagic, sizeof(magic)) == 0);
+
+  ss_log_infosp("Test passed\n");
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
@@ -0,0 +1,90 @@
+#include <thread>
+
+#include "inner/utils.h"
+
+namespace {
+inline int g_nb_evaluated = 0;
+
+inline int evaluated() {
+  return ++g_nb_evaluated;
+}
+
+inline void test_every() {
+  g_nb_evaluated = 0;
+  for (int i = 0; i < 100; ++i) {
+    ss_log_info_every(10, "Every 10: %d\n", evaluated());
+  }
+  UTILS_ASSERT(g_nb_evaluated == 10);
+
+  ss_log_sample_t sample = SS_LOG_SAMPLE_INITIALIZER;
+  UTILS_ASSERT(ss_log_sample_every(&sample, 3) == 1);
+  UTILS_ASSERT(ss_log_sample_every(&sample, 3) == 0);
+  UTILS_ASSERT(ss_log_sample_every(&sample, 3) == 0);
+  UTILS_ASSERT(ss_log_sample_every(&sample, 3) == 1);
+}
+
+inline void test_chance() {
+  UTILS_ASSERT(ss_log_sample_chance(0.0) == 0);
+  UTILS_ASSERT(ss_log_sample_chance(1.0) == 1);
+
+  constexpr int kNbCalls = 10000;
+  int hits = 0;
+  for (int i = 0; i < kNbCalls; ++i) {
+    hits += ss_log_sample_chance(0.5);
+  }
+  UTILS_ASSERT(hits > kNbCalls * 4 / 10 && hits < kNbCalls * 6 / 10);
+}
+
+inline void test_flight_recorder() {
+  UTILS_ASSERT(ss_log_flight_recorder(1 << 20) == EINVAL);
+  UTILS_ASSERT(ss_log_flight_recorder(8) == 0);
+
+  /**
+   * @note Only the last 8 debug messages are written, right before the error.
+   */
+  for (int i = 0; i < 32; ++i) {
+    ss_log_debug("Flight recorded: %d\n", i);
+  }
+  std::jthread([]() {
+    ss_log_debug("Recorded by another thread, never written\n");
+  }).join();
+
+  // --- The debug variants are recorded below the debug level as well ---
+  const char *module = _SIRIUS_LOG_MODULE_NAME;
+  const int level = ss_log_get_level(module);
+  UTILS_ASSERT(ss_log_set_level(module, SS_LOG_LEVEL_INFO) == 0);
+  int nb_evaluated = 0;
+  ss_log_debug_once("Flight recorded once: %d\n", ++nb_evaluated);
+  ss_log_debug_every(1, "Flight recorded every: %d\n", ++nb_evaluated);
+  UTILS_ASSERT(nb_evaluated ==
+               (_SIRIUS_LOG_LEVEL >= SS_LOG_LEVEL_DEBUG ? 2 : 0));
+  UTILS_ASSERT(ss_log_set_level(module, level) == 0);
+
+  ss_log_error("Error with the flight record\n");
+
+  UTILS_ASSERT(ss_log_flight_recorder(0) == 0);
+}
+
+inline int main_impl() {
+  test_every();
+  test_chance();
+  test_flight_recorder();
+
+  ss_log_infosp("Test passed\n");
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
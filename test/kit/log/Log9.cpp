@@ -0,0 +1,92 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "inner/utils.h"
+
+#ifndef _GEN_FILE_NAME
+#  define _GEN_FILE_NAME "./_gen_log.txt"
+#endif
+
+namespace {
+inline constexpr const char *kGenFileName = _GEN_FILE_NAME;
+inline constexpr size_t kNbThreads = 4;
+inline constexpr size_t kNbMessages = 16;
+
+/**
+ * @note Far longer than a slot, so each message spans many of them.
+ */
+inline constexpr size_t kPayloadSize = 12000;
+
+inline std::string payload(size_t index) {
+  return std::string(kPayloadSize, static_cast<char>('a' + index)) + "|END";
+}
+
+inline size_t count_of(const std::string &text, const std::string &pattern) {
+  size_t count = 0;
+  for (size_t pos = text.find(pattern); pos != std::string::npos;
+       pos = text.find(pattern, pos + pattern.size())) {
+    ++count;
+  }
+  return count;
+}
+
+inline int main_impl() {
+  std::filesystem::remove(kGenFileName);
+
+  ss_log_config_t cfg {};
+  cfg.out.flags = kSS_O_RDWR | kSS_O_CREAT | kSS_O_APPEND;
+  cfg.out.mode = SS_FS_PERM_RW;
+  cfg.out.shared = SsThreadProcess::kSsThreadProcessShared;
+  cfg.out.log_path = kGenFileName;
+  cfg.err = cfg.out;
+  ss_log_configure(&cfg);
+
+  {
+    std::jthread threads[kNbThreads];
+    for (size_t t = 0; t < kNbThreads; ++t) {
+      threads[t] = std::jthread([t]() {
+        const std::string large = payload(t);
+        for (size_t i = 0; i < kNbMessages; ++i) {
+          ss_log_info("%s\n", large.c_str());
+          ss_log_info("Small message: %zu\n", i);
+        }
+      });
+    }
+  }
+
+  cfg.out.log_path = nullptr;
+  cfg.err = cfg.out;
+  ss_log_configure(&cfg);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  std::ifstream ifs(kGenFileName, std::ios::binary);
+  UTILS_ASSERT(ifs.is_open());
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  const std::string text = ss.str();
+
+  for (size_t t = 0; t < kNbThreads; ++t) {
+    UTILS_ASSERT(count_of(text, payload(t)) == kNbMessages);
+  }
+  UTILS_ASSERT(count_of(text, "Small message: ") == kNbThreads * kNbMessages);
+
+  ss_log_infosp("Test passed\n");
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
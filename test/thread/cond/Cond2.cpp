@@ -0,0 +1,124 @@
+#include <sirius/thread/cond.h>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#  include <sys/mman.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+#include "inner/utils.h"
+
+/**
+ * @note Robust mutexes are missing on Windows, macOS and Android.
+ */
+#if (defined(__linux__) && !defined(__ANDROID__)) || defined(__FreeBSD__)
+#  define ROBUST 1
+#else
+#  define ROBUST 0
+#endif
+
+/**
+ * @brief A mutex and a condition variable shared between processes.
+ */
+
+namespace {
+#if ROBUST
+inline constexpr int kNbRounds = 2000;
+
+struct SharedContext {
+  ss_mutex_t mutex;
+  ss_cond_t cond;
+  int turn;
+  int counter;
+};
+
+/**
+ * @brief Each process waits for its turn, then hands it over to the other.
+ */
+inline int ping_pong(SharedContext *ctx, int self) {
+  for (int i = 0; i < kNbRounds; ++i) {
+    if (ss_mutex_lock(&ctx->mutex))
+      return -1;
+    while (ctx->turn != self) {
+      if (ss_cond_wait(&ctx->cond, &ctx->mutex))
+        return -1;
+    }
+    ++ctx->counter;
+    ctx->turn = !self;
+    if (ss_cond_signal(&ctx->cond) || ss_mutex_unlock(&ctx->mutex))
+      return -1;
+  }
+  return 0;
+}
+
+inline int wait_child(pid_t pid) {
+  int status = 0;
+  UTILS_ASSERT(waitpid(pid, &status, 0) == pid);
+  UTILS_ASSERT(WIFEXITED(status));
+  return WEXITSTATUS(status);
+}
+
+inline int main_impl() {
+  void *memory = mmap(nullptr, sizeof(SharedContext), PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  UTILS_ASSERT(memory != MAP_FAILED);
+  auto ctx = new (memory) SharedContext {};
+
+  enum SsMutexType mutex_type = kSsMutexTypeShared;
+  enum SsThreadProcess cond_type = kSsThreadProcessShared;
+  UTILS_ASSERT(ss_mutex_init(&ctx->mutex, &mutex_type) == 0);
+  UTILS_ASSERT(ss_cond_init(&ctx->cond, &cond_type) == 0);
+
+  // --- Ping-pong ---
+  pid_t pid = fork();
+  UTILS_ASSERT(pid >= 0);
+  if (pid == 0) {
+    _exit(ping_pong(ctx, 1) ? 1 : 0);
+  }
+  UTILS_ASSERT(ping_pong(ctx, 0) == 0);
+  UTILS_ASSERT(wait_child(pid) == 0);
+  UTILS_ASSERT(ctx->counter == 2 * kNbRounds);
+
+  // --- Owner death ---
+  pid = fork();
+  UTILS_ASSERT(pid >= 0);
+  if (pid == 0) {
+    _exit(ss_mutex_lock(&ctx->mutex) ? 1 : 0);
+  }
+  UTILS_ASSERT(wait_child(pid) == 0);
+
+  UTILS_ASSERT(ss_mutex_lock(&ctx->mutex) == EOWNERDEAD);
+  UTILS_ASSERT(ss_mutex_unlock(&ctx->mutex) == 0);
+  UTILS_ASSERT(ss_mutex_trylock(&ctx->mutex) == 0);
+  UTILS_ASSERT(ss_mutex_unlock(&ctx->mutex) == 0);
+
+  UTILS_ASSERT(ss_cond_destroy(&ctx->cond) == 0);
+  UTILS_ASSERT(ss_mutex_destroy(&ctx->mutex) == 0);
+  UTILS_ASSERT(munmap(memory, sizeof(SharedContext)) == 0);
+
+  return 0;
+}
+#else
+inline int main_impl() {
+  ss_mutex_t mutex;
+  enum SsMutexType mutex_type = kSsMutexTypeShared;
+  UTILS_ASSERT(ss_mutex_init(&mutex, &mutex_type) == ENOTSUP);
+
+  return 0;
+}
+#endif
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
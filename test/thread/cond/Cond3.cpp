@@ -0,0 +1,120 @@
+#include <sirius/thread/cond.h>
+#include <sirius/thread/sem.h>
+
+#include <chrono>
+#include <thread>
+
+#include "inner/utils.h"
+
+/**
+ * @brief Timed waits of the condition variable and the semaphore.
+ *
+ * @note `std::chrono::steady_clock` reads the clock of
+ * `ss_get_clock_monotonic_ns`.
+ */
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+inline constexpr uint64_t kTimeoutMs = 50;
+
+inline uint64_t now_ns() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+           Clock::now().time_since_epoch())
+    .count();
+}
+
+inline uint64_t elapsed_ms(Clock::time_point start) {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+           Clock::now() - start)
+    .count();
+}
+
+inline void test_cond() {
+  ss_mutex_t mutex;
+  ss_cond_t cond;
+  UTILS_ASSERT(ss_mutex_init(&mutex, nullptr) == 0);
+  UTILS_ASSERT(ss_cond_init(&cond, nullptr) == 0);
+
+  UTILS_ASSERT(ss_mutex_lock(&mutex) == 0);
+
+  // --- Timeout ---
+  auto start = Clock::now();
+  UTILS_ASSERT(ss_cond_timedwait(&cond, &mutex, kTimeoutMs) == ETIMEDOUT);
+  UTILS_ASSERT(elapsed_ms(start) >= kTimeoutMs);
+
+  start = Clock::now();
+  uint64_t deadline_ns = now_ns() + kTimeoutMs * 1000000ULL;
+  int ret = 0;
+  while (ret == 0) {
+    ret = ss_cond_wait_until(&cond, &mutex, deadline_ns);
+  }
+  UTILS_ASSERT(ret == ETIMEDOUT);
+  UTILS_ASSERT(now_ns() >= deadline_ns);
+  UTILS_ASSERT(elapsed_ms(start) >= kTimeoutMs);
+
+  UTILS_ASSERT(ss_cond_wait_until(&cond, &mutex, 0) == ETIMEDOUT);
+
+  // --- Wakeup before the deadline ---
+  bool ready = false;
+  std::jthread signaler([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(kTimeoutMs / 5));
+    UTILS_ASSERT(ss_mutex_lock(&mutex) == 0);
+    ready = true;
+    UTILS_ASSERT(ss_cond_signal(&cond) == 0);
+    UTILS_ASSERT(ss_mutex_unlock(&mutex) == 0);
+  });
+  deadline_ns = now_ns() + 100 * kTimeoutMs * 1000000ULL;
+  ret = 0;
+  while (ret == 0 && !ready) {
+    ret = ss_cond_wait_until(&cond, &mutex, deadline_ns);
+  }
+  UTILS_ASSERT(ret == 0 && ready);
+
+  UTILS_ASSERT(ss_mutex_unlock(&mutex) == 0);
+  signaler.join();
+
+  UTILS_ASSERT(ss_cond_destroy(&cond) == 0);
+  UTILS_ASSERT(ss_mutex_destroy(&mutex) == 0);
+}
+
+inline void test_sem() {
+  ss_sem_t sem;
+  UTILS_ASSERT(ss_sem_init(&sem, 0, 0) == 0);
+
+  auto start = Clock::now();
+  UTILS_ASSERT(ss_sem_timedwait(&sem, kTimeoutMs) == ETIMEDOUT);
+  UTILS_ASSERT(elapsed_ms(start) >= kTimeoutMs);
+
+  uint64_t deadline_ns = now_ns() + kTimeoutMs * 1000000ULL;
+  UTILS_ASSERT(ss_sem_wait_until(&sem, deadline_ns) == ETIMEDOUT);
+  UTILS_ASSERT(now_ns() >= deadline_ns);
+
+  UTILS_ASSERT(ss_sem_post(&sem) == 0);
+  UTILS_ASSERT(ss_sem_wait_until(&sem, now_ns() + kTimeoutMs * 1000000ULL) ==
+               0);
+
+  UTILS_ASSERT(ss_sem_destroy(&sem) == 0);
+}
+
+inline int main_impl() {
+  test_cond();
+  test_sem();
+
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
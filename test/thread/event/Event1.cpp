@@ -0,0 +1,108 @@
+#include <sirius/thread/event.h>
+
+#include <thread>
+#include <vector>
+
+#include "inner/utils.h"
+
+/**
+ * @brief Consumers block on an event count over a lock-free counter of
+ * items, the producers never take a lock.
+ */
+
+namespace {
+inline constexpr size_t kNbProducers = 4;
+inline constexpr size_t kNbConsumers = 4;
+inline constexpr int64_t kItemsPerProducer = 50000;
+inline constexpr int64_t kNbItems = kNbProducers * kItemsPerProducer;
+
+inline ss_event_t g_event = SS_EVENT_INITIALIZER;
+inline std::atomic<int64_t> g_items = 0;
+inline std::atomic<int64_t> g_consumed = 0;
+inline std::atomic<bool> g_done = false;
+
+inline bool try_take() {
+  int64_t items = g_items.load(std::memory_order_relaxed);
+  while (items > 0) {
+    if (g_items.compare_exchange_weak(items, items - 1,
+                                      std::memory_order_acquire))
+      return true;
+  }
+  return false;
+}
+
+inline void producer() {
+  for (int64_t i = 0; i < kItemsPerProducer; ++i) {
+    g_items.fetch_add(1, std::memory_order_release);
+    ss_event_notify(&g_event);
+  }
+}
+
+inline void consumer() {
+  for (;;) {
+    if (try_take()) {
+      g_consumed.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    if (g_done.load(std::memory_order_acquire))
+      return;
+
+    uint32_t key = ss_event_prepare_wait(&g_event);
+    if (g_items.load() > 0 || g_done.load()) {
+      ss_event_cancel_wait(&g_event);
+      continue;
+    }
+    ss_event_commit_wait(&g_event, key);
+  }
+}
+
+inline int main_impl() {
+  // --- Notification before the commit ---
+  ss_event_t event;
+  UTILS_ASSERT(ss_event_init(&event) == 0);
+  uint32_t key = ss_event_prepare_wait(&event);
+  ss_event_notify(&event);
+  ss_event_commit_wait(&event, key);
+
+  // --- Notification without a consumer ---
+  ss_event_notify_all(&event);
+  key = ss_event_prepare_wait(&event);
+  ss_event_cancel_wait(&event);
+  UTILS_ASSERT(ss_event_prepare_wait(&event) == key);
+  ss_event_cancel_wait(&event);
+
+  // --- Producers and consumers ---
+  {
+    std::vector<std::jthread> consumers;
+    for (size_t i = 0; i < kNbConsumers; ++i) {
+      consumers.emplace_back(consumer);
+    }
+    {
+      std::vector<std::jthread> producers;
+      for (size_t i = 0; i < kNbProducers; ++i) {
+        producers.emplace_back(producer);
+      }
+    }
+    g_done.store(true, std::memory_order_release);
+    ss_event_notify_all(&g_event);
+  }
+  UTILS_ASSERT(g_consumed.load() == kNbItems);
+  UTILS_ASSERT(g_items.load() == 0);
+
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
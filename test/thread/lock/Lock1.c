@@ -4,7 +4,11 @@
 #include "inner/utils.h"
 
 /**
- * @brief LOCK_TYPE: 0 - spinlock; 1 - mutex
+ * @brief LOCK_TYPE: 0 - spinlock; 1 - mutex; 2 - adaptive mutex; 3 - lite
+ * mutex
+ *
+ * @note The contention test prints the throughput of each type, to compare the
+ * spinlock, the `pthread` mutex and the futex mutexes.
  */
 #ifndef LOCK_TYPE
 #  define LOCK_TYPE 0
@@ -24,7 +28,7 @@
 #  define lock_unlock(lock) ss_spin_unlock(&(lock))
 #  define lock_destroy(lock) ss_spin_destroy(&(lock))
 
-#else
+#elif LOCK_TYPE == 1
 
 #  include <sirius/thread/mutex.h>
 
@@ -38,6 +42,36 @@
 #  define lock_unlock(lock) ss_mutex_unlock(&(lock))
 #  define lock_destroy(lock) ss_mutex_destroy(&(lock))
 
+#elif LOCK_TYPE == 2
+
+#  include <sirius/thread/mutex.h>
+
+static const enum SsMutexType g_mutex_type = kSsMutexTypeAdaptive;
+
+#  define lock_t ss_mutex_t
+#  define str_lock_init "ss_mutex_init"
+#  define str_lock_lock "ss_mutex_lock"
+#  define str_lock_unlock "ss_mutex_unlock"
+#  define str_lock_destroy "ss_mutex_destroy"
+#  define lock_init(lock) ss_mutex_init(&(lock), &g_mutex_type)
+#  define lock_lock(lock) ss_mutex_lock(&(lock))
+#  define lock_unlock(lock) ss_mutex_unlock(&(lock))
+#  define lock_destroy(lock) ss_mutex_destroy(&(lock))
+
+#else
+
+#  include <sirius/thread/mutex.h>
+
+#  define lock_t ss_mutex_lite_t
+#  define str_lock_init "ss_mutex_lite_init"
+#  define str_lock_lock "ss_mutex_lite_lock"
+#  define str_lock_unlock "ss_mutex_lite_unlock"
+#  define str_lock_destroy "ss_mutex_lite_init"
+#  define lock_init(lock) ss_mutex_lite_init(&(lock))
+#  define lock_lock(lock) ss_mutex_lite_lock(&(lock))
+#  define lock_unlock(lock) ss_mutex_lite_unlock(&(lock))
+#  define lock_destroy(lock) ss_mutex_lite_init(&(lock))
+
 #endif
 
 /**
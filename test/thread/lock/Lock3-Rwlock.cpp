@@ -0,0 +1,122 @@
+#include <sirius/thread/rwlock.h>
+#include <sirius/thread/seqlock.h>
+
+#include <thread>
+#include <vector>
+
+#include "inner/utils.h"
+
+namespace {
+inline constexpr size_t kNbReaders = 6;
+inline constexpr size_t kNbWriters = 2;
+inline constexpr size_t kNbWrites = 20000;
+
+inline ss_rwlock_t g_rwlock;
+inline uint64_t g_a = 0, g_b = 0;
+
+inline ss_seqlock_t g_seqlock = SS_SEQLOCK_INITIALIZER;
+inline std::atomic<uint64_t> g_x = 0, g_y = 0;
+
+inline std::atomic<bool> g_stop = false;
+
+inline void reader() {
+  while (!g_stop.load(std::memory_order_relaxed)) {
+    UTILS_ASSERT(ss_rwlock_rdlock(&g_rwlock) == 0);
+    UTILS_ASSERT(g_a == g_b);
+    UTILS_ASSERT(ss_rwlock_rdunlock(&g_rwlock) == 0);
+
+    uint32_t seq;
+    uint64_t x, y;
+    do {
+      seq = ss_seqlock_read_begin(&g_seqlock);
+      x = g_x.load(std::memory_order_relaxed);
+      y = g_y.load(std::memory_order_relaxed);
+    } while (ss_seqlock_read_retry(&g_seqlock, seq));
+    UTILS_ASSERT(x == y);
+  }
+}
+
+inline void writer() {
+  for (size_t i = 0; i < kNbWrites; ++i) {
+    if (i % 2) {
+      UTILS_ASSERT(ss_rwlock_wrlock(&g_rwlock) == 0);
+    } else {
+      while (ss_rwlock_trywrlock(&g_rwlock) == EBUSY) {
+        std::this_thread::yield();
+      }
+    }
+    ++g_a;
+    ++g_b;
+    UTILS_ASSERT(ss_rwlock_wrunlock(&g_rwlock) == 0);
+
+    UTILS_ASSERT(ss_seqlock_write_lock(&g_seqlock) == 0);
+    g_x.fetch_add(1, std::memory_order_relaxed);
+    g_y.fetch_add(1, std::memory_order_relaxed);
+    UTILS_ASSERT(ss_seqlock_write_unlock(&g_seqlock) == 0);
+  }
+}
+
+inline void test_rwlock(enum SsRwlockType type) {
+  UTILS_ASSERT(ss_rwlock_init(&g_rwlock, &type) == 0);
+  g_a = g_b = 0;
+  g_stop.store(false);
+
+  {
+    std::vector<std::jthread> readers;
+    for (size_t i = 0; i < kNbReaders; ++i) {
+      readers.emplace_back(reader);
+    }
+    {
+      std::vector<std::jthread> writers;
+      for (size_t i = 0; i < kNbWriters; ++i) {
+        writers.emplace_back(writer);
+      }
+    }
+    g_stop.store(true);
+  }
+  UTILS_ASSERT(g_a == kNbWriters * kNbWrites);
+
+  // --- Exclusion ---
+  UTILS_ASSERT(ss_rwlock_rdlock(&g_rwlock) == 0);
+  UTILS_ASSERT(ss_rwlock_tryrdlock(&g_rwlock) == 0);
+  UTILS_ASSERT(ss_rwlock_trywrlock(&g_rwlock) == EBUSY);
+  UTILS_ASSERT(ss_rwlock_rdunlock(&g_rwlock) == 0);
+  UTILS_ASSERT(ss_rwlock_destroy(&g_rwlock) == EBUSY);
+  UTILS_ASSERT(ss_rwlock_rdunlock(&g_rwlock) == 0);
+
+  UTILS_ASSERT(ss_rwlock_trywrlock(&g_rwlock) == 0);
+  UTILS_ASSERT(ss_rwlock_tryrdlock(&g_rwlock) == EBUSY);
+  UTILS_ASSERT(ss_rwlock_trywrlock(&g_rwlock) == EBUSY);
+  UTILS_ASSERT(ss_rwlock_wrunlock(&g_rwlock) == 0);
+
+  UTILS_ASSERT(ss_rwlock_destroy(&g_rwlock) == 0);
+}
+
+inline int main_impl() {
+  test_rwlock(kSsRwlockTypeNormal);
+  test_rwlock(kSsRwlockTypeDistributed);
+  UTILS_ASSERT(g_x.load() == 2 * kNbWriters * kNbWrites);
+
+  // --- Static initialization ---
+  ss_rwlock_t rwlock = SS_RWLOCK_INITIALIZER;
+  UTILS_ASSERT(ss_rwlock_wrlock(&rwlock) == 0);
+  UTILS_ASSERT(ss_rwlock_wrunlock(&rwlock) == 0);
+  UTILS_ASSERT(ss_rwlock_destroy(&rwlock) == 0);
+
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
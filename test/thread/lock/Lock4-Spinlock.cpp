@@ -0,0 +1,125 @@
+#include <sirius/thread/spinlock.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "inner/utils.h"
+
+/**
+ * @brief Contention benchmark of the spinlocks, from 2 to 64 threads.
+ *
+ * @note The threads beyond the hardware threads are skipped: a spinlock
+ * holder which is preempted would measure the scheduler, not the lock.
+ */
+
+namespace {
+inline constexpr size_t kMaxThreads = 64;
+inline constexpr uint64_t kNbOperations = 200000;
+
+struct Ttas {
+  ss_spinlock_t lock;
+
+  Ttas() {
+    (void)ss_spin_init(&lock, kSsThreadProcessPrivate);
+  }
+  ~Ttas() {
+    (void)ss_spin_destroy(&lock);
+  }
+
+  void run(uint64_t &counter, uint64_t nb) {
+    for (uint64_t i = 0; i < nb; ++i) {
+      (void)ss_spin_lock(&lock);
+      ++counter;
+      (void)ss_spin_unlock(&lock);
+    }
+  }
+};
+
+struct Ticket {
+  ss_spinlock_ticket_t lock;
+
+  Ticket() {
+    (void)ss_spin_ticket_init(&lock, kSsThreadProcessPrivate);
+  }
+  ~Ticket() {
+    (void)ss_spin_ticket_destroy(&lock);
+  }
+
+  void run(uint64_t &counter, uint64_t nb) {
+    for (uint64_t i = 0; i < nb; ++i) {
+      (void)ss_spin_ticket_lock(&lock);
+      ++counter;
+      (void)ss_spin_ticket_unlock(&lock);
+    }
+  }
+};
+
+struct Mcs {
+  ss_spinlock_mcs_t lock;
+
+  Mcs() {
+    (void)ss_spin_mcs_init(&lock, kSsThreadProcessPrivate);
+  }
+  ~Mcs() {
+    (void)ss_spin_mcs_destroy(&lock);
+  }
+
+  void run(uint64_t &counter, uint64_t nb) {
+    for (uint64_t i = 0; i < nb; ++i) {
+      ss_spin_mcs_node_t node;
+      (void)ss_spin_mcs_lock(&lock, &node);
+      ++counter;
+      (void)ss_spin_mcs_unlock(&lock, &node);
+    }
+  }
+};
+
+template <typename Lock>
+inline void bench(const char *name, size_t nb_threads) {
+  Lock lock;
+  uint64_t counter = 0;
+  const uint64_t nb_per_thread = kNbOperations / nb_threads;
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    std::vector<std::jthread> threads;
+    for (size_t i = 0; i < nb_threads; ++i) {
+      threads.emplace_back([&]() { lock.run(counter, nb_per_thread); });
+    }
+  }
+  auto elapsed = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start);
+
+  UTILS_ASSERT(counter == nb_per_thread * nb_threads);
+  ss_log_infosp("%-6s %2zu threads: %10.0f ops/s\n", name, nb_threads,
+                (double)counter / std::max(elapsed.count(), 1e-6));
+}
+
+inline int main_impl() {
+  const size_t nb_cpus = std::max(std::thread::hardware_concurrency(), 2U);
+  for (size_t nb_threads = 2;
+       nb_threads <= std::min(kMaxThreads, nb_cpus); nb_threads *= 2) {
+    bench<Ttas>("ttas", nb_threads);
+    bench<Ticket>("ticket", nb_threads);
+    bench<Mcs>("mcs", nb_threads);
+  }
+
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
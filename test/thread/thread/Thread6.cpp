@@ -0,0 +1,113 @@
+#include <sirius/thread/threadpool.h>
+
+#include <thread>
+#include <vector>
+
+#include "inner/utils.h"
+
+namespace {
+inline constexpr size_t kNbWorkers = 4;
+inline constexpr size_t kNbSubmitters = 3;
+inline constexpr size_t kNbTasks = 20000;
+inline constexpr size_t kNbBatch = 1000;
+inline constexpr size_t kNbChildren = 5000;
+
+inline std::atomic<uint64_t> g_sum = 0;
+inline ss_threadpool_t *g_pool = nullptr;
+
+inline void leaf(void *arg) {
+  g_sum.fetch_add(reinterpret_cast<uintptr_t>(arg),
+                  std::memory_order_relaxed);
+}
+
+/**
+ * @note Submitted from a worker, the children go to its own deque, and the
+ * other workers steal them.
+ */
+inline void spawner(void *arg) {
+  (void)arg;
+
+  UTILS_ASSERT(ss_threadpool_wait_idle(g_pool, kSsTimeoutInfinite) ==
+               EDEADLK);
+  for (size_t i = 0; i < kNbChildren; ++i) {
+    UTILS_ASSERT(ss_threadpool_submit(g_pool, leaf, (void *)1) == 0);
+  }
+}
+
+inline void sleeper(void *arg) {
+  (void)arg;
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+}
+
+inline int main_impl() {
+  ss_thread_attr_t attr {};
+  attr.stacksize = 256 * 1024;
+
+  ss_threadpool_args_t args {};
+  args.nb_workers = kNbWorkers;
+  args.deque_capacity = 64;
+  args.thread_attr = &attr;
+  UTILS_ASSERT(ss_threadpool_create(&g_pool, &args) == 0);
+
+  {
+    std::vector<std::jthread> submitters;
+    for (size_t t = 0; t < kNbSubmitters; ++t) {
+      submitters.emplace_back([]() {
+        for (size_t i = 0; i < kNbTasks; ++i) {
+          UTILS_ASSERT(ss_threadpool_submit(g_pool, leaf, (void *)1) == 0);
+        }
+
+        std::vector<ss_threadpool_task_t> batch(kNbBatch, {leaf, (void *)2});
+        UTILS_ASSERT(ss_threadpool_submit_batch(g_pool, batch.data(),
+                                                batch.size()) == 0);
+        UTILS_ASSERT(ss_threadpool_submit(g_pool, spawner, nullptr) == 0);
+      });
+    }
+  }
+  UTILS_ASSERT(ss_threadpool_wait_idle(g_pool, kSsTimeoutInfinite) == 0);
+  UTILS_ASSERT(g_sum.load() ==
+               kNbSubmitters * (kNbTasks + 2 * kNbBatch + kNbChildren));
+
+  // --- Timeout ---
+  UTILS_ASSERT(ss_threadpool_submit(g_pool, sleeper, nullptr) == 0);
+  UTILS_ASSERT(ss_threadpool_wait_idle(g_pool, kSsTimeoutNoWaiting) ==
+               ETIMEDOUT);
+  UTILS_ASSERT(ss_threadpool_wait_idle(g_pool, 10) == ETIMEDOUT);
+  UTILS_ASSERT(ss_threadpool_wait_idle(g_pool, 5000) == 0);
+
+  // --- Invalid ---
+  UTILS_ASSERT(ss_threadpool_submit(g_pool, nullptr, nullptr) == EINVAL);
+  UTILS_ASSERT(ss_threadpool_submit_batch(g_pool, nullptr, 1) == EINVAL);
+  UTILS_ASSERT(ss_threadpool_submit_batch(g_pool, nullptr, 0) == 0);
+
+  // --- Destroy with tasks in flight ---
+  g_sum = 0;
+  for (size_t i = 0; i < kNbTasks; ++i) {
+    UTILS_ASSERT(ss_threadpool_submit(g_pool, leaf, (void *)1) == 0);
+  }
+  UTILS_ASSERT(ss_threadpool_destroy(g_pool) == 0);
+  UTILS_ASSERT(g_sum.load() == kNbTasks);
+
+  // --- Defaults ---
+  UTILS_ASSERT(ss_threadpool_create(&g_pool, nullptr) == 0);
+  UTILS_ASSERT(ss_threadpool_submit(g_pool, leaf, (void *)1) == 0);
+  UTILS_ASSERT(ss_threadpool_destroy(g_pool) == 0);
+
+  ss_log_infosp("Test passed\n");
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
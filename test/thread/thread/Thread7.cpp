@@ -0,0 +1,103 @@
+#include <sirius/thread/thread.h>
+
+#include <memory>
+
+#include "inner/utils.h"
+
+namespace {
+inline void *affinity_get(void *arg) {
+  auto set = static_cast<ss_cpu_set_t *>(arg);
+  UTILS_ASSERT(ss_thread_getaffinity(ss_thread_self(), set) == 0);
+  return nullptr;
+}
+
+inline size_t cpu_first(const ss_cpu_set_t &set) {
+  for (size_t cpu = 0; cpu < SS_CPU_SETSIZE; ++cpu) {
+    if (ss_cpu_set_has(&set, cpu))
+      return cpu;
+  }
+  return SS_CPU_SETSIZE;
+}
+
+inline int main_impl() {
+  auto topology = std::make_unique<ss_cpu_topology_t>();
+  UTILS_ASSERT(ss_cpu_topology(topology.get()) == 0);
+  UTILS_ASSERT(topology->nb_cpus > 0);
+  UTILS_ASSERT(topology->nb_cpus == ss_cpu_set_count(&topology->online));
+  UTILS_ASSERT(topology->nb_cores > 0 &&
+               topology->nb_cores <= topology->nb_cpus);
+
+  ss_log_infosp("CPUs: %zu; Cores: %zu; Packages: %zu; L3: %zu; NUMA: %zu\n",
+                topology->nb_cpus, topology->nb_cores,
+                topology->nb_packages, topology->nb_l3,
+                topology->nb_numa_nodes);
+  for (size_t cpu = 0; cpu < SS_CPU_SETSIZE; ++cpu) {
+    if (!ss_cpu_set_has(&topology->online, cpu))
+      continue;
+    const auto &info = topology->cpus[cpu];
+    UTILS_ASSERT(info.core >= 0 &&
+                 static_cast<size_t>(info.core) < topology->nb_cores);
+    ss_log_infosp("CPU %zu: core %d; package %d; L3 %d; NUMA %d\n", cpu,
+                  info.core, info.package, info.l3, info.numa_node);
+  }
+
+  ss_cpu_set_t self_cpus;
+  if (int ret = ss_thread_getaffinity(ss_thread_self(), &self_cpus);
+      ret == ENOTSUP) {
+    ss_log_warnsp("CPU affinity is not supported\n");
+    return 0;
+  } else {
+    UTILS_ASSERT(ret == 0);
+  }
+  const size_t cpu = cpu_first(self_cpus);
+  UTILS_ASSERT(cpu < SS_CPU_SETSIZE);
+
+  // --- Attributes ---
+  ss_thread_t thread;
+  ss_thread_attr_t attr {};
+  ss_cpu_set_t cpus;
+  ss_cpu_set_add(&attr.affinity, cpu);
+  UTILS_ASSERT(ss_thread_create(&thread, &attr, affinity_get, &cpus) == 0);
+  UTILS_ASSERT(ss_thread_join(thread, nullptr) == 0);
+  UTILS_ASSERT(ss_cpu_set_count(&cpus) == 1 && ss_cpu_set_has(&cpus, cpu));
+
+  // --- NUMA ---
+  if (int node = topology->cpus[cpu].numa_node; node >= 0) {
+    attr.numa_policy = kSsThreadNumaPreferred;
+    attr.numa_node = node;
+    UTILS_ASSERT(ss_thread_create(&thread, &attr, affinity_get, &cpus) == 0);
+    UTILS_ASSERT(ss_thread_join(thread, nullptr) == 0);
+    UTILS_ASSERT(ss_cpu_set_has(&cpus, cpu));
+
+    attr.numa_node = -1;
+    UTILS_ASSERT(ss_thread_create(&thread, &attr, affinity_get, &cpus) ==
+                 EINVAL);
+  }
+
+  // --- Self ---
+  ss_cpu_set_zero(&cpus);
+  UTILS_ASSERT(ss_thread_setaffinity(ss_thread_self(), &cpus) == EINVAL);
+  ss_cpu_set_add(&cpus, cpu);
+  UTILS_ASSERT(ss_thread_setaffinity(ss_thread_self(), &cpus) == 0);
+  UTILS_ASSERT(ss_thread_getaffinity(ss_thread_self(), &cpus) == 0);
+  UTILS_ASSERT(ss_cpu_set_count(&cpus) == 1);
+  UTILS_ASSERT(ss_thread_setaffinity(ss_thread_self(), &self_cpus) == 0);
+
+  ss_log_infosp("Test passed\n");
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
@@ -0,0 +1,128 @@
+#include <sirius/thread/parallel.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "inner/utils.h"
+
+namespace {
+inline constexpr size_t kNbIndexes = 1000000;
+inline constexpr size_t kNbOuter = 64;
+inline constexpr size_t kNbInner = 1000;
+
+inline void sum_body(size_t begin, size_t end, void *partial, void *ctx) {
+  (void)ctx;
+  for (size_t i = begin; i < end; ++i) {
+    *static_cast<uint64_t *>(partial) += i;
+  }
+}
+
+inline void sum_join(void *dst, void *src, void *ctx) {
+  (void)ctx;
+  *static_cast<uint64_t *>(dst) += *static_cast<uint64_t *>(src);
+}
+
+inline int main_impl() {
+  // --- C ---
+  {
+    std::vector<uint8_t> marks(kNbIndexes, 0);
+    UTILS_ASSERT(ss_parallel_for(
+                   0, marks.size(), 0,
+                   [](size_t begin, size_t end, void *ctx) {
+                     auto p = static_cast<uint8_t *>(ctx);
+                     for (size_t i = begin; i < end; ++i) {
+                       ++p[i];
+                     }
+                   },
+                   marks.data()) == 0);
+    for (auto mark : marks) {
+      UTILS_ASSERT(mark == 1);
+    }
+
+    uint64_t sum = 0;
+    ss_parallel_reduce_args_t args {};
+    args.partial_size = sizeof(sum);
+    args.body = sum_body;
+    args.join = sum_join;
+    UTILS_ASSERT(ss_parallel_reduce(0, kNbIndexes, 0, &sum, &args) == 0);
+    UTILS_ASSERT(sum == uint64_t {kNbIndexes} * (kNbIndexes - 1) / 2);
+  }
+
+  // --- C++ ---
+  {
+    std::vector<int> values(kNbIndexes, 0);
+    UTILS_ASSERT(sirius::parallel_for(0, values.size(), 0,
+                                      [&](size_t i) { values[i] += 1; }) ==
+                 0);
+    for (auto value : values) {
+      UTILS_ASSERT(value == 1);
+    }
+
+    /**
+     * @note Not commutative, the order of the digits checks the joins.
+     */
+    std::string str, expected;
+    UTILS_ASSERT(sirius::parallel_reduce(
+                   0, 2000, 7, str,
+                   [](size_t i, std::string &acc) {
+                     acc += std::to_string(i % 10);
+                   },
+                   [](std::string &left, std::string &right) {
+                     left += right;
+                   }) == 0);
+    for (size_t i = 0; i < 2000; ++i) {
+      expected += std::to_string(i % 10);
+    }
+    UTILS_ASSERT(str == expected);
+  }
+
+  // --- Nested ---
+  {
+    std::atomic<uint64_t> count = 0;
+    UTILS_ASSERT(sirius::parallel_for(0, kNbOuter, 1, [&](size_t) {
+                   UTILS_ASSERT(sirius::parallel_for(
+                                  0, kNbInner, 10, [&](size_t b, size_t e) {
+                                    count.fetch_add(e - b);
+                                  }) == 0);
+                 }) == 0);
+    UTILS_ASSERT(count.load() == kNbOuter * kNbInner);
+  }
+
+  // --- Exception ---
+  {
+    bool thrown = false;
+    try {
+      (void)sirius::parallel_for(0, 1000, 1, [](size_t i) {
+        if (i == 500)
+          throw std::runtime_error("index 500");
+      });
+    } catch (const std::runtime_error &) {
+      thrown = true;
+    }
+    UTILS_ASSERT(thrown);
+  }
+
+  // --- Invalid ---
+  UTILS_ASSERT(ss_parallel_for(0, 1, 0, nullptr, nullptr) == EINVAL);
+  UTILS_ASSERT(ss_parallel_for(
+                 5, 1, 0, [](size_t, size_t, void *) {}, nullptr) == EINVAL);
+  UTILS_ASSERT(ss_parallel_reduce(0, 1, 0, nullptr, nullptr) == EINVAL);
+
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}
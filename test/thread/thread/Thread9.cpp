@@ -0,0 +1,123 @@
+#include <sirius/thread/cond.h>
+#include <sirius/thread/thread.h>
+
+#include <chrono>
+#include <thread>
+
+#include "inner/utils.h"
+
+/**
+ * @brief Statistics of a thread: CPU time, context switches, last CPU and the
+ * accounted waits.
+ */
+
+namespace {
+inline constexpr uint64_t kHoldMs = 30;
+inline constexpr uint64_t kNsPerMs = 1000000;
+
+inline ss_mutex_t g_mutex;
+inline ss_cond_t g_cond;
+inline std::atomic<ss_thread_t> g_thread = nullptr;
+inline std::atomic<int> g_step = 0;
+
+inline void wait_step(int step) {
+  while (g_step.load() != step) {
+    std::this_thread::yield();
+  }
+}
+
+inline void burn_cpu(std::chrono::milliseconds duration) {
+  auto end = std::chrono::steady_clock::now() + duration;
+  volatile uint64_t sink = 0;
+  while (std::chrono::steady_clock::now() < end) {
+    sink = sink + 1;
+  }
+}
+
+/**
+ * @note Started by `ss_thread_create`, which records its `tid`.
+ */
+inline void *worker(void *) {
+  g_thread.store(ss_thread_self());
+
+  burn_cpu(std::chrono::milliseconds(kHoldMs));
+  for (int i = 0; i < 4; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  g_step.store(1);
+
+  // --- Contended lock, the main thread holds it ---
+  wait_step(2);
+  UTILS_ASSERT(ss_mutex_lock(&g_mutex) == 0);
+  UTILS_ASSERT(ss_cond_timedwait(&g_cond, &g_mutex, kHoldMs) == ETIMEDOUT);
+  UTILS_ASSERT(ss_mutex_unlock(&g_mutex) == 0);
+  g_step.store(3);
+
+  /**
+   * @note The waits of a thread are lost when it exits.
+   */
+  wait_step(4);
+  return nullptr;
+}
+
+inline int main_impl() {
+  UTILS_ASSERT(ss_mutex_init(&g_mutex, nullptr) == 0);
+  UTILS_ASSERT(ss_cond_init(&g_cond, nullptr) == 0);
+  ss_thread_stats_t stats;
+
+  ss_thread_t thread;
+  UTILS_ASSERT(ss_thread_create(&thread, nullptr, worker, nullptr) == 0);
+
+  // --- CPU time and context switches ---
+  wait_step(1);
+  ss_thread_t handle = g_thread.load();
+  UTILS_ASSERT(ss_thread_stats(handle, &stats) == 0);
+  UTILS_ASSERT(stats.cpu_time_ns >= kHoldMs * kNsPerMs / 2);
+  UTILS_ASSERT(stats.wait_time_ns == 0 && stats.nb_waits == 0);
+#if defined(__linux__)
+  UTILS_ASSERT(stats.nb_voluntary_switches > 0);
+  UTILS_ASSERT(stats.last_cpu >= 0);
+#endif
+  ss_log_infosp("cpu: %" PRIu64 " ns, switches: %" PRIu64 " / %" PRIu64
+                ", last cpu: %d\n",
+                stats.cpu_time_ns, stats.nb_voluntary_switches,
+                stats.nb_involuntary_switches, stats.last_cpu);
+
+  // --- Wait accounting ---
+  ss_thread_wait_accounting(1);
+  UTILS_ASSERT(ss_mutex_lock(&g_mutex) == 0);
+  g_step.store(2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(kHoldMs));
+  UTILS_ASSERT(ss_mutex_unlock(&g_mutex) == 0);
+
+  wait_step(3);
+  ss_thread_wait_accounting(0);
+  UTILS_ASSERT(ss_thread_stats(handle, &stats) == 0);
+  UTILS_ASSERT(stats.nb_waits >= 1);
+  UTILS_ASSERT(stats.wait_time_ns >= kHoldMs * kNsPerMs);
+  ss_log_infosp("waits: %" PRIu64 ", %" PRIu64 " ns\n", stats.nb_waits,
+                stats.wait_time_ns);
+
+  g_step.store(4);
+  UTILS_ASSERT(ss_thread_join(thread, nullptr) == 0);
+
+  UTILS_ASSERT(ss_cond_destroy(&g_cond) == 0);
+  UTILS_ASSERT(ss_mutex_destroy(&g_mutex) == 0);
+
+  return 0;
+}
+} // namespace
+
+int main() {
+  auto init = utils::Init();
+
+  try {
+    return main_impl();
+  } catch (const std::exception &e) {
+    ss_log_error("%s\n", e.what());
+    return -1;
+  } catch (...) {
+    ss_log_error("`exception`: unknow\n");
+    return -1;
+  }
+}